@@ -39,10 +39,16 @@ public:
 
     // Submits the currently-mapped buffer for GPU rendering, in whatever way that is meaningful for
     // the PLSRenderContext implementation.
-    void unmapAndSubmitBuffer()
+    void unmapAndSubmitBuffer() { unmapAndSubmitBuffer(m_mapSizeInBytes); }
+
+    // Submits the currently-mapped buffer, where only the first 'updateSizeInBytes' of the mapping
+    // were written. Implementations that copy from a CPU-side shadow buffer (WebGL, D3D11) only
+    // transfer this many bytes, instead of the full (high-water-mark) map size.
+    void unmapAndSubmitBuffer(size_t updateSizeInBytes)
     {
         assert(isMapped());
-        onUnmapAndSubmitBuffer(m_submittedBufferIdx, m_mapSizeInBytes);
+        assert(updateSizeInBytes <= m_mapSizeInBytes);
+        onUnmapAndSubmitBuffer(m_submittedBufferIdx, updateSizeInBytes);
         m_mapSizeInBytes = 0;
     }
 
@@ -54,7 +60,7 @@ protected:
     }
 
     virtual void* onMapBuffer(int bufferIdx, size_t mapSizeInBytes) = 0;
-    virtual void onUnmapAndSubmitBuffer(int bufferIdx, size_t mapSizeInBytes) = 0;
+    virtual void onUnmapAndSubmitBuffer(int bufferIdx, size_t updateSizeInBytes) = 0;
 
     uint8_t* shadowBuffer() const
     {
@@ -84,6 +90,6 @@ public:
 
 protected:
     void* onMapBuffer(int bufferIdx, size_t mapSizeInBytes) override { return shadowBuffer(); }
-    void onUnmapAndSubmitBuffer(int bufferIdx, size_t mapSizeInBytes) override {}
+    void onUnmapAndSubmitBuffer(int bufferIdx, size_t updateSizeInBytes) override {}
 };
 } // namespace rive::pls
@@ -8,6 +8,7 @@
 #include "rive/pls/pls_render_context_helper_impl.hpp"
 #include <map>
 #include <string>
+#include <tuple>
 
 namespace rive::pls
 {
@@ -115,6 +116,8 @@ private:
                                      uint32_t mipLevelCount,
                                      const uint8_t imageDataRGBA[]) override;
 
+    rcp<PLSTexture> makeCompressedImageTexture(const CompressedImage&) override;
+
     std::unique_ptr<BufferRing> makeUniformBufferRing(size_t capacityInBytes) override;
     std::unique_ptr<BufferRing> makeStorageBufferRing(size_t capacityInBytes,
                                                       pls::StorageBufferStructure) override;
@@ -131,6 +134,17 @@ private:
                                                          UINT highLevelStructCount,
                                                          UINT firstHighLevelStruct);
 
+    void precompileShaders(const std::vector<pls::ShaderVariant>&) override;
+
+    struct DrawVertexShader;
+
+    // Returns the draw shaders for the given feature set, compiling them first if necessary.
+    std::tuple<const DrawVertexShader*, ID3D11PixelShader*> findOrCompileDrawShaders(
+        DrawType,
+        pls::ShaderFeatures,
+        pls::InterlockMode,
+        pls::ShaderMiscFlags pixelShaderMiscFlags);
+
     void setPipelineLayoutAndShaders(DrawType,
                                      pls::ShaderFeatures,
                                      pls::InterlockMode,
@@ -33,6 +33,10 @@ void CompileAndAttachShader(GLuint program,
 
 void LinkProgram(GLuint program);
 
+// Checks the link status of a program whose glLinkProgram() call has already been issued (e.g., by
+// a KHR_parallel_shader_compile client that didn't want to block). Only checks in DEBUG builds.
+void VerifyProgramLinked(GLuint program);
+
 class Buffer
 {
 public:
@@ -97,6 +97,25 @@ extern void glProvokingVertexANGLE(GLenum provokeMode);
 #endif
 #endif // RIVE_WEBGL
 
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+#ifndef GL_COMPRESSED_RGB8_ETC2
+#define GL_COMPRESSED_RGB8_ETC2 0x9274
+#define GL_COMPRESSED_RGBA8_ETC2_EAC 0x9278
+#endif
+#ifndef GL_COMPRESSED_RGBA_ASTC_4x4_KHR
+#define GL_COMPRESSED_RGBA_ASTC_4x4_KHR 0x93B0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#ifndef GL_COMPRESSED_RGBA_BPTC_UNORM_EXT
+#define GL_COMPRESSED_RGBA_BPTC_UNORM_EXT 0x8E8C
+#endif
+
 #if defined(RIVE_GLES) || defined(RIVE_WEBGL)
 // GLES 3.1 functionality is pulled in as an extension. Define these to avoid compile errors, even
 // if we won't use them.
@@ -124,16 +143,21 @@ struct GLCapabilities
     bool ANGLE_provoking_vertex : 1;
     bool ARM_shader_framebuffer_fetch : 1;
     bool ARB_bindless_texture : 1;
+    bool ARB_ES3_compatibility : 1; // ETC2 textures.
     bool ARB_fragment_shader_interlock : 1;
     bool ARB_shader_image_load_store : 1;
     bool ARB_shader_storage_buffer_object : 1;
     bool KHR_blend_equation_advanced : 1;
     bool KHR_blend_equation_advanced_coherent : 1;
+    bool KHR_parallel_shader_compile : 1;
+    bool KHR_texture_compression_astc_ldr : 1;
     bool EXT_base_instance : 1;
     bool EXT_clip_cull_distance : 1;
     bool INTEL_fragment_shader_ordering : 1;
     bool EXT_shader_framebuffer_fetch : 1;
     bool EXT_shader_pixel_local_storage : 1;
+    bool EXT_texture_compression_bptc : 1;
+    bool EXT_texture_compression_s3tc : 1;
     bool QCOM_shader_framebuffer_fetch_noncoherent : 1;
 };
 
@@ -8,6 +8,7 @@
 #include "rive/pls/gl/gl_utils.hpp"
 #include "rive/pls/pls_render_context_helper_impl.hpp"
 #include <map>
+#include <string>
 
 namespace rive::pls
 {
@@ -23,6 +24,33 @@ public:
     {
         bool disablePixelLocalStorage = false;
         bool disableFragmentShaderInterlock = false;
+
+        // If non-null, linked draw programs are persisted to (and loaded from) this directory via
+        // glGetProgramBinary/glProgramBinary, so warm starts don't have to compile shaders. The
+        // directory must already exist. Ignored on WebGL and on drivers with no binary formats.
+        const char* programBinaryCacheDirectory = nullptr;
+
+        // Wait for shaders to compile inline with rendering (causing jank), instead of drawing
+        // with a fully-featured program while KHR_parallel_shader_compile finishes the specialized
+        // one. (Primarily for testing.)
+        bool synchronousShaderCompilations = false;
+
+        // Upload tessellation spans as 32-byte pls::TessVertexSpanCompact instead of 64-byte
+        // pls::TessVertexSpan. Halves the vertex data for most curves. Control points lose
+        // precision when they are far from the midpoint of their contour, so frames with draws
+        // that fp16 can't encode within the tessellation tolerance still use full spans.
+        bool compactTessVertexSpans = false;
+
+        // Pack small decoded images into shared atlas textures, so draws of different images can
+        // be batched together. Atlased images only have PLSImageAtlasPage::kMipLevelCount mip
+        // levels.
+        bool enableImageAtlas = false;
+
+        // Draw rects, rounded rects, and ellipses as single analytic-coverage quads instead of
+        // tessellating them. Only used in rasterOrdering and atomic modes. Corners that are zoomed
+        // in far enough for the true ellipse to visibly differ from the path's cubics still get
+        // tessellated.
+        bool enableAnalyticShapes = true;
     };
 
     static std::unique_ptr<PLSRenderContext> MakeContext(const ContextOptions&);
@@ -39,9 +67,22 @@ public:
                                      uint32_t mipLevelCount,
                                      const uint8_t imageDataRGBA[]) override;
 
+    rcp<PLSTexture> makeCompressedImageTexture(const CompressedImage&) override;
+
+    rcp<PLSTexture> makeImageAtlasTexture(uint32_t size, uint32_t mipLevelCount) override;
+
+    void updateImageAtlasTexture(PLSTexture*,
+                                 uint32_t mipLevel,
+                                 const IAABB& region,
+                                 const uint8_t regionDataRGBA[]) override;
+
     // Takes ownership of textureID and responsibility for deleting it.
     rcp<PLSTexture> adoptImageTexture(uint32_t width, uint32_t height, GLuint textureID);
 
+    bool makeOffscreenTarget(uint32_t width,
+                             uint32_t height,
+                             PLSRenderContext::OffscreenTarget*) override;
+
     // Called *after* the GL context has been modified externally.
     // Re-binds Rive internal resources and invalidates the internal cache of GL state.
     void invalidateGLState();
@@ -114,9 +155,20 @@ private:
 
     static std::unique_ptr<PLSRenderContext> MakeContext(const char* rendererString,
                                                          GLCapabilities,
-                                                         std::unique_ptr<PLSImpl>);
+                                                         std::unique_ptr<PLSImpl>,
+                                                         const ContextOptions&);
+
+    PLSRenderContextGLImpl(const char* rendererString,
+                           GLCapabilities,
+                           std::unique_ptr<PLSImpl>,
+                           const ContextOptions&);
 
-    PLSRenderContextGLImpl(const char* rendererString, GLCapabilities, std::unique_ptr<PLSImpl>);
+    // On-disk cache of linked draw programs. Both calls are no-ops when the cache is disabled.
+    // loadProgramBinary() returns false if there is no valid binary for the given key, or if the
+    // driver rejected it, in which case the program needs to be compiled and linked normally.
+    bool loadProgramBinary(uint32_t programKey, GLuint programID);
+    void storeProgramBinary(uint32_t programKey, GLuint programID);
+    std::string programBinaryPath(uint32_t programKey) const;
 
     // Wraps a compiled GL shader of draw_path.glsl or draw_image_mesh.glsl, either vertex or
     // fragment, with a specific set of features enabled via #define. The set of features to enable
@@ -145,6 +197,9 @@ private:
     // Wraps a compiled and linked GL program of draw_path.glsl or draw_image_mesh.glsl, with a
     // specific set of features enabled via #define. The set of features to enable is dictated by
     // ShaderFeatures.
+    //
+    // When KHR_parallel_shader_compile is supported, the program compiles and links asynchronously
+    // and can't be used until isReady() returns true.
     class DrawProgram
     {
     public:
@@ -157,22 +212,47 @@ private:
                     pls::ShaderMiscFlags);
         ~DrawProgram();
 
-        GLuint id() const { return m_id; }
+        // Returns true if the program has finished linking and is ready to draw with. If 'wait' is
+        // true, blocks until the driver finishes compiling.
+        bool isReady(PLSRenderContextGLImpl*, bool wait);
+
+        GLuint id() const
+        {
+            assert(!m_linkPending);
+            return m_id;
+        }
         GLint spirvCrossBaseInstanceLocation() const { return m_spirvCrossBaseInstanceLocation; }
 
     private:
-        DrawShader m_fragmentShader;
+        // Sets up uniform bindings once the program is linked. If the program was compiled from
+        // source (as opposed to loaded from the binary cache), also stores its binary.
+        void finishLinking(PLSRenderContextGLImpl*, bool didCompile);
+
+        const pls::DrawType m_drawType;
+        const pls::ShaderFeatures m_shaderFeatures;
+        const pls::InterlockMode m_interlockMode;
+        const uint32_t m_programKey;
         GLuint m_id;
+        bool m_linkPending = false;
         GLint m_spirvCrossBaseInstanceLocation = -1;
         const rcp<GLState> m_state;
     };
 
+    // Returns the program for the given key if it's ready. Otherwise, kicks off its compilation (if
+    // necessary) and returns a ready program with a superset of the requested features.
+    const DrawProgram* findCompatibleDrawProgram(pls::DrawType,
+                                                 pls::ShaderFeatures,
+                                                 pls::InterlockMode,
+                                                 pls::ShaderMiscFlags);
+
     std::unique_ptr<BufferRing> makeUniformBufferRing(size_t capacityInBytes) override;
     std::unique_ptr<BufferRing> makeStorageBufferRing(size_t capacityInBytes,
                                                       pls::StorageBufferStructure) override;
     std::unique_ptr<BufferRing> makeVertexBufferRing(size_t capacityInBytes) override;
     std::unique_ptr<BufferRing> makeTextureTransferBufferRing(size_t capacityInBytes) override;
 
+    void precompileShaders(const std::vector<pls::ShaderVariant>&) override;
+
     void resizeGradientTexture(uint32_t width, uint32_t height) override;
     void resizeTessellationTexture(uint32_t width, uint32_t height) override;
 
@@ -190,6 +270,7 @@ private:
 
     // Tessellation texture rendering.
     glutils::Program m_tessellateProgram;
+    glutils::Program m_tessellateCompactProgram; // Only linked if compactTessVertexSpans.
     glutils::VAO m_tessellateVAO;
     glutils::Buffer m_tessSpanIndexBuffer;
     glutils::FBO m_tessellateFBO;
@@ -198,12 +279,24 @@ private:
     // Not all programs have a unique vertex shader, so we cache and reuse them where possible.
     std::map<uint32_t, DrawShader> m_vertexShaders;
     std::map<uint32_t, DrawProgram> m_drawPrograms;
+    bool m_synchronousShaderCompilations;
+
+    // The program each DrawBatch will use during the current flush. (Resolved before PLS is
+    // activated, since ANGLE_shader_pixel_local_storage doesn't allow compilation while active.)
+    std::vector<const DrawProgram*> m_batchDrawPrograms;
+
+    // Empty if the program binary cache is disabled. The salt identifies the driver, capabilities,
+    // and shader sources that a cached binary was built with; binaries with a different salt are
+    // discarded.
+    std::string m_programBinaryCacheDirectory;
+    uint64_t m_programBinaryCacheSalt = 0;
 
     // Vertex/index buffers for drawing paths.
     glutils::VAO m_drawVAO;
     glutils::Buffer m_patchVerticesBuffer;
     glutils::Buffer m_patchIndicesBuffer;
     glutils::VAO m_trianglesVAO;
+    glutils::VAO m_analyticShapesVAO; // Aliases the triangle buffer as AnalyticShapeVertex.
 
     // Vertex/index buffers for drawing image rects. (Atomic mode only, and only used when bindless
     // textures aren't supported.)
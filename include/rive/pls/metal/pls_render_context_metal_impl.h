@@ -112,6 +112,8 @@ public:
                                      uint32_t mipLevelCount,
                                      const uint8_t imageDataRGBA[]) override;
 
+    rcp<PLSTexture> makeCompressedImageTexture(const CompressedImage&) override;
+
     // Atomic mode requires a barrier between overlapping draws. We have to implement this barrier
     // in various different ways, depending on which hardware we're on.
     enum class AtomicBarrierType
@@ -149,6 +151,9 @@ private:
     void resizeGradientTexture(uint32_t width, uint32_t height) override;
     void resizeTessellationTexture(uint32_t width, uint32_t height) override;
 
+    // Schedules the given pipelines on the background compiler.
+    void precompileShaders(const std::vector<pls::ShaderVariant>&) override;
+
     // Obtains an exclusive lock on the next buffer ring index, potentially blocking until the GPU
     // has finished rendering with it. This ensures it is safe for the CPU to begin modifying the
     // next buffers in our rings.
@@ -7,11 +7,14 @@
 #include "rive/enum_bitset.hpp"
 #include "rive/math/aabb.hpp"
 #include "rive/math/mat2d.hpp"
+#include "rive/math/math_types.hpp"
 #include "rive/math/path_types.hpp"
 #include "rive/math/vec2d.hpp"
 #include "rive/shapes/paint/blend_mode.hpp"
 #include "rive/shapes/paint/color.hpp"
 #include "rive/pls/trivial_block_allocator.hpp"
+#include <string>
+#include <vector>
 
 namespace rive
 {
@@ -44,6 +47,11 @@ constexpr static int kParametricPrecision = 4;
 // Tessellate in polar space until the outset edge is within 1/8 pixel of the true stroke.
 constexpr static int kPolarPrecision = 8;
 
+// The above precisions are for full quality. Frames and paints can lower their tessellation
+// quality at runtime, which scales both precisions down (i.e., allows proportionally more error),
+// but never below this factor.
+constexpr static float kMinTessellationQuality = 1.f / 8;
+
 // Maximum supported numbers of tessellated segments in a single curve.
 constexpr static uint32_t kMaxParametricSegments = 1023;
 constexpr static uint32_t kMaxPolarSegments = 1023;
@@ -109,6 +117,11 @@ struct PlatformFeatures
                                                    // "DrawType::plsAtomicInitialize" draw instead.
     uint8_t pathIDGranularity = 1; // Workaround for precision issues. Determines how far apart we
                                    // space unique path IDs.
+    bool compactTessVertexSpans = false; // Write tessellation spans as 32-byte
+                                         // TessVertexSpanCompact instead of TessVertexSpan?
+                                         // (Lossy: control points are stored as fp16.)
+    bool supportsAnalyticShapes = false; // Can the backend draw "DrawType::analyticShapes" in
+                                         // rasterOrdering and atomic modes?
 };
 
 // Gradient color stops are implemented as a horizontal span of pixels in a global gradient
@@ -216,8 +229,109 @@ struct TessVertexSpan
 };
 static_assert(sizeof(TessVertexSpan) == sizeof(float) * 16);
 
+// Converts a float to the bits of an fp16, rounding to nearest even. Values too large for fp16
+// saturate at +/-65504, and values too small to be normalized flush to zero. (NaN is not
+// supported.)
+RIVE_ALWAYS_INLINE uint16_t FloatToFP16(float f)
+{
+    uint32_t bits = math::bit_cast<uint32_t>(f);
+    uint32_t sign = (bits >> 16) & 0x8000;
+    bits &= 0x7fffffff;
+    if (bits >= 0x477fe000) // >= 65504
+    {
+        return sign | 0x7bff;
+    }
+    if (bits < 0x38800000) // < 2^-14
+    {
+        return sign;
+    }
+    // Rebias the exponent and round the mantissa to nearest even. (A carry out of the mantissa
+    // correctly bumps the exponent.)
+    bits -= (127 - 15) << 23;
+    bits += 0xfff + ((bits >> 13) & 1);
+    return sign | (bits >> 13);
+}
+
+RIVE_ALWAYS_INLINE uint32_t PackFP16x2(Vec2D v)
+{
+    return (static_cast<uint32_t>(FloatToFP16(v.y)) << 16) | FloatToFP16(v.x);
+}
+
+// Half-size alternative to TessVertexSpan, used when PlatformFeatures::compactTessVertexSpans is
+// enabled.
+//
+// Control points are stored as fp16 offsets from the midpoint of the contour they belong to, which
+// the tessellation shader reads back out of the contour buffer. Curves that share an endpoint
+// within a contour therefore still decode to identical vertices, but the encoding is lossy:
+// precision degrades as curves move away from their contour's midpoint. Draws whose offsets would
+// overflow fp16, or lose more than half the tessellation tolerance in device space, switch their
+// frame back to full TessVertexSpans. (See PLSRenderContext::frameUsesCompactTessVertexSpans().)
+//
+// Instead of explicit x0/x1/y coordinates for a span and its reflection, a compact span only
+// records the tessellation vertex where it begins, how many times it has wrapped to a new row of
+// the tessellation texture, and whether it is mirrored. The shader reconstructs the rest from the
+// segment counts. Forward and mirrored copies of a curve are written as two separate spans, so a
+// pair of them occupies the same space as one TessVertexSpan.
+struct TessVertexSpanCompact
+{
+    constexpr static uint32_t kMaxPaddingVertexCount = 0x1f;
+    constexpr static uint32_t kMaxWrapIdx = 3;
+    constexpr static uint32_t kMirroredBit = 1u << 31;
+
+    RIVE_ALWAYS_INLINE void set(const Vec2D pts_[4],
+                                Vec2D origin,
+                                Vec2D joinTangent_,
+                                uint32_t tessLocation, // Rightmost vertex if mirrored.
+                                uint32_t wrapIdx,
+                                bool mirrored,
+                                uint32_t paddingVertexCount,
+                                uint32_t parametricSegmentCount,
+                                uint32_t polarSegmentCount,
+                                uint32_t joinSegmentCount,
+                                uint32_t contourIDWithFlags_)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            pts[i] = PackFP16x2(pts_[i] - origin);
+        }
+        // The shader only uses the direction of joinTangent. Normalize it so it fits in fp16.
+        float tangentLength = joinTangent_.length();
+        joinTangent = PackFP16x2(tangentLength != 0 ? joinTangent_ * (1 / tangentLength)
+                                                    : joinTangent_);
+        location = (mirrored ? kMirroredBit : 0) | (paddingVertexCount << 24) | (wrapIdx << 22) |
+                   tessLocation;
+        segmentCounts =
+            (joinSegmentCount << 20) | (polarSegmentCount << 10) | parametricSegmentCount;
+        contourIDWithFlags = contourIDWithFlags_;
+
+        // Ensure we didn't lose any data from packing.
+        assert(tessLocation < 1u << 22);
+        assert(wrapIdx <= kMaxWrapIdx);
+        assert(paddingVertexCount <= kMaxPaddingVertexCount);
+        assert((segmentCounts & 0x3ff) == parametricSegmentCount);
+        assert(((segmentCounts >> 10) & 0x3ff) == polarSegmentCount);
+        assert(segmentCounts >> 20 == joinSegmentCount);
+    }
+
+    uint32_t pts[4];             // fp16x2 offsets from the contour midpoint.
+    uint32_t joinTangent;        // fp16x2, normalized.
+    uint32_t location;           // [mirrored, unused, paddingVertexCount, wrapIdx, tessLocation]
+    uint32_t segmentCounts;      // [joinSegmentCount, polarSegmentCount, parametricSegmentCount]
+    uint32_t contourIDWithFlags; // flags | contourID
+};
+static_assert(sizeof(TessVertexSpanCompact) * 2 == sizeof(TessVertexSpan));
+
+// Size of one tessellation span in the format the given platform writes.
+constexpr size_t TessVertexSpanSizeInBytes(const PlatformFeatures& platformFeatures)
+{
+    return platformFeatures.compactTessVertexSpans ? sizeof(TessVertexSpanCompact)
+                                                   : sizeof(TessVertexSpan);
+}
+
 // Tessellation spans are drawn as two distinct, 1px-tall rectangles: the span and its reflection.
+// (Compact spans only have one rectangle, and are drawn with the first 6 indices.)
 constexpr uint16_t kTessSpanIndices[4 * 3] = {0, 1, 2, 2, 1, 3, 4, 5, 6, 6, 5, 7};
+constexpr uint32_t kCompactTessSpanIndexCount = 6;
 
 // ImageRects are a special type of non-overlapping antialiased draw that we only have to use when
 // we don't have bindless textures in atomic mode. They allow us to bind a texture and draw it in
@@ -259,6 +373,48 @@ enum class PaintType : uint32_t
     clipUpdate, // Update the clip buffer instead of drawing to the framebuffer.
 };
 
+// Block-compressed formats that images can be uploaded in directly, without decoding to RGBA.
+// Every format has 4x4 texel blocks.
+enum class CompressedTextureFormat
+{
+    etc2RGB8,
+    etc2RGBA8,
+    astc4x4RGBA,
+    bc1RGBA,
+    bc3RGBA,
+    bc7RGBA,
+};
+
+constexpr static uint32_t CompressedTextureBlockSizeInBytes(CompressedTextureFormat format)
+{
+    return format == CompressedTextureFormat::etc2RGB8 || format == CompressedTextureFormat::bc1RGBA
+               ? 8
+               : 16;
+}
+
+constexpr static size_t CompressedTextureSizeInBytes(CompressedTextureFormat format,
+                                                     uint32_t width,
+                                                     uint32_t height)
+{
+    return ((static_cast<size_t>(width) + 3) / 4) * ((static_cast<size_t>(height) + 3) / 4) *
+           CompressedTextureBlockSizeInBytes(format);
+}
+
+// Block-compressed image with its own mip chain. Mip level i is max(width >> i, 1) x
+// max(height >> i, 1) texels, and its blocks are laid out row by row at mipLevelData[i].
+struct CompressedImage
+{
+    constexpr static uint32_t kMaxMipLevels = 16;
+    // Larger images are rejected before any size math is done on their dimensions.
+    constexpr static uint32_t kMaxDimension = 1 << (kMaxMipLevels - 2);
+
+    CompressedTextureFormat format;
+    uint32_t width;
+    uint32_t height;
+    uint32_t mipLevelCount;
+    const uint8_t* mipLevelData[kMaxMipLevels];
+};
+
 // Specifies the location of a simple or complex horizontal color ramp within the gradient texture.
 // A simple color ramp is two texels wide, beginning at the specified row and column.
 // A complex color ramp spans the entire width of the gradient texture, on the row:
@@ -439,6 +595,7 @@ enum class DrawType : uint8_t
     plsAtomicInitialize, // Clear/init PLS data when we can't do it with existing clear/load APIs.
     plsAtomicResolve,    // Resolve PLS data to the final renderTarget color in atomic mode.
     stencilClipReset,    // Clear or intersect (based on DrawContents) the stencil clip bit.
+    analyticShapes,      // Rects, rounded rects, and ellipses with analytic coverage.
 };
 
 constexpr static uint32_t PatchSegmentSpan(DrawType drawType)
@@ -581,6 +738,7 @@ constexpr static ShaderFeatures ShaderFeaturesMaskFor(DrawType drawType,
         case DrawType::midpointFanPatches:
         case DrawType::outerCurvePatches:
         case DrawType::interiorTriangulation:
+        case DrawType::analyticShapes:
         case DrawType::plsAtomicResolve:
             mask = kAllShaderFeatures;
             break;
@@ -623,6 +781,27 @@ uint32_t ShaderUniqueKey(DrawType, ShaderFeatures, InterlockMode, ShaderMiscFlag
 
 extern const char* GetShaderFeatureGLSLName(ShaderFeatures feature);
 
+// Identifies one specific draw shader (or pipeline, depending on the backend). Used for compiling
+// shaders up front instead of lazily at flush time. (See PLSRenderContext::precompileShaders().)
+struct ShaderVariant
+{
+    DrawType drawType;
+    ShaderFeatures shaderFeatures;
+    InterlockMode interlockMode;
+    ShaderMiscFlags shaderMiscFlags;
+
+    uint32_t uniqueKey() const
+    {
+        return ShaderUniqueKey(drawType, shaderFeatures, interlockMode, shaderMiscFlags);
+    }
+};
+
+// Reads and writes a "shader manifest": a list of ShaderVariants in a simple text format, as
+// emitted by the shader_manifest tool. ParseShaderManifest() appends to 'variants' and returns
+// false if the manifest is malformed or was written by an incompatible version of the renderer.
+std::string WriteShaderManifest(const std::vector<ShaderVariant>&);
+bool ParseShaderManifest(const char* manifest, std::vector<ShaderVariant>* variants);
+
 // Flags indicating the contents of a draw. These don't affect shaders, but in depthStencil mode
 // they are needed to break up batching. (depthStencil needs different stencil/blend state,
 // depending on the DrawContents.)
@@ -667,6 +846,11 @@ struct DrawBatch
     ShaderFeatures shaderFeatures = ShaderFeatures::NONE;
     bool needsBarrier = false; // Pixel-local-storage barrier required after submitting this batch.
 
+    // DrawType::outerCurvePatches in depthStencil mode. The outer curves of an interior
+    // triangulation get drawn twice: first to stencil them, then (after the interior triangles) to
+    // cover them.
+    bool isStencilCover = false;
+
     // DrawType::imageRect and DrawType::imageMesh.
     uint32_t imageDrawDataOffset = 0;
     const PLSTexture* imageTexture = nullptr;
@@ -722,6 +906,7 @@ struct FlushDescriptor
     size_t flushUniformDataOffsetInBytes = 0;
     size_t pathCount = 0;
     size_t firstPath = 0;
+    size_t paintCount = 0; // Paint records are deduplicated, so this can be less than pathCount.
     size_t firstPaint = 0;
     size_t firstPaintAux = 0;
     size_t contourCount = 0;
@@ -730,6 +915,7 @@ struct FlushDescriptor
     size_t firstComplexGradSpan = 0;
     size_t tessVertexSpanCount = 0;
     size_t firstTessVertexSpan = 0;
+    bool compactTessVertexSpans = false; // Spans are pls::TessVertexSpanCompact in this flush?
     uint32_t simpleGradTexelsWidth = 0;
     uint32_t simpleGradTexelsHeight = 0;
     size_t simpleGradDataOffsetInBytes = 0;
@@ -771,6 +957,97 @@ template <uint32_t Alignment> RIVE_ALWAYS_INLINE uint32_t PaddingToAlignUp(uint3
 // transforming the given bounds by the given matrix.
 float FindTransformedArea(const AABB& bounds, const Mat2D&);
 
+// Matrix-independent measurements of a path that its TriangulationCostFeatures are derived from.
+// These require walking every verb, so PLSPath memoizes them until the path mutates.
+struct PathCostMetrics
+{
+    // Signed area of the path, with curves coarsely linearized.
+    float coarseArea = 0;
+    // Sum of the unsigned areas of a triangle fan over each of the path's linearized contours.
+    // This is how much area midpoint fans shade; wherever fan triangles overlap with opposite
+    // windings, they shade pixels that don't end up covered.
+    float coarseFanArea = 0;
+    uint32_t verbCount = 0;    // Number of lines and curves in the path.
+    uint32_t contourCount = 0; // Number of contours in the path.
+};
+
+// Inputs to the TriangulationCostModel for a single filled path.
+struct TriangulationCostFeatures
+{
+    // Estimated number of pixels that midpoint fans would shade outside the path, i.e., the
+    // device-space fan area minus the covered area. This is exact for simple contours, including
+    // concave ones and holes. Overlapping contours with the same winding are underestimated, and
+    // self-intersecting contours can be overestimated, so it's clamped to the device-space bounds.
+    float fanOverdrawPixels = 0;
+    float verbCount = 0;      // Number of lines and curves in the path.
+    float contourCount = 0;   // Number of contours in the path.
+    float barrierCount = 0;   // Number of extra batching barriers interior triangulation requires.
+    float coverPassCount = 0; // Number of extra passes over the outer curves (depthStencil only).
+};
+
+// 'boundsPixelArea' is the area of the path's bounds in device space. (See FindTransformedArea().)
+TriangulationCostFeatures FindTriangulationCostFeatures(const PathCostMetrics&,
+                                                        float boundsPixelArea,
+                                                        const Mat2D&,
+                                                        InterlockMode);
+
+// Decides whether a filled path should be drawn with midpoint fans or with interior triangulation.
+// Both approaches shade the path's interior once, so the model only weighs what differs: fans also
+// shade their overdraw, whereas triangulation pays a CPU cost for every verb and contour it
+// processes, plus any batching barriers and extra cover passes it adds. Units are arbitrary as long
+// as they're consistent; the defaults are expressed in "fan overdraw pixels".
+struct TriangulationCostModel
+{
+    float fanOverdrawPixelCost = 1;
+    float triangulationFixedCost = 16 * 1024;
+    float triangulationVerbCost = 64;
+    float triangulationContourCost = 256;
+    float barrierCost = 8 * 1024;
+    float coverPassCost = 8 * 1024;
+
+    // Returns how much cheaper interior triangulation is predicted to be than midpoint fans.
+    // (Negative if midpoint fans are cheaper.)
+    float triangulationSavings(const TriangulationCostFeatures& f) const
+    {
+        return fanOverdrawPixelCost * f.fanOverdrawPixels - triangulationFixedCost -
+               triangulationVerbCost * f.verbCount -
+               triangulationContourCost * f.contourCount - barrierCost * f.barrierCount -
+               coverPassCost * f.coverPassCount;
+    }
+
+    // Since fanOverdrawPixels never exceeds the device-space bounds area, interior triangulation
+    // can't win for paths whose bounds area is below this. Lets callers skip finding the features.
+    bool canTriangulationSaveAnything(float boundsPixelArea) const
+    {
+        return fanOverdrawPixelCost * boundsPixelArea > triangulationFixedCost;
+    }
+};
+
+// Selects how filled paths get tessellated.
+enum class FillAlgorithm
+{
+    costModel,             // Let the TriangulationCostModel decide for each path.
+    midpointFans,          // Always use midpoint fans.
+    interiorTriangulation, // Use interior triangulation wherever it's supported.
+};
+
+// One benchmark measurement for calibrating a TriangulationCostModel: the features of a path, and
+// the measured cost of drawing it with midpoint fans minus the measured cost of drawing it with
+// interior triangulation. (See PLSRenderContext::FrameDescriptor::fillAlgorithm.)
+struct TriangulationCostSample
+{
+    TriangulationCostFeatures features;
+    float measuredSavings;
+};
+
+// Fits the weights of a TriangulationCostModel to a set of benchmark samples from a specific class
+// of device, using linear least squares. Weights that the samples don't exercise (e.g.,
+// barrierCost if no samples were measured in atomic mode) are taken from 'fallback'. Returns
+// 'fallback' if the samples can't produce a meaningful model.
+TriangulationCostModel FitTriangulationCostModel(const TriangulationCostSample*,
+                                                 size_t sampleCount,
+                                                 const TriangulationCostModel& fallback = {});
+
 // Convert a BlendMode to the tightly-packed range used by PLS shaders.
 uint32_t ConvertBlendModeToPLSBlendMode(BlendMode riveMode);
 
@@ -780,6 +1057,24 @@ RIVE_ALWAYS_INLINE uint32_t SwizzleRiveColorToRGBA(ColorInt riveColor)
     return (riveColor & 0xff00ff00) | (math::rotateleft32(riveColor, 16) & 0x00ff00ff);
 }
 
+// 64-bit FNV-1a, for fingerprinting content between frames.
+constexpr static uint64_t kFNVOffsetBasis = 0xcbf29ce484222325llu;
+inline uint64_t HashBytes(uint64_t hash, const void* data, size_t sizeInBytes)
+{
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < sizeInBytes; ++i)
+    {
+        hash = (hash ^ bytes[i]) * 0x100000001b3llu;
+    }
+    return hash;
+}
+
+template <typename T> uint64_t HashValue(uint64_t hash, const T& value)
+{
+    static_assert(std::is_trivially_copyable_v<T>);
+    return HashBytes(hash, &value, sizeof(T));
+}
+
 // Used for fields that are used to layout write-only mapped GPU memory.
 // "volatile" to discourage the compiler from generating code that reads these values
 // (e.g., don't let the compiler generate "x ^= x" instead of "x = 0").
@@ -865,20 +1160,24 @@ struct PathData
 public:
     constexpr static StorageBufferStructure kBufferStructure = StorageBufferStructure::uint32x4;
 
-    void set(const Mat2D&, float strokeRadius, uint32_t zIndex);
+    void set(const Mat2D&, float strokeRadius, uint32_t zIndex, uint32_t paintID);
 
 private:
     WRITEONLY float m_matrix[6];
-    WRITEONLY float m_strokeRadius; // "0" indicates that the path is filled, not stroked.
-    WRITEONLY uint32_t m_zIndex;    // pls::InterlockMode::depthStencil only.
+    WRITEONLY float m_strokeRadius;       // "0" indicates that the path is filled, not stroked.
+    WRITEONLY uint32_t m_paintIDAndZIndex; // [paintID, zIndex (pls::InterlockMode::depthStencil)]
 };
 static_assert(sizeof(PathData) == StorageBufferElementSizeInBytes(PathData::kBufferStructure) * 2);
 static_assert(256 % sizeof(PathData) == 0);
 constexpr static size_t kPathBufferAlignmentInElements = 256 / sizeof(PathData);
 
-// High level structure of the "paint" storage buffer. Each path also has a data small record
-// describing its paint at a high level. Complex paints (gradients, images, or any path with a
-// clipRect) store additional rendering info in the PaintAuxData buffer.
+// High level structure of the "paint" storage buffer. Each path references a small record
+// describing its paint at a high level, via the paintID in its PathData. Complex paints (gradients,
+// images, or any path with a clipRect) store additional rendering info in the PaintAuxData buffer,
+// at the same index.
+//
+// Identical paint records are only written once per flush, except in atomic mode, where the
+// fragment shader looks paints up by pathID and every path therefore has its own record.
 struct PaintData
 {
 public:
@@ -887,6 +1186,7 @@ public:
     void set(FillRule,
              PaintType,
              SimplePaintValue,
+             const PLSTexture*,
              GradTextureLayout,
              uint32_t clipID,
              bool hasClipRect,
@@ -906,8 +1206,8 @@ static_assert(sizeof(PaintData) == StorageBufferElementSizeInBytes(PaintData::kB
 static_assert(256 % sizeof(PaintData) == 0);
 constexpr static size_t kPaintBufferAlignmentInElements = 256 / sizeof(PaintData);
 
-// Structure of the "paintAux" storage buffer. Gradients, images, and clipRects store their details
-// here, indexed by pathID.
+// Structure of the "paintAux" storage buffer. Gradients, images, clip masks, and clipRects store
+// their details here, indexed by paintID.
 struct PaintAuxData
 {
 public:
@@ -952,7 +1252,7 @@ public:
 
 private:
     WRITEONLY Vec2D m_midpoint;        // Midpoint of the curve endpoints in just this contour.
-    WRITEONLY uint32_t m_pathID;       // ID of the path this contour belongs to.
+    WRITEONLY uint32_t m_pathID;       // [flags, parametricPrecision, pathID]
     WRITEONLY uint32_t m_vertexIndex0; // Index of the first tessellation vertex of the contour.
 };
 static_assert(sizeof(ContourData) ==
@@ -980,6 +1280,42 @@ private:
 };
 static_assert(sizeof(TriangleVertex) == sizeof(float) * 3);
 
+// Vertex for DrawType::analyticShapes. Coordinates are in a normalized "shape space" where the
+// outer shape spans [-1, +1], and the path matrix maps shape space to pixels. Radii and the inner
+// half size (for strokes) are also in shape space.
+//
+// These get written to the triangle vertex buffer, where each one takes the place of 3
+// TriangleVertex records.
+struct AnalyticShapeVertex
+{
+public:
+    AnalyticShapeVertex() = default;
+    AnalyticShapeVertex(Vec2D shapeCoord,
+                        uint16_t pathID,
+                        Vec2D outerRadii,
+                        Vec2D innerRadii,
+                        Vec2D innerHalfSize) :
+        m_shapeCoord(shapeCoord),
+        m_pathID(pathID),
+        m_outerRadii(outerRadii),
+        m_innerRadii(innerRadii),
+        m_innerHalfSize(innerHalfSize)
+    {}
+
+private:
+    WRITEONLY Vec2D m_shapeCoord;
+    WRITEONLY uint32_t m_pathID;
+    WRITEONLY Vec2D m_outerRadii;
+    WRITEONLY Vec2D m_innerRadii;
+    WRITEONLY Vec2D m_innerHalfSize; // Zero for fills.
+};
+constexpr static uint32_t kTriangleVerticesPerAnalyticShapeVertex = 3;
+static_assert(sizeof(AnalyticShapeVertex) ==
+              sizeof(TriangleVertex) * kTriangleVerticesPerAnalyticShapeVertex);
+
+// Each analytic shape is a single quad, drawn as two triangles.
+constexpr static uint32_t kAnalyticShapeVertexCount = 6;
+
 // Per-draw uniforms used by image meshes.
 struct ImageDrawUniforms
 {
@@ -988,26 +1324,33 @@ public:
 
     ImageDrawUniforms(const Mat2D&,
                       float opacity,
+                      const PLSTexture*,
                       const ClipRectInverseMatrix*,
                       uint32_t clipID,
                       BlendMode,
-                      uint32_t zIndex);
+                      uint32_t zIndex,
+                      const AABB& texCoordRect);
 
 private:
     WRITEONLY float m_matrix[6];
     WRITEONLY float m_opacity;
-    WRITEONLY float m_padding = 0;
+    WRITEONLY uint32_t m_flags;
     WRITEONLY float m_clipRectInverseMatrix[6];
     WRITEONLY uint32_t m_clipID;
     WRITEONLY uint32_t m_blendMode;
     WRITEONLY uint32_t m_zIndex; // pls::InterlockMode::depthStencil only.
+    WRITEONLY uint32_t m_padding2[3] = {0, 0, 0};
+    // [scaleX, scaleY, translateX, translateY] that maps [0, 0, 1, 1] to the image's subregion of
+    // its texture. (Images may live in an atlas.)
+    WRITEONLY float m_texCoordTransform[4];
     // Uniform blocks must be multiples of 256 bytes in size.
-    WRITEONLY uint8_t m_padTo256Bytes[256 - 68];
+    WRITEONLY uint8_t m_padTo256Bytes[256 - 96];
 
     constexpr void staticChecks()
     {
         static_assert(offsetof(ImageDrawUniforms, m_matrix) % 16 == 0);
         static_assert(offsetof(ImageDrawUniforms, m_clipRectInverseMatrix) % 16 == 0);
+        static_assert(offsetof(ImageDrawUniforms, m_texCoordTransform) == 80);
         static_assert(sizeof(ImageDrawUniforms) == 256);
     }
 };
@@ -1071,6 +1414,13 @@ public:
     {
         new (&push()) T(std::forward<Args>(args)...);
     }
+    // Appends and writes an item of a different type that spans a whole number of elements.
+    template <typename U, typename... Args> RIVE_ALWAYS_INLINE void emplace_back_as(Args&&... args)
+    {
+        static_assert(sizeof(U) % sizeof(T) == 0);
+        static_assert(alignof(U) <= alignof(T));
+        new (push(sizeof(U) / sizeof(T))) U(std::forward<Args>(args)...);
+    }
     template <typename... Args> RIVE_ALWAYS_INLINE void set_back(Args&&... args)
     {
         push().set(std::forward<Args>(args)...);
@@ -35,6 +35,7 @@ public:
     {
         midpointFanPath,
         interiorTriangulationPath,
+        analyticShapePath,
         imageRect,
         imageMesh,
         stencilClipReset,
@@ -60,6 +61,10 @@ public:
     pls::SimplePaintValue simplePaintValue() const { return m_simplePaintValue; }
     const PLSGradient* gradient() const { return m_gradientRef; }
 
+    // Pixels that this draw is guaranteed to cover entirely with opaque, srcOver color, ignoring
+    // clipping. Empty if there is no such region. (Used for occlusion culling.)
+    const IAABB& opaqueCoverageBounds() const { return m_opaqueCoverageBounds; }
+
     // Clipping setup.
     void setClipID(uint32_t clipID);
     void setClipRect(const pls::ClipRectInverseMatrix* m) { m_clipRectInverseMatrix = m; }
@@ -89,6 +94,15 @@ public:
     // method before clearing the drawList to release all our held references.
     virtual void releaseRefs();
 
+    // Hashes everything about this draw that affects its rendered output, other than pixelBounds.
+    // Used to detect which draws changed from one frame to the next. (See
+    // PLSRenderContext::FrameDescriptor::retainedFrame.)
+    virtual uint64_t contentHash() const;
+
+    // False if contentHash() can't capture everything that affects this draw's output. A flush
+    // containing an unhashable draw is always redrawn in full, and is not reused by the next frame.
+    virtual bool isContentHashable() const { return true; }
+
 protected:
     const PLSTexture* const m_imageTextureRef;
     const IAABB m_pixelBounds;
@@ -101,6 +115,8 @@ protected:
 
     pls::DrawContents m_drawContents = pls::DrawContents::none;
 
+    IAABB m_opaqueCoverageBounds = {0, 0, 0, 0};
+
     // Filled in by the subclass constructor.
     ResourceCounters m_resourceCounts;
 
@@ -131,12 +147,15 @@ public:
     FillRule fillRule() const { return m_fillRule; }
     pls::PaintType paintType() const { return m_paintType; }
     float strokeRadius() const { return m_strokeRadius; }
+    float parametricPrecision() const { return m_parametricPrecision; }
     pls::ContourDirections contourDirections() const { return m_contourDirections; }
 
     void pushToRenderContext(PLSRenderContext::LogicalFlush*) final;
 
     void releaseRefs() override;
 
+    uint64_t contentHash() const override;
+
 public:
     PLSPathDraw(IAABB pathBounds,
                 const Mat2D&,
@@ -154,6 +173,11 @@ public:
     const float m_strokeRadius;
     pls::ContourDirections m_contourDirections;
 
+    // Runtime tessellation precisions, scaled down from kParametricPrecision and kPolarPrecision
+    // by the frame's and paint's tessellation quality.
+    float m_parametricPrecision = kParametricPrecision;
+    float m_polarPrecision = kPolarPrecision;
+
     // Used to guarantee m_pathRef doesn't change for the entire time we hold it.
     RIVE_DEBUG_CODE(size_t m_rawPathMutationID;)
 };
@@ -169,6 +193,8 @@ public:
                         FillRule,
                         const PLSPaint*);
 
+    uint64_t contentHash() const override;
+
 protected:
     void onPushToRenderContext(PLSRenderContext::LogicalFlush*) override;
 
@@ -183,6 +209,8 @@ protected:
     float m_strokeMatrixMaxScale;
     StrokeJoin m_strokeJoin;
     StrokeCap m_strokeCap;
+    // Strokes no wider than a pixel skip joins and polar segments.
+    bool m_isHairline = false;
 
     struct ContourInfo
     {
@@ -254,10 +282,11 @@ protected:
         kPatchSegmentCountExcludingJoin;
 
     static size_t FindSubdivisionCount(const Vec2D pts[],
+                                       float parametricPrecision,
                                        const wangs_formula::VectorXform& vectorXform)
     {
         size_t numSubdivisions =
-            ceilf(wangs_formula::cubic(pts, kParametricPrecision, vectorXform) *
+            ceilf(wangs_formula::cubic(pts, parametricPrecision, vectorXform) *
                   (1.f / kPatchSegmentCountExcludingJoin));
         return std::clamp<size_t>(numSubdivisions, 1, kMaxCurveSubdivisions);
     }
@@ -281,6 +310,51 @@ protected:
     GrInnerFanTriangulator* m_triangulator = nullptr;
 };
 
+// Draws a rect, rounded rect, or ellipse (filled or stroked) as a single quad whose coverage is
+// evaluated analytically in the fragment shader. Skips tessellation and contour records entirely.
+class AnalyticShapeDraw : public PLSPathDraw
+{
+public:
+    // Returns null if the path isn't a rect, rounded rect, or ellipse, or if the paint's stroke
+    // can't be represented as the difference of two rounded rects.
+    static PLSDrawUniquePtr Make(PLSRenderContext*,
+                                 const Mat2D&,
+                                 const rcp<const PLSPath>&,
+                                 const PLSPaint*);
+
+    // Normalized geometry of the shape, in a space where the outer shape spans [-1, +1].
+    struct ShapeParams
+    {
+        Vec2D outerRadii;
+        Vec2D innerRadii;
+        Vec2D innerHalfSize; // Zero for fills.
+        AABB quadBounds;     // Outset from [-1, +1] by at least 1px.
+    };
+
+    AnalyticShapeDraw(IAABB pixelBounds,
+                      const Mat2D& matrix,
+                      const Mat2D& shapeMatrix,
+                      rcp<const PLSPath>,
+                      const PLSPaint*,
+                      const ShapeParams&,
+                      pls::InterlockMode);
+
+    // Maps normalized shape coordinates to pixels.
+    const Mat2D& shapeMatrix() const { return m_shapeMatrix; }
+    Vec2D outerRadii() const { return m_params.outerRadii; }
+    Vec2D innerRadii() const { return m_params.innerRadii; }
+    Vec2D innerHalfSize() const { return m_params.innerHalfSize; }
+    const AABB& quadBounds() const { return m_params.quadBounds; }
+
+    uint64_t contentHash() const override;
+
+protected:
+    void onPushToRenderContext(PLSRenderContext::LogicalFlush*) override;
+
+    const Mat2D m_shapeMatrix;
+    const ShapeParams m_params;
+};
+
 // Pushes an imageRect to the render context.
 // This should only be used when we don't have bindless textures in atomic mode. Otherwise, images
 // should be drawn as rectangular paths with an image paint.
@@ -292,14 +366,22 @@ public:
                   const Mat2D&,
                   BlendMode,
                   rcp<const PLSTexture>,
-                  float opacity);
+                  float opacity,
+                  const AABB& texCoordRect = {0, 0, 1, 1});
 
     float opacity() const { return m_opacity; }
 
+    // Subregion of the image texture to draw, in normalized texture coordinates. (Not [0, 0, 1, 1]
+    // when the image lives in an atlas.)
+    const AABB& texCoordRect() const { return m_texCoordRect; }
+
     void pushToRenderContext(PLSRenderContext::LogicalFlush*) override;
 
+    uint64_t contentHash() const override;
+
 protected:
     const float m_opacity;
+    const AABB m_texCoordRect;
 };
 
 // Pushes an imageMesh to the render context.
@@ -314,7 +396,8 @@ public:
                   rcp<const RenderBuffer> uvBuffer,
                   rcp<const RenderBuffer> indexBuffer,
                   uint32_t indexCount,
-                  float opacity);
+                  float opacity,
+                  const AABB& texCoordRect = {0, 0, 1, 1});
 
     const RenderBuffer* vertexBuffer() const { return m_vertexBufferRef; }
     const RenderBuffer* uvBuffer() const { return m_uvBufferRef; }
@@ -322,16 +405,25 @@ public:
     uint32_t indexCount() const { return m_indexCount; }
     float opacity() const { return m_opacity; }
 
+    // The uvBuffer's [0, 0, 1, 1] gets mapped to this subregion of the image texture. (Not
+    // [0, 0, 1, 1] when the image lives in an atlas.)
+    const AABB& texCoordRect() const { return m_texCoordRect; }
+
     void pushToRenderContext(PLSRenderContext::LogicalFlush*) override;
 
     void releaseRefs() override;
 
+    // RenderBuffers can be modified without any notification, so image meshes are never considered
+    // equivalent to a draw from a previous frame.
+    bool isContentHashable() const override { return false; }
+
 protected:
     const RenderBuffer* const m_vertexBufferRef;
     const RenderBuffer* const m_uvBufferRef;
     const RenderBuffer* const m_indexBufferRef;
     const uint32_t m_indexCount;
     const float m_opacity;
+    const AABB m_texCoordRect;
 };
 
 // Resets the stencil clip by either entirely erasing the existing clip, or intersecting it with a
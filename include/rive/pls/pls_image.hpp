@@ -7,9 +7,13 @@
 #include "rive/refcnt.hpp"
 #include "rive/renderer.hpp"
 #include "rive/pls/pls_render_context_impl.hpp"
+#include <thread>
+#include <vector>
 
 namespace rive::pls
 {
+class PLSRenderContextHelperImpl;
+
 class PLSTexture : public RefCnt<PLSTexture>
 {
 public:
@@ -26,11 +30,68 @@ public:
     // Only supported if PlatformFeatures::supportsBindlessTextures is set, otherwise 0.
     uint64_t bindlessTextureHandle() const { return m_bindlessTextureHandle; }
 
+    // True if the texels already have premultiplied alpha (e.g., the texture of an offscreen render
+    // target). Image shaders unmultiply these texels before applying opacity.
+    bool hasPremultipliedAlpha() const { return m_hasPremultipliedAlpha; }
+
 protected:
     uint32_t m_width;
     uint32_t m_height;
     uint32_t m_textureResourceHash;
     uint64_t m_bindlessTextureHandle = 0;
+    bool m_hasPremultipliedAlpha = false;
+};
+
+// Shared texture that small images get packed into, so draws of different images can still be
+// batched together. Each image is uploaded, along with its gutter and mips, straight into its own
+// cell of the GPU texture when it's added; no CPU copy of the full page is kept.
+//
+// Not thread safe: a page must only be used from the thread that owns its render context.
+class PLSImageAtlasPage : public RefCnt<PLSImageAtlasPage>
+{
+public:
+    constexpr static uint32_t kSize = 1024;
+
+    // Images larger than this in either dimension get their own texture.
+    constexpr static uint32_t kMaxImageSize = 128;
+
+    // Every image is surrounded by a gutter of replicated edge pixels, and its gutter begins at a
+    // multiple of kGutter. This guarantees that no texel in the first kMipLevelCount mip levels
+    // blends two different images, and that bilinear filtering at those levels only ever reads the
+    // image or its own gutter.
+    constexpr static uint32_t kGutter = 8;
+    constexpr static uint32_t kMipLevelCount = 4;
+    static_assert(1u << (kMipLevelCount - 1) == kGutter);
+
+    PLSImageAtlasPage(PLSRenderContextHelperImpl*);
+
+    // Uploads the image into the page and returns its location, in pixels, via 'region'. Returns
+    // false if the page doesn't have room for it.
+    //
+    // Only texels of the new image's cell are written, so draws that already reference the page
+    // (even ones recorded earlier in the current frame) are unaffected.
+    bool addImage(uint32_t width, uint32_t height, const uint8_t imageDataRGBA[], IAABB* region);
+
+    // Stops accepting new images and releases the scratch memory used to build cells.
+    void close();
+
+    PLSTexture* texture() const { return m_texture.get(); }
+
+private:
+    PLSRenderContextHelperImpl* const m_impl;
+    rcp<PLSTexture> m_texture;
+    bool m_isClosed = false;
+
+    // Scratch space for one cell and its mips. Never larger than a kMaxImageSize image plus its
+    // gutter.
+    std::vector<uint8_t> m_cellPixelsRGBA;
+
+    // Images are packed left to right in horizontal shelves.
+    uint32_t m_shelfTop = 0;
+    uint32_t m_shelfHeight = 0;
+    uint32_t m_shelfX = 0;
+
+    RIVE_DEBUG_CODE(std::thread::id m_ownerThreadID = std::this_thread::get_id();)
 };
 
 class PLSImage : public lite_rtti_override<RenderImage, PLSImage>
@@ -41,8 +102,26 @@ public:
         resetTexture(std::move(texture));
     }
 
-    rcp<PLSTexture> refTexture() const { return m_texture; }
-    const PLSTexture* getTexture() const { return m_texture.get(); }
+    // Image that occupies 'atlasRegion' (in pixels) of a shared atlas page. 'texCoordRectPath' is a
+    // rectangle covering the same region in normalized texture coordinates, which PLSRenderer draws
+    // with an image paint.
+    PLSImage(rcp<PLSImageAtlasPage>, const IAABB& atlasRegion, rcp<RenderPath> texCoordRectPath);
+
+    rcp<PLSTexture> refTexture() const
+    {
+        return m_atlasPage != nullptr ? ref_rcp(m_atlasPage->texture()) : m_texture;
+    }
+    const PLSTexture* getTexture() const
+    {
+        return m_atlasPage != nullptr ? m_atlasPage->texture() : m_texture.get();
+    }
+
+    // Subregion of getTexture() that this image occupies, in normalized texture coordinates.
+    // [0, 0, 1, 1] unless the image lives in an atlas.
+    const AABB& texCoordRect() const { return m_texCoordRect; }
+
+    // Rectangular path of texCoordRect(), or null if the image does not live in an atlas.
+    RenderPath* texCoordRectPath() const { return m_texCoordRectPath.get(); }
 
 protected:
     PLSImage(int width, int height)
@@ -63,5 +142,8 @@ protected:
 
 private:
     rcp<PLSTexture> m_texture;
+    rcp<PLSImageAtlasPage> m_atlasPage;
+    AABB m_texCoordRect = {0, 0, 1, 1};
+    rcp<RenderPath> m_texCoordRectPath;
 };
 } // namespace rive::pls
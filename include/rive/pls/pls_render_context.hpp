@@ -8,6 +8,7 @@
 #include "rive/pls/pls.hpp"
 #include "rive/pls/pls_factory.hpp"
 #include "rive/pls/pls_render_target.hpp"
+#include "rive/pls/resource_allocation_policy.hpp"
 #include "rive/pls/trivial_block_allocator.hpp"
 #include "rive/shapes/paint/color.hpp"
 #include <array>
@@ -23,6 +24,7 @@ class RawPath;
 
 namespace rive::pls
 {
+class AnalyticShapeDraw;
 class GradientLibrary;
 class IntersectionBoard;
 class ImageMeshDraw;
@@ -57,6 +59,23 @@ public:
     size_t operator()(const GradientContentKey&) const;
 };
 
+// Used as a key for deduplicating paint records within a flush. Paths can share a paintID if their
+// PaintData and PaintAuxData records are bitwise identical.
+struct PaintRecordKey
+{
+    PaintData paintData;
+    PaintAuxData paintAuxData;
+
+    bool operator==(const PaintRecordKey&) const;
+};
+
+// Hashes the raw bytes of a PaintRecordKey.
+class HashPaintRecord
+{
+public:
+    size_t operator()(const PaintRecordKey&) const;
+};
+
 // Even though PLSDraw is block-allocated, we still need to call releaseRefs() on each individual
 // instance before releasing the block. This smart pointer guarantees we always call releaseRefs()
 // (implementation in pls_draw.hpp).
@@ -109,6 +128,37 @@ public:
         bool disableRasterOrdering = false; // Use atomic mode in place of rasterOrdering, even if
                                             // rasterOrdering is supported.
 
+        // If true, the client guarantees the renderTarget still contains the previous frame's
+        // contents (from a frame that also set retainedFrame). The render context diffs this
+        // frame's draws against the previous frame's, and only re-renders the region that changed
+        // (the "damage" region). Only takes effect when loadAction is "clear" with an opaque
+        // clearColor, the frame supports clipRects, every draw to the renderTarget fits in a single
+        // logical flush, and every such draw can be hashed (image meshes can't); otherwise the
+        // entire frame is rendered as usual. Offscreen flushes (e.g., raster cache and clip mask
+        // renders) don't count against the single-flush requirement: they execute before the
+        // renderTarget's flush, and their contents reach the renderTarget via draws that hash the
+        // offscreen texture.
+        bool retainedFrame = false;
+
+        // Scales the precision of curve tessellation for every path in the frame, in the range
+        // [kMinTessellationQuality, 1]. At 1 (full quality), curves are tessellated to within 1/4
+        // pixel, and stroke edges to within 1/8 pixel. Lower values allow proportionally more error
+        // in exchange for fewer tessellated vertices (e.g., on low-end devices or during fast
+        // animation). Multiplied by the per-draw quality passed to PLSRenderer::drawPath().
+        float tessellationQuality = 1;
+
+        // Level-of-detail culling: if nonzero, PLSRenderer skips fills and strokes whose
+        // device-space bounding box is smaller than this many pixels in both dimensions, before
+        // doing any path processing. (e.g., zoomed-out maps and diagrams with thousands of
+        // sub-pixel features.) Callers can supply a per-draw size with
+        // PLSRenderer::drawPath(..., pixelSizeHint) to avoid mapping the path's bounds.
+        float lodMinPixelSize = 0;
+
+        // Overrides the TriangulationCostModel's choice between midpoint fans and interior
+        // triangulation for filled paths. (e.g., to benchmark both algorithms on the same content
+        // when calibrating the model with pls::FitTriangulationCostModel().)
+        pls::FillAlgorithm fillAlgorithm = pls::FillAlgorithm::costModel;
+
         // Testing flags.
         bool wireframe = false;
         bool fillsDisabled = false;
@@ -138,8 +188,21 @@ public:
     // as rectangular paths with an image paint.
     bool frameSupportsImagePaintForPaths() const;
 
+    // True if rects, rounded rects, and ellipses can be drawn with DrawType::analyticShapes in the
+    // current frame.
+    bool frameSupportsAnalyticShapes() const;
+
     const pls::InterlockMode frameInterlockMode() const { return m_frameInterlockMode; }
 
+    // True if tessellation spans are written as pls::TessVertexSpanCompact in the current frame.
+    // This follows PlatformFeatures::compactTessVertexSpans until a draw can't be encoded in fp16
+    // within tolerance, at which point the whole frame falls back to full pls::TessVertexSpans.
+    bool frameUsesCompactTessVertexSpans() const
+    {
+        return platformFeatures().compactTessVertexSpans && !m_frameNeedsFullTessVertexSpans;
+    }
+    void disableCompactTessVertexSpans() { m_frameNeedsFullTessVertexSpans = true; }
+
     // Generates a unique clip ID that is guaranteed to not exist in the current clip buffer, and
     // assigns a contentBounds to it.
     //
@@ -185,6 +248,20 @@ public:
         return m_clipContentID;
     }
 
+    // Uniquely identifies the current logical flush. Clip IDs are only meaningful within the
+    // logical flush that generated them.
+    uint64_t logicalFlushID() const { return m_logicalFlushID; }
+
+    // Returns true if the coverage of the given clip, which must have been generated during the
+    // current logical flush, has not been overwritten in the clip buffer by any clip generated
+    // since then.
+    bool isClipContentIntact(uint32_t clipID)
+    {
+        assert(m_didBeginFrame);
+        assert(!m_logicalFlushes.empty());
+        return m_logicalFlushes.back()->isClipContentIntact(clipID);
+    }
+
     // Appends a list of high-level PLSDraws to the current frame.
     // Returns false if the draws don't fit within the current resource constraints, at which point
     // the caller must issue a logical flush and try again.
@@ -195,6 +272,30 @@ public:
     // rotate/synchronize the buffer rings.
     void logicalFlush();
 
+    // A render target that can be drawn to offscreen, and whose contents can then be drawn as an
+    // image paint.
+    struct OffscreenTarget
+    {
+        rcp<PLSRenderTarget> renderTarget;
+        rcp<PLSTexture> texture; // Must report hasPremultipliedAlpha().
+        bool textureIsBottomUp = false; // Does row 0 of the texture hold the bottom row of pixels?
+    };
+
+    // Returns false if the backend does not support offscreen rendering.
+    bool makeOffscreenTarget(uint32_t width, uint32_t height, OffscreenTarget*);
+
+    // Suspends the current logical flush to the frame's main render target, and directs all
+    // subsequent draws into the given offscreen render target, which is cleared to transparent.
+    // Call endOffscreenLogicalFlush() to resume the suspended flush. The offscreen flush executes
+    // before the suspended one, so rendering offscreen does not break up the main render pass or
+    // invalidate its clip buffer contents. Must not be nested, and logicalFlush() must not be
+    // called in between.
+    void beginOffscreenLogicalFlush(rcp<PLSRenderTarget>);
+    void endOffscreenLogicalFlush();
+
+    // Increments at beginFrame(). Allows clients to detect frame boundaries.
+    uint64_t frameNumber() const { return m_frameNumber; }
+
     // GPU resources required to execute the GPU commands for a frame.
     struct FlushResources
     {
@@ -209,6 +310,58 @@ public:
     // with this render context.
     void releaseResources();
 
+    // Replaces the policy that decides how large GPU resources should be. (The default is
+    // DefaultResourceAllocationPolicy.) Must not be called between beginFrame() and flush().
+    void setResourceAllocationPolicy(std::unique_ptr<ResourceAllocationPolicy>);
+    ResourceAllocationPolicy* resourceAllocationPolicy() const
+    {
+        return m_resourceAllocationPolicy.get();
+    }
+
+    // Replaces the weights that decide whether to draw filled paths with midpoint fans or interior
+    // triangulation. Clients can calibrate a model for their class of device with
+    // pls::FitTriangulationCostModel(). Must not be called between beginFrame() and flush().
+    void setTriangulationCostModel(const pls::TriangulationCostModel& model)
+    {
+        assert(!m_didBeginFrame);
+        m_triangulationCostModel = model;
+    }
+    const pls::TriangulationCostModel& triangulationCostModel() const
+    {
+        return m_triangulationCostModel;
+    }
+
+    // Returns the GPU resource sizes currently allocated.
+    const ResourceAllocationCounts& currentResourceAllocations() const
+    {
+        return m_currentResourceAllocations;
+    }
+
+    // Allocates GPU resources up front, so content that is about to be shown doesn't reallocate
+    // them while its counts climb during the first few frames. Reserved counts are also passed on
+    // to the ResourceAllocationPolicy, so they don't get trimmed later, until releaseResources().
+    // Must not be called between beginFrame() and flush().
+    void reserve(const ResourceAllocationCounts&);
+
+    // The largest resource requirements of any frame since the last call to
+    // resetPeakResourceRequirements() (or releaseResources()). Can be saved with
+    // WriteResourceAllocationCounts() and fed back into reserve() the next time the same content
+    // loads.
+    const ResourceAllocationCounts& peakResourceRequirements() const
+    {
+        return m_peakResourceRequirements;
+    }
+    void resetPeakResourceRequirements()
+    {
+        m_peakResourceRequirements = ResourceAllocationCounts();
+    }
+
+    // Begins compiling the given shader variants (e.g., from a manifest generated by the
+    // shader_manifest tool) so they don't cause hitches when content first needs them. Variants
+    // for interlock modes this platform can't use are ignored. Depending on the backend,
+    // compilation may finish asynchronously. Must not be called between beginFrame() and flush().
+    void precompileShaders(const std::vector<pls::ShaderVariant>&);
+
     // Returns the context's TrivialBlockAllocator, which is automatically reset at the end of every
     // frame. (Memory in this allocator is preserved between logical flushes.)
     TrivialBlockAllocator& perFrameAllocator()
@@ -233,6 +386,18 @@ public:
         return m_parametricSegmentCountsAllocator;
     }
 
+    // Memory statistics for the CPU-side allocators above, as of the most recent flush().
+    struct AllocatorStats
+    {
+        TrivialBlockAllocator::Stats perFrame;
+        TrivialBlockAllocator::Stats numChops;
+        TrivialBlockAllocator::Stats chopVertices;
+        TrivialBlockAllocator::Stats tangentPairs;
+        TrivialBlockAllocator::Stats polarSegmentCounts;
+        TrivialBlockAllocator::Stats parametricSegmentCounts;
+    };
+    AllocatorStats allocatorStats() const;
+
     // Allocates a trivially destructible object that will be automatically dropped at the end of
     // the current frame.
     template <typename T, typename... Args> T* make(Args&&... args)
@@ -250,6 +415,7 @@ private:
     friend class PLSPathDraw;
     friend class MidpointFanPathDraw;
     friend class InteriorTriangulationDraw;
+    friend class AnalyticShapeDraw;
     friend class ImageRectDraw;
     friend class ImageMeshDraw;
     friend class StencilClipReset;
@@ -259,64 +425,61 @@ private:
     // Resets the CPU-side STL containers so they don't have unbounded growth.
     void resetContainers();
 
-    // Defines the exact size of each of our GPU resources. Computed during flush(), based on
-    // LogicalFlush::ResourceCounters and LogicalFlush::LayoutCounters.
-    struct ResourceAllocationCounts
-    {
-        using VecType = simd::gvec<size_t, 12>;
-
-        RIVE_ALWAYS_INLINE VecType toVec() const
-        {
-            static_assert(sizeof(VecType) >= sizeof(*this));
-            VecType vec;
-            RIVE_INLINE_MEMCPY(&vec, this, sizeof(*this));
-            return vec;
-        }
-
-        RIVE_ALWAYS_INLINE ResourceAllocationCounts(const VecType& vec)
-        {
-            static_assert(sizeof(VecType) >= sizeof(*this));
-            RIVE_INLINE_MEMCPY(this, &vec, sizeof(*this));
-        }
-
-        ResourceAllocationCounts() = default;
-
-        size_t flushUniformBufferCount = 0;
-        size_t imageDrawUniformBufferCount = 0;
-        size_t pathBufferCount = 0;
-        size_t paintBufferCount = 0;
-        size_t paintAuxBufferCount = 0;
-        size_t contourBufferCount = 0;
-        size_t simpleGradientBufferCount = 0;
-        size_t complexGradSpanBufferCount = 0;
-        size_t tessSpanBufferCount = 0;
-        size_t triangleVertexBufferCount = 0;
-        size_t gradTextureHeight = 0;
-        size_t tessTextureHeight = 0;
-    };
-
     // Reallocates GPU resources and updates m_currentResourceAllocations.
     // If forceRealloc is true, every GPU resource is allocated, even if the size would not change.
+    // platformFeatures(), with compactTessVertexSpans resolved for the current frame.
+    pls::PlatformFeatures framePlatformFeatures() const;
+
     void setResourceSizes(ResourceAllocationCounts, bool forceRealloc = false);
 
     void mapResourceBuffers(const ResourceAllocationCounts&);
     void unmapResourceBuffers();
 
+    // Fingerprints the current frame's draws, compares them against the previous frame's, and
+    // restricts rendering to the region that changed, if possible. (See
+    // FrameDescriptor::retainedFrame.)
+    void applyDamageTracking(const FlushResources&);
+
     const std::unique_ptr<PLSRenderContextImpl> m_impl;
     const size_t m_maxPathID;
 
+    std::unique_ptr<ResourceAllocationPolicy> m_resourceAllocationPolicy;
+    pls::TriangulationCostModel m_triangulationCostModel;
     ResourceAllocationCounts m_currentResourceAllocations;
-    ResourceAllocationCounts m_maxRecentResourceRequirements;
-    double m_lastResourceTrimTimeInSeconds;
+    size_t m_currentTessSpanSizeInBytes = 0; // The tess span buffer's unit size can vary by frame.
+    ResourceAllocationCounts m_peakResourceRequirements;
+    double m_lastContainerResetTimeInSeconds;
 
     // Per-frame state.
+    uint64_t m_frameNumber = 0;
     FrameDescriptor m_frameDescriptor;
     pls::InterlockMode m_frameInterlockMode;
     pls::ShaderFeatures m_frameShaderFeaturesMask;
+    bool m_frameNeedsFullTessVertexSpans = false;
     RIVE_DEBUG_CODE(bool m_didBeginFrame = false;)
 
     // Clipping state.
     uint32_t m_clipContentID = 0;
+    uint64_t m_logicalFlushID = 0;
+    uint64_t m_lastLogicalFlushID = 0; // Generates unique IDs for m_logicalFlushID.
+
+    // Clipping state of the main render target's flush while it is suspended for an offscreen
+    // flush. (See beginOffscreenLogicalFlush().)
+    uint32_t m_suspendedClipContentID = 0;
+    uint64_t m_suspendedLogicalFlushID = 0;
+
+    // Damage tracking state for FrameDescriptor::retainedFrame.
+    struct DrawFingerprint
+    {
+        IAABB pixelBounds;
+        uint64_t contentHash;
+    };
+    std::vector<DrawFingerprint> m_lastFrameDrawFingerprints;
+    std::vector<DrawFingerprint> m_currentFrameDrawFingerprints;
+    bool m_lastFrameWasRetained = false;
+    const PLSRenderTarget* m_lastFrameRenderTarget = nullptr;
+    ColorInt m_lastFrameClearColor = 0;
+    pls::InterlockMode m_lastFrameInterlockMode = pls::InterlockMode::rasterOrdering;
 
     // Used by LogicalFlushes for re-ordering high level draws.
     std::vector<int64_t> m_indirectDrawList;
@@ -332,6 +495,15 @@ private:
     // Complex gradients get rendered by the GPU.
     WriteOnlyMappedMemory<pls::GradientSpan> m_gradSpanData;
     WriteOnlyMappedMemory<pls::TessVertexSpan> m_tessSpanData;
+    // Maps the same buffer as m_tessSpanData when frameUsesCompactTessVertexSpans().
+    WriteOnlyMappedMemory<pls::TessVertexSpanCompact> m_tessSpanCompactData;
+
+    // Number of span instances written to the tessellation span buffer so far, in whichever
+    // encoding is active.
+    size_t tessSpanElementsWritten() const
+    {
+        return m_tessSpanData.elementsWritten() + m_tessSpanCompactData.elementsWritten();
+    }
     WriteOnlyMappedMemory<pls::TriangleVertex> m_triangleVertexData;
     WriteOnlyMappedMemory<pls::ImageDrawUniforms> m_imageDrawUniformData;
 
@@ -409,6 +581,36 @@ private:
         // Mark the given clip as being read from within a screen-space bounding box.
         void addClipReadBounds(uint32_t clipID, const IAABB& bounds);
 
+        // Returns true if no clip generated after the given clipID intersects its content bounds.
+        bool isClipContentIntact(uint32_t clipID) const;
+
+        // Directs this flush into an offscreen render target instead of the frame's main one.
+        void setOffscreenRenderTarget(rcp<PLSRenderTarget> renderTarget)
+        {
+            m_offscreenRenderTarget = std::move(renderTarget);
+        }
+        const PLSRenderTarget* offscreenRenderTarget() const
+        {
+            return m_offscreenRenderTarget.get();
+        }
+
+        // Appends a fingerprint of each draw in this flush to the given list, in order.
+        // Returns false if any draw in the flush is not content hashable.
+        bool appendDrawFingerprints(std::vector<DrawFingerprint>*) const;
+
+        // Drops every draw that doesn't intersect damageBounds, clips the remaining draws to
+        // damageBounds, and prepends an opaque rectangle that clears damageBounds to clearColor.
+        // The flush then preserves the renderTarget instead of clearing it.
+        //
+        // Returns false without modifying the flush if the draws can't be clipped to damageBounds,
+        // at which point the caller must render the entire frame.
+        [[nodiscard]] bool redrawDamageRegionOnly(const IAABB& damageBounds, ColorInt clearColor);
+
+        // Drops every draw that is completely covered by a later opaque, unclipped, srcOver
+        // rectangle. (e.g., content underneath a full-screen background.) Clip updates are never
+        // dropped because later draws may depend on them.
+        void cullOccludedDraws();
+
         // Appends a list of high-level PLSDraws to the flush.
         // Returns false if the draws don't fit within the current resource constraints, at which
         // point the context must append a new logical flush and try again.
@@ -472,8 +674,12 @@ private:
         // Carves out space for this specific flush within the total frame's resource buffers and
         // lays out the flush-specific resource textures. Updates the total frame running conters
         // based on layout.
+        //
+        // 'isFirstFlushToMainRenderTarget' is true if no prior logical flush in the frame has drawn
+        // to the main render target (i.e., this flush is responsible for the frame's loadAction).
         void layoutResources(const FlushResources&,
                              size_t logicalFlushIdx,
+                             bool isFirstFlushToMainRenderTarget,
                              bool isFinalFlushOfFrame,
                              ResourceCounters* runningFrameResourceCounts,
                              LayoutCounters* runningFrameLayoutCounts);
@@ -517,6 +723,10 @@ private:
         // pushPath() and pushPaint().
         void pushInteriorTriangulation(InteriorTriangulationDraw*);
 
+        // Pushes a path record and a single quad for an analytic rect, rounded rect, or ellipse.
+        // (Analytic shapes don't have contours or tessellation.)
+        void pushAnalyticShape(AnalyticShapeDraw*);
+
         // Pushes an imageRect to the draw list.
         // This should only be used when we don't have bindless textures in atomic mode. Otherwise,
         // images should be drawn as rectangular paths with an image paint.
@@ -533,6 +743,10 @@ private:
     private:
         ClipInfo& getWritableClipInfo(uint32_t clipID);
 
+        // Writes the paint records for a path, or finds identical ones that have already been
+        // written during this flush, and returns their paintID.
+        uint32_t pushPaint(const PLSPathDraw*);
+
         // Writes padding vertices to the tessellation texture, with an invalid contour ID that is
         // guaranteed to not be the same ID as any neighbors.
         void pushPaddingVertices(uint32_t tessLocation, uint32_t count);
@@ -569,6 +783,19 @@ private:
             uint32_t joinSegmentCount,
             uint32_t contourIDWithFlags);
 
+        // Equivalent to pushTessellationSpans() or pushMirroredTessellationSpans(), but writes
+        // pls::TessVertexSpanCompact instances. (frameUsesCompactTessVertexSpans().)
+        // 'origin' must be the midpoint of the contour the span belongs to, or zero for padding.
+        RIVE_ALWAYS_INLINE void pushCompactTessellationSpans(const Vec2D pts[4],
+                                                             Vec2D origin,
+                                                             Vec2D joinTangent,
+                                                             uint32_t paddingVertexCount,
+                                                             uint32_t parametricSegmentCount,
+                                                             uint32_t polarSegmentCount,
+                                                             uint32_t joinSegmentCount,
+                                                             uint32_t contourIDWithFlags,
+                                                             bool mirrored);
+
         // Either appends a new drawBatch to m_drawList or merges into m_drawList.tail().
         // Updates the batch's ShaderFeatures according to the passed parameters.
         DrawBatch& pushPathDraw(PLSPathDraw*, DrawType, uint32_t vertexCount, uint32_t baseVertex);
@@ -596,12 +823,17 @@ private:
             m_complexGradients; // [colors[0..n], stops[0..n]] -> rowIdx
         std::vector<const PLSGradient*> m_pendingComplexColorRampDraws;
 
+        // Paint records already written during this flush. [paintData, paintAuxData] -> paintID
+        std::unordered_map<PaintRecordKey, uint32_t, HashPaintRecord> m_paintIDs;
+
         std::vector<ClipInfo> m_clips;
 
         // High-level draw list. These get built into a low-level list of pls::DrawBatch objects
         // during writeResources().
         std::vector<PLSDrawUniquePtr> m_plsDraws;
         IAABB m_combinedDrawBounds;
+        bool m_redrawsDamageRegionOnly;
+        rcp<PLSRenderTarget> m_offscreenRenderTarget; // Null if drawing to the main target.
 
         // Layout state.
         uint32_t m_pathPaddingCount;
@@ -622,9 +854,11 @@ private:
         // Most recent path and contour state.
         bool m_currentPathIsStroked;
         pls::ContourDirections m_currentPathContourDirections;
+        uint32_t m_currentPathParametricPrecisionBits; // Or'd into the pathID word of ContourData.
         uint32_t m_currentPathID;
         uint32_t m_currentContourID;
         uint32_t m_currentContourPaddingVertexCount; // Padding to add to the first curve.
+        Vec2D m_currentContourMidpoint; // Origin of compact tessellation spans.
         uint32_t m_pathTessLocation;
         uint32_t m_pathMirroredTessLocation; // Used for back-face culling and mirrored patches.
         RIVE_DEBUG_CODE(uint32_t m_expectedPathTessLocationAtEndOfPath;)
@@ -6,6 +6,7 @@
 
 #include "rive/pls/pls_render_context_impl.hpp"
 #include "rive/pls/buffer_ring.hpp"
+#include "rive/pls/pls_image.hpp"
 #include <chrono>
 
 namespace rive::pls
@@ -15,6 +16,7 @@ class PLSRenderContextHelperImpl : public PLSRenderContextImpl
 {
 public:
     rcp<PLSTexture> decodeImageTexture(Span<const uint8_t> encodedBytes) override;
+    rcp<PLSImage> decodeImage(Span<const uint8_t> encodedBytes) override;
 
     void resizeFlushUniformBuffer(size_t sizeInBytes) override;
     void resizeImageDrawUniformBuffer(size_t sizeInBytes) override;
@@ -40,14 +42,14 @@ public:
 
     void unmapFlushUniformBuffer() override;
     void unmapImageDrawUniformBuffer() override;
-    void unmapPathBuffer() override;
-    void unmapPaintBuffer() override;
-    void unmapPaintAuxBuffer() override;
-    void unmapContourBuffer() override;
-    void unmapSimpleColorRampsBuffer() override;
-    void unmapGradSpanBuffer() override;
-    void unmapTessVertexSpanBuffer() override;
-    void unmapTriangleVertexBuffer() override;
+    void unmapPathBuffer(size_t bytesWritten) override;
+    void unmapPaintBuffer(size_t bytesWritten) override;
+    void unmapPaintAuxBuffer(size_t bytesWritten) override;
+    void unmapContourBuffer(size_t bytesWritten) override;
+    void unmapSimpleColorRampsBuffer(size_t bytesWritten) override;
+    void unmapGradSpanBuffer(size_t bytesWritten) override;
+    void unmapTessVertexSpanBuffer(size_t bytesWritten) override;
+    void unmapTriangleVertexBuffer(size_t bytesWritten) override;
 
     double secondsNow() const override
     {
@@ -72,6 +74,33 @@ protected:
                                              uint32_t mipLevelCount,
                                              const uint8_t imageDataRGBA[]) = 0;
 
+    // Creates a texture directly from block-compressed data and its own mip chain. Returns null if
+    // the backend can't sample the image's format, in which case it gets decoded to RGBA on the
+    // CPU instead.
+    virtual rcp<PLSTexture> makeCompressedImageTexture(const CompressedImage&) { return nullptr; }
+
+    // Pack images no larger than PLSImageAtlasPage::kMaxImageSize into shared atlas textures, so
+    // draws of different small images can be batched together. (Set by the backend.) Backends that
+    // enable this must also implement makeImageAtlasTexture() and updateImageAtlasTexture().
+    bool m_imageAtlasEnabled = false;
+
+    // Creates a square RGBA8 texture with the given size and mip level count, and undefined
+    // contents.
+    virtual rcp<PLSTexture> makeImageAtlasTexture(uint32_t size, uint32_t mipLevelCount)
+    {
+        RIVE_UNREACHABLE();
+    }
+
+    // Overwrites 'region' of the given mip level of a texture from makeImageAtlasTexture(). The
+    // rows of 'regionDataRGBA' are tightly packed.
+    virtual void updateImageAtlasTexture(PLSTexture*,
+                                         uint32_t mipLevel,
+                                         const IAABB& region,
+                                         const uint8_t regionDataRGBA[])
+    {
+        RIVE_UNREACHABLE();
+    }
+
     virtual std::unique_ptr<BufferRing> makeUniformBufferRing(size_t capacityInBytes) = 0;
     virtual std::unique_ptr<BufferRing> makeStorageBufferRing(size_t capacityInBytes,
                                                               pls::StorageBufferStructure) = 0;
@@ -79,6 +108,15 @@ protected:
     virtual std::unique_ptr<BufferRing> makeTextureTransferBufferRing(size_t capacityInBytes) = 0;
 
 private:
+    friend class PLSImageAtlasPage; // For makeImageAtlasTexture() and updateImageAtlasTexture().
+
+    // Creates a texture from a KTX2 container, or returns null if it is malformed or unsupported.
+    rcp<PLSTexture> decodeKTX2Texture(Span<const uint8_t> encodedBytes);
+
+    // The atlas page that newly decoded small images get packed into. Like the rest of this class,
+    // only accessed from the thread that owns the render context.
+    rcp<PLSImageAtlasPage> m_imageAtlasPage;
+
     std::unique_ptr<BufferRing> m_flushUniformBuffer;
     std::unique_ptr<BufferRing> m_imageDrawUniformBuffer;
     std::unique_ptr<BufferRing> m_pathBuffer;
@@ -8,6 +8,7 @@
 
 namespace rive::pls
 {
+class PLSImage;
 class PLSTexture;
 
 // This class manages GPU buffers and isues the actual rendering commands from PLSRenderContext.
@@ -24,6 +25,26 @@ public:
     // image paint.
     virtual rcp<PLSTexture> decodeImageTexture(Span<const uint8_t> encodedBytes) = 0;
 
+    // Decodes the image bytes into a PLSImage for PLSRenderer. Unlike decodeImageTexture(), small
+    // images may be packed into a shared atlas texture instead of getting their own.
+    virtual rcp<PLSImage> decodeImage(Span<const uint8_t> encodedBytes) = 0;
+
+    // Creates a render target that PLSRenderContext can draw into during a logical flush, along
+    // with a texture that samples its contents. (See PLSRenderContext::OffscreenTarget.)
+    // Returns false if the backend does not support offscreen rendering.
+    virtual bool makeOffscreenTarget(uint32_t width,
+                                     uint32_t height,
+                                     PLSRenderContext::OffscreenTarget*)
+    {
+        return false;
+    }
+
+    // Compiles (or begins compiling) the given draw shaders ahead of time. The variants have
+    // already been filtered to interlock modes supported by m_platformFeatures, but backends
+    // should also skip any draw types they never use. The default implementation does nothing, in
+    // which case shaders are compiled lazily at flush time.
+    virtual void precompileShaders(const std::vector<pls::ShaderVariant>&) {}
+
     // Resize GPU buffers. These methods cannot fail, and must allocate the exact size requested.
     //
     // PLSRenderContext takes care to minimize how often these methods are called, while also
@@ -60,17 +81,19 @@ public:
     virtual void* mapTessVertexSpanBuffer(size_t mapSizeInBytes) = 0;
     virtual void* mapTriangleVertexBuffer(size_t mapSizeInBytes) = 0;
 
-    // Unmap GPU buffers. All buffers will be unmapped before flush().
+    // Unmap GPU buffers. All buffers will be unmapped before flush(). 'bytesWritten' is the number
+    // of bytes, from the beginning of the mapping, that PLSRenderContext actually wrote. (This may
+    // be much smaller than the mapped size, which tracks the high-water mark.)
     virtual void unmapFlushUniformBuffer() = 0;
     virtual void unmapImageDrawUniformBuffer() = 0;
-    virtual void unmapPathBuffer() = 0;
-    virtual void unmapPaintBuffer() = 0;
-    virtual void unmapPaintAuxBuffer() = 0;
-    virtual void unmapContourBuffer() = 0;
-    virtual void unmapSimpleColorRampsBuffer() = 0;
-    virtual void unmapGradSpanBuffer() = 0;
-    virtual void unmapTessVertexSpanBuffer() = 0;
-    virtual void unmapTriangleVertexBuffer() = 0;
+    virtual void unmapPathBuffer(size_t bytesWritten) = 0;
+    virtual void unmapPaintBuffer(size_t bytesWritten) = 0;
+    virtual void unmapPaintAuxBuffer(size_t bytesWritten) = 0;
+    virtual void unmapContourBuffer(size_t bytesWritten) = 0;
+    virtual void unmapSimpleColorRampsBuffer(size_t bytesWritten) = 0;
+    virtual void unmapGradSpanBuffer(size_t bytesWritten) = 0;
+    virtual void unmapTessVertexSpanBuffer(size_t bytesWritten) = 0;
+    virtual void unmapTriangleVertexBuffer(size_t bytesWritten) = 0;
 
     // Allocate textures that the implementation is responsible to update during flush().
     virtual void resizeGradientTexture(uint32_t width, uint32_t height) = 0;
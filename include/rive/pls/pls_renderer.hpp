@@ -9,6 +9,7 @@
 #include "rive/pls/pls.hpp"
 #include "rive/pls/pls_draw.hpp"
 #include "rive/pls/pls_render_context.hpp"
+#include <unordered_map>
 #include <vector>
 
 namespace rive
@@ -33,6 +34,15 @@ public:
     void restore() override;
     void transform(const Mat2D& matrix) override;
     void drawPath(RenderPath*, RenderPaint*) override;
+    // Draws a path whose approximate device-space size (the larger of its width and height, in
+    // pixels, including stroke thickness) is already known to the caller. The hint is used for
+    // level-of-detail culling in place of the path's mapped bounds. (See
+    // PLSRenderContext::FrameDescriptor::lodMinPixelSize.)
+    void drawPath(RenderPath*, RenderPaint*, float pixelSizeHint);
+    // Also scales PLSRenderContext::FrameDescriptor::tessellationQuality for this draw only (e.g.,
+    // < 1 for a path that is moving quickly or sits under a blur). Pass a negative pixelSizeHint
+    // if the path's size isn't known.
+    void drawPath(RenderPath*, RenderPaint*, float pixelSizeHint, float tessellationQuality);
     void clipPath(RenderPath*) override;
     void drawImage(const RenderImage*, BlendMode, float opacity) override;
     void drawImageMesh(const RenderImage*,
@@ -47,6 +57,57 @@ public:
     // Determines if a path is an axis-aligned rectangle that can be represented by rive::AABB.
     static bool IsAABB(const RawPath&, AABB* result);
 
+    // Opt-in: caches the coverage of top-level clip elements at two levels.
+    //
+    //  * Within a logical flush: if the clip stack returns to an element that is still intact in
+    //    the clip buffer (no other clip has been drawn over its coverage), that coverage is reused
+    //    instead of being re-rendered. Only in rasterOrdering mode, where the clip buffer can hold
+    //    multiple disjoint clips at once and draws are not reordered.
+    //
+    //  * Across frames: once an element has been used for kClipMaskStableFrameCount consecutive
+    //    frames, its coverage is rendered once into an offscreen mask texture. From then on, the
+    //    clip buffer is updated from the mask with a single textured rect instead of re-rendering
+    //    the clip path. (e.g., rounded viewports and masked scrolling lists.) A mask is discarded
+    //    when its path mutates or its matrix changes. Only takes effect if the backend supports
+    //    offscreen rendering, the frame can draw image paints on paths, and the frame is not in
+    //    depthStencil mode (where stencil clips can't take fractional coverage from a texture).
+    //
+    // (path_fiddle enables this with --clip_cache.)
+    void enableClipCache(bool enabled)
+    {
+        m_clipCacheEnabled = enabled;
+        m_cachedClips.clear();
+        m_clipMasks.clear();
+    }
+
+    // Raster cache: marks a group of draws (e.g., a subtree of the scene) that might not change
+    // from frame to frame. The group is fingerprinted by its paths, paints, and transforms relative
+    // to the current matrix at beginCacheableGroup(). Once an identical group has been drawn for
+    // kRasterCacheStableFrameCount consecutive frames, it is rendered once into an offscreen
+    // texture and then drawn as a single image, until its contents change or the current matrix
+    // scales, rotates, or skews beyond kRasterCacheScaleTolerance.
+    //
+    // Groups that clip, draw image meshes, or use blend modes other than srcOver are always drawn
+    // directly. Nested groups are ignored (only the outermost group is cached). Only takes effect
+    // if the backend supports offscreen rendering.
+    void beginCacheableGroup();
+    void endCacheableGroup();
+
+    // Opt-in: finds cacheable groups without beginCacheableGroup() markup. Every save()/restore()
+    // block (e.g., an artboard, nested artboard, or clipped drawable) is fingerprinted the same way
+    // as an explicit group, and identified by its position in the frame's tree of save() calls.
+    // Once a block has drawn an identical fingerprint for kAutomaticGroupStableFrameCount
+    // consecutive frames, it gets recorded as a cacheable group on subsequent frames, from which
+    // point the raster cache takes over. Blocks with the same restrictions as explicit groups, or
+    // with fewer than two draws, are never recorded.
+    //
+    // (path_fiddle enables this with --raster_cache.)
+    void enableAutomaticCacheableGroups(bool enabled)
+    {
+        m_automaticGroupsEnabled = enabled;
+        m_automaticGroupHistory.clear();
+    }
+
 #ifdef TESTING
     bool hasClipRect() const { return m_stack.back().clipRectInverseMatrix != nullptr; }
     const AABB& getClipRect() const { return m_stack.back().clipRect; }
@@ -54,6 +115,12 @@ public:
 #endif
 
 private:
+    void drawPathImpl(PLSPath*, PLSPaint*, float pixelSizeHint);
+
+    // Returns true if a draw with the given device-space size should be skipped because it's too
+    // small to matter. (See PLSRenderContext::FrameDescriptor::lodMinPixelSize.)
+    bool isBelowLODThreshold(const PLSPath*, const PLSPaint*, float pixelSizeHint) const;
+
     void clipRectImpl(AABB, const PLSPath* originalPath);
     void clipPathImpl(const PLSPath*);
 
@@ -92,14 +159,162 @@ private:
         rcp<const PLSPath> path;
         FillRule fillRule; // Bc PLSPath fillRule can mutate during the artboard draw process.
         uint32_t clipID;
+        uint64_t clipMaskFrameNumber; // Last frame that updateClipMask() accounted for this clip.
     };
     std::vector<ClipElement> m_clipStack;
 
+    // Returns true and assigns clip->clipID if an equivalent top-level clip is still intact in the
+    // clip buffer. (See enableClipCache().)
+    bool findCachedClip(ClipElement* clip);
+    void cacheClip(const ClipElement&);
+
+    // Top-level clip elements that have been rendered to the clip buffer during the logical flush
+    // identified by m_cachedClipsLogicalFlushID.
+    constexpr static size_t kMaxCachedClips = 16;
+    bool m_clipCacheEnabled = false;
+    std::vector<ClipElement> m_cachedClips;
+    uint64_t m_cachedClipsLogicalFlushID = 0;
+
+    // Retained clip masks. (See enableClipCache().)
+    constexpr static uint32_t kClipMaskStableFrameCount = 2;
+    constexpr static uint32_t kClipMaskMaxIdleFrames = 4;
+    constexpr static size_t kMaxClipMasks = 8;
+    constexpr static int32_t kClipMaskMaxDimension = 2048;
+
+    struct ClipMask
+    {
+        ClipElement clip;
+        IAABB pixelBounds; // Region of the render target that 'target' covers.
+        uint64_t lastFrameNumber;
+        uint32_t consecutiveFrameCount;
+        PLSRenderContext::OffscreenTarget target; // Null until the clip has been stable.
+    };
+    std::vector<ClipMask> m_clipMasks;
+    uint64_t m_clipMasksFrameNumber = 0;
+    bool m_clipMasksUnsupported = false;
+
+    bool frameSupportsClipMasks() const;
+
+    // Tracks the current top-level clip element across frames, and renders its mask once it has
+    // been stable. Rendering a mask issues logical flushes, so this must be called before building
+    // a draw batch.
+    void updateClipMask();
+
+    // Renders mask->clip's coverage into mask->target. Returns false if it could not be rendered.
+    bool renderClipMask(ClipMask*);
+
+    // Returns a mask for the given top-level clip element that has been rendered and validated
+    // this frame, or null.
+    const ClipMask* findClipMask(const ClipElement&) const;
+
+    // Raster cache state. (See beginCacheableGroup().)
+    constexpr static uint32_t kRasterCacheStableFrameCount = 3;
+    constexpr static uint32_t kRasterCacheMaxIdleFrames = 4;
+    constexpr static size_t kRasterCacheMaxEntries = 32;
+    constexpr static float kRasterCacheMaxDimension = 2048;
+    constexpr static float kRasterCacheScaleTolerance = 1.f / 128;
+
+    struct RasterCacheEntry
+    {
+        uint64_t fingerprint;
+        uint64_t lastFrameNumber;
+        uint32_t consecutiveFrameCount;
+        Mat2D lastGroupMatrix; // Group matrix the last time this entry was drawn.
+        Mat2D groupMatrix;     // Group matrix when 'target' was rendered.
+        Mat2D groupInverseMatrix;
+        IAABB pixelBounds; // Region of the render target that 'target' covers, under groupMatrix.
+        PLSRenderContext::OffscreenTarget target; // Null until the group has been stable.
+    };
+    std::vector<RasterCacheEntry> m_rasterCache;
+    uint64_t m_rasterCacheFrameNumber = 0;
+    bool m_rasterCacheUnsupported = false;
+
+    // Draws that are deferred while recording a cacheable group.
+    struct CacheableGroupDraw
+    {
+        rcp<const PLSPath> path;
+        FillRule fillRule;
+        Mat2D matrix;
+        rcp<PLSPaint> paint; // Snapshot of the paint, recycled from m_cacheableGroupPaints.
+    };
+
+    // Appends a draw to the cacheable group that is currently recording.
+    // Returns false if the draw can't be cached, at which point the group has been abandoned and
+    // the caller must draw the path directly.
+    [[nodiscard]] bool recordCacheableGroupDraw(const PLSPath*, const PLSPaint*);
+
+    // Stops recording the current cacheable group and draws everything it has recorded so far.
+    // Subsequent draws in the group are drawn directly.
+    void abandonCacheableGroup();
+
+    // Draws every recorded draw in the cacheable group directly to the current render target.
+    void drawCacheableGroupDirectly();
+
+    // Renders the recorded group into entry->target. Returns false if it could not be rendered.
+    bool renderRasterCacheEntry(RasterCacheEntry*);
+
+    // Draws entry.target as an image under the current matrix, compensating for any difference
+    // between entry.groupMatrix and the current group matrix.
+    void drawRasterCacheEntry(const RasterCacheEntry&);
+
+    // Automatic cacheable group state. (See enableAutomaticCacheableGroups().)
+    constexpr static uint32_t kAutomaticGroupStableFrameCount = 2;
+    constexpr static uint32_t kAutomaticGroupMaxIdleFrames = 4;
+
+    // A save()/restore() block that is currently open.
+    struct AutomaticGroupCandidate
+    {
+        size_t stackHeight;      // m_stack.size() inside the block.
+        uint64_t key;            // Identifies the block by its position in the save() tree.
+        uint32_t childCount = 0; // Blocks opened directly inside this one so far.
+        uint32_t drawCount = 0;
+        uint64_t fingerprint = pls::kFNVOffsetBasis;
+        Mat2D matrix; // Current matrix when the block was opened.
+        Mat2D inverseMatrix;
+        bool isCacheable;
+        bool isRecording = false; // Did this block call beginCacheableGroup()?
+    };
+
+    // How a block identified by its key has drawn in recent frames.
+    struct AutomaticGroupHistory
+    {
+        uint64_t fingerprint;
+        Mat2D matrix;
+        uint64_t lastFrameNumber;
+        uint32_t consecutiveFrameCount;
+    };
+
+    void beginAutomaticGroupCandidate();
+    void endAutomaticGroupCandidate();
+
+    // Folds a draw into the fingerprint of every open candidate.
+    void fingerprintAutomaticGroupCandidates(const PLSPath*, const PLSPaint*);
+
+    // Marks every open candidate as uncacheable (e.g., because of a clip or image mesh).
+    void invalidateAutomaticGroupCandidates();
+
+    bool m_automaticGroupsEnabled = false;
+    std::vector<AutomaticGroupCandidate> m_automaticGroupCandidates;
+    std::unordered_map<uint64_t, AutomaticGroupHistory> m_automaticGroupHistory;
+    uint64_t m_automaticGroupFrameNumber = 0;
+    uint32_t m_automaticGroupRootChildCount = 0; // Top-level blocks opened so far this frame.
+
+    int m_cacheableGroupDepth = 0;
+    bool m_isRecordingCacheableGroup = false;
+    size_t m_cacheableGroupStackHeight;
+    Mat2D m_cacheableGroupMatrix;
+    Mat2D m_cacheableGroupInverseMatrix;
+    uint64_t m_cacheableGroupFingerprint;
+    AABB m_cacheableGroupBounds;
+    std::vector<CacheableGroupDraw> m_cacheableGroupDraws;
+    std::vector<rcp<PLSPaint>> m_cacheableGroupPaints;
+
     PLSRenderContext* const m_context;
 
     std::vector<PLSDrawUniquePtr> m_internalDrawBatch;
 
     // Path of the rectangle [0, 0, 1, 1]. Used to draw images.
+    PLSPath* unitRectPath();
     rcp<PLSPath> m_unitRectPath;
 
     // Used to build coarse path interiors for the "interior triangulation" algorithm.
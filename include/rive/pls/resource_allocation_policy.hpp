@@ -0,0 +1,144 @@
+/*
+ * Copyright 2024 Rive
+ */
+
+#pragma once
+
+#include "rive/math/simd.hpp"
+#include "rive/pls/pls.hpp"
+#include <string>
+
+namespace rive::pls
+{
+// Defines the exact size of each of PLSRenderContext's GPU resources. Computed during flush(),
+// based on LogicalFlush::ResourceCounters and LogicalFlush::LayoutCounters.
+struct ResourceAllocationCounts
+{
+    constexpr static size_t kCount = 12;
+    using VecType = simd::gvec<size_t, kCount>;
+
+    RIVE_ALWAYS_INLINE VecType toVec() const
+    {
+        static_assert(sizeof(VecType) >= sizeof(ResourceAllocationCounts));
+        VecType vec;
+        RIVE_INLINE_MEMCPY(&vec, this, sizeof(*this));
+        return vec;
+    }
+
+    RIVE_ALWAYS_INLINE ResourceAllocationCounts(const VecType& vec)
+    {
+        static_assert(sizeof(VecType) >= sizeof(ResourceAllocationCounts));
+        RIVE_INLINE_MEMCPY(this, &vec, sizeof(*this));
+    }
+
+    ResourceAllocationCounts() = default;
+
+    // Size in bytes of a single unit of each count (e.g., one PathData in each buffer of the ring,
+    // or one row of the gradient texture), in the same order as the fields. The tessellation span
+    // unit depends on PlatformFeatures::compactTessVertexSpans.
+    static VecType UnitSizesInBytes(const PlatformFeatures&);
+
+    // Total GPU memory required to allocate these counts.
+    size_t totalSizeInBytes(const PlatformFeatures&) const;
+
+    size_t flushUniformBufferCount = 0;
+    size_t imageDrawUniformBufferCount = 0;
+    size_t pathBufferCount = 0;
+    size_t paintBufferCount = 0;
+    size_t paintAuxBufferCount = 0;
+    size_t contourBufferCount = 0;
+    size_t simpleGradientBufferCount = 0;
+    size_t complexGradSpanBufferCount = 0;
+    size_t tessSpanBufferCount = 0; // TessVertexSpans, or TessVertexSpanCompacts if compact.
+    size_t triangleVertexBufferCount = 0;
+    size_t gradTextureHeight = 0;
+    size_t tessTextureHeight = 0;
+};
+
+// Reads and writes ResourceAllocationCounts in a simple text format, so the peak requirements
+// observed for a piece of content (PLSRenderContext::peakResourceRequirements()) can be saved and
+// passed to PLSRenderContext::reserve() on a later run. Fields missing from the text are left at
+// zero. ParseResourceAllocationCounts() returns false if the text is malformed or was written by an
+// incompatible version of the renderer. (Counts should also be reused with the same
+// PlatformFeatures they were observed with, since tessSpanBufferCount's unit depends on them.)
+std::string WriteResourceAllocationCounts(const ResourceAllocationCounts&);
+bool ParseResourceAllocationCounts(const char* text, ResourceAllocationCounts*);
+
+// Decides how large PLSRenderContext's GPU resources should be, given the requirements of each
+// frame. Reallocating a resource is expensive, so policies trade memory for stability.
+class ResourceAllocationPolicy
+{
+public:
+    virtual ~ResourceAllocationPolicy() {}
+
+    // Called once per frame with the minimum counts that can service it ('required') and the
+    // current allocation ('current'). Returns the counts to allocate for the frame, which must be
+    // at least 'required' in every field. 'platformFeatures' determines the unit sizes of the
+    // counts. (See ResourceAllocationCounts::UnitSizesInBytes().)
+    virtual ResourceAllocationCounts computeAllocations(const ResourceAllocationCounts& required,
+                                                        const ResourceAllocationCounts& current,
+                                                        const PlatformFeatures& platformFeatures,
+                                                        double secondsNow) = 0;
+
+    // Called by PLSRenderContext::reserve(). Policies should avoid trimming resources below
+    // reserved counts until the next reset().
+    virtual void reserve(const ResourceAllocationCounts&) {}
+
+    // Called when the context releases all of its resources. Also forgets any reservations.
+    virtual void reset(double secondsNow) {}
+};
+
+// The default policy: when a frame doesn't fit, grow to 125% of its requirements, and every 5
+// seconds trim resources to 125% of their recent peak usage if that usage is 2/3 or less of the
+// current allocation.
+class DefaultResourceAllocationPolicy : public ResourceAllocationPolicy
+{
+public:
+    struct Options
+    {
+        // How much to overallocate when a frame's requirements don't fit.
+        double growthFactor = 1.25;
+
+        // How often to trim resources back toward recent peak usage, and how underutilized a
+        // resource has to be in order to get trimmed.
+        double trimIntervalInSeconds = 5;
+        double trimUtilizationThreshold = 2. / 3.;
+
+        // Never trim resources. Avoids reallocations when content alternates between heavy and
+        // light scenes, at the cost of holding on to peak memory.
+        bool neverShrink = false;
+
+        // Never allocate less than these counts. (Unlike reserve(), this floor survives reset().)
+        ResourceAllocationCounts minimumAllocations;
+
+        // If nonzero, the slack allocated beyond each frame's requirements is limited so the total
+        // GPU memory stays within this budget. A frame whose requirements alone exceed the budget
+        // still gets what it requires.
+        size_t memoryBudgetInBytes = 0;
+    };
+
+    DefaultResourceAllocationPolicy() = default;
+    DefaultResourceAllocationPolicy(const Options& options) : m_options(options) {}
+
+    const Options& options() const { return m_options; }
+    Options& options() { return m_options; }
+
+    ResourceAllocationCounts computeAllocations(const ResourceAllocationCounts& required,
+                                                const ResourceAllocationCounts& current,
+                                                const PlatformFeatures&,
+                                                double secondsNow) override;
+
+    // Never allocates less than the reserved counts, until the next reset(). Reservations are
+    // tracked separately from Options::minimumAllocations, which they don't modify.
+    void reserve(const ResourceAllocationCounts&) override;
+    const ResourceAllocationCounts& reservedCounts() const { return m_reservedCounts; }
+
+    void reset(double secondsNow) override;
+
+private:
+    Options m_options;
+    ResourceAllocationCounts m_reservedCounts;
+    ResourceAllocationCounts m_maxRecentResourceRequirements;
+    double m_lastResourceTrimTimeInSeconds = 0;
+};
+} // namespace rive::pls
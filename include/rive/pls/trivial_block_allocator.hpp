@@ -12,32 +12,84 @@
 namespace rive
 {
 // Fast block allocator for trivially-destructible types.
+//
+// Blocks beyond the first one are retained across reset(), and only freed once they have gone
+// unused for 'blockRetentionFrames' consecutive resets. This keeps content that consistently spills
+// past the initial block from re-mallocing the same blocks every frame, while still letting memory
+// decay after a one-off spike.
 class TrivialBlockAllocator
 {
 public:
-    TrivialBlockAllocator(size_t initialBlockSize) : m_initialBlockSize(initialBlockSize)
+    constexpr static uint32_t kDefaultBlockRetentionFrames = 120;
+
+    TrivialBlockAllocator(size_t initialBlockSize,
+                          uint32_t blockRetentionFrames = kDefaultBlockRetentionFrames) :
+        m_initialBlockSize(initialBlockSize), m_blockRetentionFrames(blockRetentionFrames)
+    {
+        pushBlock(m_initialBlockSize);
+    }
+
+    struct Stats
+    {
+        size_t peakBytes = 0;      // Most bytes allocated in any one frame.
+        size_t lastFrameBytes = 0; // Bytes allocated before the most recent reset().
+        size_t blockCount = 0;     // Blocks currently held, including retained ones.
+        size_t retainedBytes = 0;  // Total size of all blocks currently held.
+        size_t lastFrameMallocs = 0;
+        size_t totalMallocs = 0;
+    };
+
+    Stats stats() const
     {
-        m_blocks.push_back(std::unique_ptr<char[]>(new char[m_initialBlockSize]));
-        reset();
+        Stats stats = m_stats;
+        stats.blockCount = m_blocks.size();
+        stats.retainedBytes = 0;
+        for (const Block& block : m_blocks)
+        {
+            stats.retainedBytes += block.size;
+        }
+        return stats;
     }
 
     void reset()
     {
+        // Blocks are always used in order, so the unused ones are a suffix of m_blocks.
+        for (size_t i = 0; i < m_blocks.size(); ++i)
+        {
+            m_blocks[i].framesUnused = i <= m_currentBlockIdx ? 0 : m_blocks[i].framesUnused + 1;
+        }
+        while (m_blocks.size() > 1 && m_blocks.back().framesUnused > m_blockRetentionFrames)
+        {
+            m_blocks.pop_back();
+        }
+
+        m_stats.lastFrameBytes = m_bytesInPreviousBlocks + m_currentBlockUsage;
+        m_stats.peakBytes = std::max(m_stats.peakBytes, m_stats.lastFrameBytes);
+        m_stats.lastFrameMallocs = m_mallocsThisFrame;
+        m_mallocsThisFrame = 0;
+
         m_fibMinus2 = 0;
         m_fibMinus1 = 1;
-        m_blocks.resize(1);
-        m_currentBlockSize = m_initialBlockSize;
+        m_currentBlockIdx = 0;
+        m_bytesInPreviousBlocks = 0;
         m_currentBlockUsage = 0;
     }
 
+    // Frees every block the current frame isn't using, regardless of the retention policy.
+    void releaseRetainedBlocks()
+    {
+        m_blocks.resize(m_currentBlockIdx + 1);
+    }
+
     template <size_t AlignmentInBytes = 8> void* alloc(size_t sizeInBytes)
     {
-        uintptr_t start = reinterpret_cast<uintptr_t>(m_blocks.back().get()) + m_currentBlockUsage;
+        uintptr_t start =
+            reinterpret_cast<uintptr_t>(currentBlock().data.get()) + m_currentBlockUsage;
         size_t alignmentPad = math::round_up_to_multiple_of<AlignmentInBytes>(start) - start;
 
-        // Ensure there is room for this allocation in our newest block, pushing a new one if
-        // needed.
-        if (m_currentBlockUsage + alignmentPad + sizeInBytes > m_currentBlockSize)
+        // Ensure there is room for this allocation in our current block, moving on to the next
+        // (retained or newly malloc'd) block if needed.
+        if (m_currentBlockUsage + alignmentPad + sizeInBytes > currentBlock().size)
         {
             // Grow with a fibonacci function.
             size_t fib = m_fibMinus2 + m_fibMinus1;
@@ -46,18 +98,27 @@ public:
 
             size_t blockSize =
                 std::max(fib * m_initialBlockSize, sizeInBytes + AlignmentInBytes - 1);
-            m_blocks.push_back(std::unique_ptr<char[]>(new char[blockSize]));
-            m_currentBlockSize = blockSize;
+            m_bytesInPreviousBlocks += m_currentBlockUsage;
+            ++m_currentBlockIdx;
+            if (m_currentBlockIdx == m_blocks.size())
+            {
+                pushBlock(blockSize);
+            }
+            else if (currentBlock().size < blockSize)
+            {
+                // The retained block is too small for this allocation. Replace it.
+                m_blocks[m_currentBlockIdx] = makeBlock(blockSize);
+            }
             m_currentBlockUsage = 0;
 
-            start = reinterpret_cast<uintptr_t>(m_blocks.back().get());
+            start = reinterpret_cast<uintptr_t>(currentBlock().data.get());
             alignmentPad = math::round_up_to_multiple_of<AlignmentInBytes>(start) - start;
         }
 
-        char* ret = &m_blocks.back()[m_currentBlockUsage + alignmentPad];
+        char* ret = &currentBlock().data[m_currentBlockUsage + alignmentPad];
         m_currentBlockUsage += alignmentPad + sizeInBytes;
         assert((reinterpret_cast<uintptr_t>(ret) % AlignmentInBytes) == 0);
-        assert(ret + sizeInBytes <= m_blocks.back().get() + m_currentBlockSize);
+        assert(ret + sizeInBytes <= currentBlock().data.get() + currentBlock().size);
         return ret;
     }
 
@@ -76,15 +137,38 @@ public:
     }
 
 private:
+    struct Block
+    {
+        std::unique_ptr<char[]> data;
+        size_t size;
+        uint32_t framesUnused;
+    };
+
+    Block makeBlock(size_t size)
+    {
+        ++m_mallocsThisFrame;
+        ++m_stats.totalMallocs;
+        return {std::unique_ptr<char[]>(new char[size]), size, 0};
+    }
+
+    void pushBlock(size_t size) { m_blocks.push_back(makeBlock(size)); }
+
+    Block& currentBlock() { return m_blocks[m_currentBlockIdx]; }
+
     const size_t m_initialBlockSize;
+    const uint32_t m_blockRetentionFrames;
 
     // Grow block sizes using a fibonacci function.
-    size_t m_fibMinus2;
-    size_t m_fibMinus1;
+    size_t m_fibMinus2 = 0;
+    size_t m_fibMinus1 = 1;
+
+    std::vector<Block> m_blocks;
+    size_t m_currentBlockIdx = 0;
+    size_t m_bytesInPreviousBlocks = 0; // Bytes allocated this frame before the current block.
+    size_t m_currentBlockUsage = 0;
 
-    std::vector<std::unique_ptr<char[]>> m_blocks;
-    size_t m_currentBlockSize;
-    size_t m_currentBlockUsage;
+    size_t m_mallocsThisFrame = 0;
+    Stats m_stats;
 };
 
 // Basic array allocator for POD types, based on TrivialBlockAllocator.
@@ -106,7 +190,9 @@ public:
         TrivialBlockAllocator::rewindLastAllocation(rewindCount * sizeof(T));
     }
 
+    using TrivialBlockAllocator::releaseRetainedBlocks;
     using TrivialBlockAllocator::reset;
+    using TrivialBlockAllocator::stats;
 };
 
 // Simple linked list whose nodes are allocated on a TrivialBlockAllocator.
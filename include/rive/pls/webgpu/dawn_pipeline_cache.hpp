@@ -0,0 +1,49 @@
+/*
+ * Copyright 2024 Rive
+ */
+
+#pragma once
+
+#ifdef RIVE_DAWN
+
+#include <dawn/platform/DawnPlatform.h>
+#include <string>
+
+namespace rive::pls
+{
+// Dawn platform that persists Dawn's blob cache (compiled shaders and pipelines) to a directory, so
+// warm starts don't have to recreate every draw pipeline from scratch. Pass it to the Dawn instance
+// via DawnInstanceDescriptor::platform. It must outlive every device created from that instance.
+class DawnPipelineCache : public dawn::platform::Platform
+{
+public:
+    // 'directory' must already exist.
+    explicit DawnPipelineCache(const char* directory) : m_cachingInterface(directory) {}
+
+    dawn::platform::CachingInterface* GetCachingInterface() override { return &m_cachingInterface; }
+
+private:
+    // Stores each blob in its own file, named by a hash of its key. The full key is saved alongside
+    // the blob so hash collisions read as misses.
+    class FileCachingInterface : public dawn::platform::CachingInterface
+    {
+    public:
+        explicit FileCachingInterface(const char* directory) : m_directory(directory) {}
+
+        size_t LoadData(const void* key, size_t keySize, void* value, size_t valueSize) override;
+        void StoreData(const void* key,
+                       size_t keySize,
+                       const void* value,
+                       size_t valueSize) override;
+
+    private:
+        std::string blobPath(const void* key, size_t keySize) const;
+
+        const std::string m_directory;
+    };
+
+    FileCachingInterface m_cachingInterface;
+};
+} // namespace rive::pls
+
+#endif
@@ -64,6 +64,14 @@ public:
     {
         PixelLocalStorageType plsType = PixelLocalStorageType::none;
         bool disableStorageBuffers = false;
+
+        // Create draw pipelines inline with rendering (causing jank), instead of drawing with a
+        // fully-featured pipeline while CreateRenderPipelineAsync() finishes the specialized one.
+        // (Primarily for testing.)
+        //
+        // NOTE: Asynchronous pipelines are only delivered when the app processes WebGPU events
+        // (e.g., wgpu::Device::Tick() on Dawn, or by returning to the browser's event loop).
+        bool synchronousPipelineCreation = false;
     };
 
     static std::unique_ptr<PLSRenderContext> MakeContext(
@@ -85,6 +93,10 @@ public:
                                      uint32_t mipLevelCount,
                                      const uint8_t imageDataRGBA[]) override;
 
+    // Uploads the image directly if the device was created with the matching
+    // TextureCompression* feature.
+    rcp<PLSTexture> makeCompressedImageTexture(const CompressedImage&) override;
+
 protected:
     PLSRenderContextWebGPUImpl(wgpu::Device device,
                                wgpu::Queue queue,
@@ -99,12 +111,18 @@ protected:
         RIVE_UNREACHABLE();
     }
 
-    // Create a standard PLS "draw" pipeline for the current implementation.
+    // Receives a draw pipeline that is being created asynchronously.
+    class AsyncRenderPipeline;
+
+    // Create a standard PLS "draw" pipeline for the current implementation. If 'asyncResult' is
+    // non-null, the implementation may instead begin creating the pipeline in the background and
+    // return null, in which case the pipeline is delivered to 'asyncResult' once it's ready.
     virtual wgpu::RenderPipeline makePLSDrawPipeline(rive::pls::DrawType drawType,
                                                      wgpu::TextureFormat framebufferFormat,
                                                      wgpu::ShaderModule vertexShader,
                                                      wgpu::ShaderModule fragmentShader,
-                                                     EmJsHandle* pipelineJSHandleIfNeeded);
+                                                     EmJsHandle* pipelineJSHandleIfNeeded,
+                                                     AsyncRenderPipeline* asyncResult);
 
     // Create a standard PLS "draw" render pass for the current implementation.
     virtual wgpu::RenderPassEncoder makePLSRenderPass(wgpu::CommandEncoder,
@@ -135,8 +153,17 @@ private:
 
     void prepareToMapBuffers() override {}
 
+    void precompileShaders(const std::vector<pls::ShaderVariant>&) override;
+
     void flush(const FlushDescriptor&) override;
 
+    // Returns the pipeline for the given drawType and features if it's ready. Otherwise, kicks off
+    // its creation (if necessary) and returns a ready pipeline with a superset of the requested
+    // features, or null if there isn't one yet.
+    wgpu::RenderPipeline findCompatibleDrawPipeline(pls::DrawType,
+                                                    pls::ShaderFeatures,
+                                                    wgpu::TextureFormat framebufferFormat);
+
     const wgpu::Device m_device;
     const wgpu::Queue m_queue;
     const ContextOptions m_contextOptions;
@@ -13,6 +13,8 @@ struct FiddleContextOptions
     bool synchronousShaderCompilations = false;
     bool enableReadPixels = false;
     bool disableRasterOrdering = false;
+    // Directory to persist compiled shaders/pipelines in between runs. (Dawn only.)
+    const char* shaderCacheDirectory = nullptr;
 };
 
 class FiddleContext
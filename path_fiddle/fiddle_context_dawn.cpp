@@ -14,6 +14,7 @@ std::unique_ptr<FiddleContext> FiddleContext::MakeDawnPLS(FiddleContextOptions o
 
 #include "rive/pls/pls_factory.hpp"
 #include "rive/pls/pls_renderer.hpp"
+#include "rive/pls/webgpu/dawn_pipeline_cache.hpp"
 #include "rive/pls/webgpu/pls_render_context_webgpu_impl.hpp"
 
 #include <array>
@@ -87,6 +88,14 @@ public:
     {
         WGPUInstanceDescriptor instanceDescriptor{};
         instanceDescriptor.features.timedWaitAnyEnable = true;
+        dawn::native::DawnInstanceDescriptor dawnInstanceDescriptor;
+        if (m_options.shaderCacheDirectory != nullptr)
+        {
+            m_pipelineCache = std::make_unique<DawnPipelineCache>(m_options.shaderCacheDirectory);
+            dawnInstanceDescriptor.platform = m_pipelineCache.get();
+            instanceDescriptor.nextInChain =
+                reinterpret_cast<const WGPUChainedStruct*>(&dawnInstanceDescriptor);
+        }
         m_instance = std::make_unique<dawn::native::Instance>(&instanceDescriptor);
 
         wgpu::RequestAdapterOptions adapterOptions = {
@@ -160,10 +169,10 @@ public:
         backendProcs.deviceSetLoggingCallback(m_backendDevice, device_log_callback, nullptr);
         m_device = wgpu::Device::Acquire(m_backendDevice);
         m_queue = m_device.GetQueue();
-        m_plsContext =
-            PLSRenderContextWebGPUImpl::MakeContext(m_device,
-                                                    m_queue,
-                                                    PLSRenderContextWebGPUImpl::ContextOptions());
+        m_plsContext = PLSRenderContextWebGPUImpl::MakeContext(
+            m_device,
+            m_queue,
+            {.synchronousPipelineCreation = m_options.synchronousShaderCompilations});
     }
 
     float dpiScale(GLFWwindow* window) const override
@@ -319,6 +328,8 @@ public:
 
 private:
     const FiddleContextOptions m_options;
+    // Declared before the instance and device so it outlives them.
+    std::unique_ptr<DawnPipelineCache> m_pipelineCache;
     WGPUDevice m_backendDevice = {};
     wgpu::Device m_device = {};
     wgpu::Queue m_queue = {};
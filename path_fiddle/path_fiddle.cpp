@@ -1,6 +1,7 @@
 #include "fiddle_context.hpp"
 
 #include "rive/math/simd.hpp"
+#include "rive/pls/pls_renderer.hpp"
 #include "rive/artboard.hpp"
 #include "rive/file.hpp"
 #include "rive/layout.hpp"
@@ -27,6 +28,8 @@ static FiddleContextOptions s_options;
 static GLFWwindow* s_window = nullptr;
 static int s_msaa = 0;
 static bool s_forceAtomicMode = false;
+static bool s_clipCache = false;
+static bool s_rasterCache = false;
 static bool s_wireframe = false;
 static bool s_disableFill = false;
 static bool s_disableStroke = false;
@@ -391,10 +394,22 @@ int main(int argc, const char** argv)
         {
             s_forceAtomicMode = true;
         }
+        else if (!strcmp(argv[i], "--clip_cache"))
+        {
+            s_clipCache = true;
+        }
+        else if (!strcmp(argv[i], "--raster_cache"))
+        {
+            s_rasterCache = true;
+        }
         else if (!strncmp(argv[i], "--msaa", 6))
         {
             s_msaa = argv[i][6] - '0';
         }
+        else if (!strcmp(argv[i], "--shader_cache") && i + 1 < argc)
+        {
+            s_options.shaderCacheDirectory = argv[++i];
+        }
         else
         {
             rivName = argv[i];
@@ -593,6 +608,14 @@ void riveMainLoop()
         lastHeight = height;
         s_fiddleContext->onSizeChanged(s_window, width, height, s_msaa);
         renderer = s_fiddleContext->makeRenderer(width, height);
+        if (s_clipCache && s_fiddleContext->plsContextOrNull() != nullptr)
+        {
+            static_cast<pls::PLSRenderer*>(renderer.get())->enableClipCache(true);
+        }
+        if (s_rasterCache && s_fiddleContext->plsContextOrNull() != nullptr)
+        {
+            static_cast<pls::PLSRenderer*>(renderer.get())->enableAutomaticCacheableGroups(true);
+        }
         s_needsTitleUpdate = true;
     }
     if (s_needsTitleUpdate)
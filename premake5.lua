@@ -120,6 +120,34 @@ do
     end
 end
 
+-- Renders .riv files through a recording backend and emits the shader variants they need, for
+-- PLSRenderContext::precompileShaders().
+project('shader_manifest')
+do
+    dependson('rive')
+    kind('ConsoleApp')
+    includedirs({ 'include', RIVE_RUNTIME_DIR .. '/include' })
+    flags({ 'FatalWarnings' })
+
+    files({ 'shader_manifest/**.cpp' })
+
+    links({
+        'rive',
+        'rive_pls_renderer',
+        'rive_decoders',
+        'libpng',
+        'zlib',
+        'rive_harfbuzz',
+        'rive_sheenbidi',
+    })
+
+    filter('system:windows')
+    do
+        architecture('x64')
+        defines({ 'RIVE_WINDOWS', '_CRT_SECURE_NO_WARNINGS' })
+    end
+end
+
 if _OPTIONS['with-webgpu'] or _OPTIONS['with-dawn'] then
     project('webgpu_player')
     do
@@ -0,0 +1,1445 @@
+/*
+ * Copyright 2024 Rive
+ */
+
+#include "compressed_image.hpp"
+
+#include <algorithm>
+#include <string.h>
+
+namespace rive::pls
+{
+constexpr static uint8_t kKTX2Identifier[12] =
+    {0xab, 0x4b, 0x54, 0x58, 0x20, 0x32, 0x30, 0xbb, 0x0d, 0x0a, 0x1a, 0x0a};
+
+// Byte offsets of the KTX2 header fields we read.
+constexpr static size_t kKTX2VkFormatOffset = 12;
+constexpr static size_t kKTX2PixelWidthOffset = 20;
+constexpr static size_t kKTX2PixelHeightOffset = 24;
+constexpr static size_t kKTX2PixelDepthOffset = 28;
+constexpr static size_t kKTX2LayerCountOffset = 32;
+constexpr static size_t kKTX2FaceCountOffset = 36;
+constexpr static size_t kKTX2LevelCountOffset = 40;
+constexpr static size_t kKTX2SupercompressionSchemeOffset = 44;
+constexpr static size_t kKTX2LevelIndexOffset = 80;
+constexpr static size_t kKTX2LevelIndexEntrySize = 24;
+
+template <typename T> static T read_le(const uint8_t* bytes)
+{
+    T value = 0;
+    for (size_t i = 0; i < sizeof(T); ++i)
+    {
+        value |= static_cast<T>(bytes[i]) << (i * 8);
+    }
+    return value;
+}
+
+static bool vk_format_to_compressed_texture_format(uint32_t vkFormat,
+                                                   CompressedTextureFormat* format)
+{
+    // sRGB formats map to their UNORM counterparts: like decoded images, the renderer treats
+    // texel values as already gamma-encoded.
+    switch (vkFormat)
+    {
+        case 133: // VK_FORMAT_BC1_RGBA_UNORM_BLOCK
+        case 134: // VK_FORMAT_BC1_RGBA_SRGB_BLOCK
+            *format = CompressedTextureFormat::bc1RGBA;
+            return true;
+        case 137: // VK_FORMAT_BC3_UNORM_BLOCK
+        case 138: // VK_FORMAT_BC3_SRGB_BLOCK
+            *format = CompressedTextureFormat::bc3RGBA;
+            return true;
+        case 145: // VK_FORMAT_BC7_UNORM_BLOCK
+        case 146: // VK_FORMAT_BC7_SRGB_BLOCK
+            *format = CompressedTextureFormat::bc7RGBA;
+            return true;
+        case 147: // VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK
+        case 148: // VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK
+            *format = CompressedTextureFormat::etc2RGB8;
+            return true;
+        case 151: // VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK
+        case 152: // VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK
+            *format = CompressedTextureFormat::etc2RGBA8;
+            return true;
+        case 157: // VK_FORMAT_ASTC_4x4_UNORM_BLOCK
+        case 158: // VK_FORMAT_ASTC_4x4_SRGB_BLOCK
+            *format = CompressedTextureFormat::astc4x4RGBA;
+            return true;
+    }
+    return false;
+}
+
+bool IsKTX2(Span<const uint8_t> bytes)
+{
+    return bytes.size() >= sizeof(kKTX2Identifier) &&
+           memcmp(bytes.data(), kKTX2Identifier, sizeof(kKTX2Identifier)) == 0;
+}
+
+bool ParseKTX2(Span<const uint8_t> bytes, CompressedImage* image)
+{
+    if (!IsKTX2(bytes) || bytes.size() < kKTX2LevelIndexOffset)
+    {
+        return false;
+    }
+    const uint8_t* header = bytes.data();
+    if (!vk_format_to_compressed_texture_format(read_le<uint32_t>(header + kKTX2VkFormatOffset),
+                                                &image->format))
+    {
+        return false;
+    }
+    image->width = read_le<uint32_t>(header + kKTX2PixelWidthOffset);
+    image->height = read_le<uint32_t>(header + kKTX2PixelHeightOffset);
+    if (image->width == 0 || image->height == 0 ||
+        image->width > CompressedImage::kMaxDimension ||
+        image->height > CompressedImage::kMaxDimension ||
+        read_le<uint32_t>(header + kKTX2PixelDepthOffset) != 0 ||
+        read_le<uint32_t>(header + kKTX2LayerCountOffset) > 1 ||
+        read_le<uint32_t>(header + kKTX2FaceCountOffset) != 1 ||
+        read_le<uint32_t>(header + kKTX2SupercompressionSchemeOffset) != 0)
+    {
+        return false;
+    }
+    // A levelCount of 0 asks the loader to generate mipmaps. We just use the one level we have.
+    uint32_t levelCount = std::max(read_le<uint32_t>(header + kKTX2LevelCountOffset), 1u);
+    uint32_t maxLevelCount = math::msb(image->width | image->height);
+    if (levelCount > maxLevelCount || levelCount > CompressedImage::kMaxMipLevels ||
+        bytes.size() < kKTX2LevelIndexOffset + levelCount * kKTX2LevelIndexEntrySize)
+    {
+        return false;
+    }
+    image->mipLevelCount = levelCount;
+    for (uint32_t i = 0; i < levelCount; ++i)
+    {
+        const uint8_t* entry = header + kKTX2LevelIndexOffset + i * kKTX2LevelIndexEntrySize;
+        uint64_t byteOffset = read_le<uint64_t>(entry);
+        uint64_t byteLength = read_le<uint64_t>(entry + 8);
+        size_t requiredLength = CompressedTextureSizeInBytes(image->format,
+                                                             std::max(image->width >> i, 1u),
+                                                             std::max(image->height >> i, 1u));
+        if (byteLength < requiredLength || byteOffset > bytes.size() ||
+            bytes.size() - byteOffset < requiredLength)
+        {
+            return false;
+        }
+        image->mipLevelData[i] = header + byteOffset;
+    }
+    return true;
+}
+
+// Decoded 4x4 block, row by row.
+using RGBABlock = uint8_t[16][4];
+
+static uint8_t clamp_to_u8(int x) { return static_cast<uint8_t>(std::clamp(x, 0, 255)); }
+
+static void decode_565(uint16_t c, uint8_t rgb[3])
+{
+    uint32_t r = c >> 11, g = (c >> 5) & 0x3f, b = c & 0x1f;
+    rgb[0] = (r << 3) | (r >> 2);
+    rgb[1] = (g << 2) | (g >> 4);
+    rgb[2] = (b << 3) | (b >> 2);
+}
+
+// Decodes the color half of a BC1/BC3 block. BC3 color blocks always use 4-color mode.
+static void decode_bc1_color_block(const uint8_t block[8], bool forceFourColors, RGBABlock texels)
+{
+    uint16_t c0 = read_le<uint16_t>(block);
+    uint16_t c1 = read_le<uint16_t>(block + 2);
+    uint8_t palette[4][4];
+    decode_565(c0, palette[0]);
+    decode_565(c1, palette[1]);
+    palette[0][3] = palette[1][3] = palette[2][3] = palette[3][3] = 255;
+    for (int i = 0; i < 3; ++i)
+    {
+        if (c0 > c1 || forceFourColors)
+        {
+            palette[2][i] = (2 * palette[0][i] + palette[1][i]) / 3;
+            palette[3][i] = (palette[0][i] + 2 * palette[1][i]) / 3;
+        }
+        else
+        {
+            palette[2][i] = (palette[0][i] + palette[1][i]) / 2;
+            palette[3][i] = 0;
+        }
+    }
+    if (c0 <= c1 && !forceFourColors)
+    {
+        palette[3][3] = 0;
+    }
+    uint32_t indices = read_le<uint32_t>(block + 4);
+    for (int i = 0; i < 16; ++i)
+    {
+        memcpy(texels[i], palette[(indices >> (i * 2)) & 3], 4);
+    }
+}
+
+static void decode_bc3_alpha_block(const uint8_t block[8], RGBABlock texels)
+{
+    uint32_t a0 = block[0], a1 = block[1];
+    uint8_t palette[8] = {static_cast<uint8_t>(a0), static_cast<uint8_t>(a1)};
+    if (a0 > a1)
+    {
+        for (uint32_t i = 2; i < 8; ++i)
+        {
+            palette[i] = ((8 - i) * a0 + (i - 1) * a1) / 7;
+        }
+    }
+    else
+    {
+        for (uint32_t i = 2; i < 6; ++i)
+        {
+            palette[i] = ((6 - i) * a0 + (i - 1) * a1) / 5;
+        }
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+    uint64_t indices = read_le<uint64_t>(block) >> 16;
+    for (int i = 0; i < 16; ++i)
+    {
+        texels[i][3] = palette[(indices >> (i * 3)) & 7];
+    }
+}
+
+static uint64_t read_be64(const uint8_t* bytes)
+{
+    uint64_t value = 0;
+    for (int i = 0; i < 8; ++i)
+    {
+        value = (value << 8) | bytes[i];
+    }
+    return value;
+}
+
+static uint32_t bits(uint64_t block, int hi, int lo)
+{
+    return static_cast<uint32_t>((block >> lo) & ((1ull << (hi - lo + 1)) - 1));
+}
+
+static uint8_t extend_4(uint32_t x) { return (x << 4) | x; }
+static uint8_t extend_5(uint32_t x) { return (x << 3) | (x >> 2); }
+static uint8_t extend_6(uint32_t x) { return (x << 2) | (x >> 4); }
+static uint8_t extend_7(uint32_t x) { return (x << 1) | (x >> 6); }
+
+// Decodes the RGB of an ETC2 block (including ETC1 individual/differential, T, H, and planar
+// modes). Alpha is left untouched.
+static void decode_etc2_rgb_block(const uint8_t blockBytes[8], RGBABlock texels)
+{
+    constexpr static int kModifiers[8][2] =
+        {{2, 8}, {5, 17}, {9, 29}, {13, 42}, {18, 60}, {24, 80}, {33, 106}, {47, 183}};
+    constexpr static int kTHDistances[8] = {3, 6, 11, 16, 23, 32, 41, 64};
+
+    uint64_t block = read_be64(blockBytes);
+    bool diff = bits(block, 33, 33);
+    bool flip = bits(block, 32, 32);
+    // Pixel indices are stored column by column.
+    auto pixelIndex = [block](int x, int y) {
+        int i = x * 4 + y;
+        return (bits(block, 16 + i, 16 + i) << 1) | bits(block, i, i);
+    };
+
+    int base[2][3];
+    if (diff)
+    {
+        int r = bits(block, 63, 59), dr = static_cast<int8_t>(bits(block, 58, 56) << 5) >> 5;
+        int g = bits(block, 55, 51), dg = static_cast<int8_t>(bits(block, 50, 48) << 5) >> 5;
+        int b = bits(block, 47, 43), db = static_cast<int8_t>(bits(block, 42, 40) << 5) >> 5;
+        if (r + dr < 0 || r + dr > 31)
+        {
+            // T mode.
+            uint8_t c0[3] = {extend_4((bits(block, 60, 59) << 2) | bits(block, 57, 56)),
+                             extend_4(bits(block, 55, 52)),
+                             extend_4(bits(block, 51, 48))};
+            uint8_t c1[3] = {extend_4(bits(block, 47, 44)),
+                             extend_4(bits(block, 43, 40)),
+                             extend_4(bits(block, 39, 36))};
+            int d = kTHDistances[(bits(block, 35, 34) << 1) | bits(block, 32, 32)];
+            for (int y = 0; y < 4; ++y)
+            {
+                for (int x = 0; x < 4; ++x)
+                {
+                    uint8_t* texel = texels[y * 4 + x];
+                    int idx = pixelIndex(x, y);
+                    for (int i = 0; i < 3; ++i)
+                    {
+                        int paint[4] = {c0[i], c1[i] + d, c1[i], c1[i] - d};
+                        texel[i] = clamp_to_u8(paint[idx]);
+                    }
+                }
+            }
+            return;
+        }
+        if (g + dg < 0 || g + dg > 31)
+        {
+            // H mode.
+            uint32_t r0 = bits(block, 62, 59);
+            uint32_t g0 = (bits(block, 58, 56) << 1) | bits(block, 52, 52);
+            uint32_t b0 = (bits(block, 51, 51) << 3) | bits(block, 49, 47);
+            uint32_t r1 = bits(block, 46, 43), g1 = bits(block, 42, 39), b1 = bits(block, 38, 35);
+            uint32_t distanceIdx = (bits(block, 34, 34) << 2) | (bits(block, 32, 32) << 1) |
+                                   (((r0 << 8) | (g0 << 4) | b0) >= ((r1 << 8) | (g1 << 4) | b1));
+            int d = kTHDistances[distanceIdx];
+            uint8_t c0[3] = {extend_4(r0), extend_4(g0), extend_4(b0)};
+            uint8_t c1[3] = {extend_4(r1), extend_4(g1), extend_4(b1)};
+            for (int y = 0; y < 4; ++y)
+            {
+                for (int x = 0; x < 4; ++x)
+                {
+                    uint8_t* texel = texels[y * 4 + x];
+                    int idx = pixelIndex(x, y);
+                    for (int i = 0; i < 3; ++i)
+                    {
+                        int paint[4] = {c0[i] + d, c0[i] - d, c1[i] + d, c1[i] - d};
+                        texel[i] = clamp_to_u8(paint[idx]);
+                    }
+                }
+            }
+            return;
+        }
+        if (b + db < 0 || b + db > 31)
+        {
+            // Planar mode.
+            int o[3] = {extend_6(bits(block, 62, 57)),
+                        extend_7((bits(block, 56, 56) << 6) | bits(block, 54, 49)),
+                        extend_6((bits(block, 48, 48) << 5) | (bits(block, 44, 43) << 3) |
+                                 bits(block, 41, 39))};
+            int h[3] = {extend_6((bits(block, 38, 34) << 1) | bits(block, 32, 32)),
+                        extend_7(bits(block, 31, 25)),
+                        extend_6(bits(block, 24, 19))};
+            int v[3] = {extend_6(bits(block, 18, 13)),
+                        extend_7(bits(block, 12, 6)),
+                        extend_6(bits(block, 5, 0))};
+            for (int y = 0; y < 4; ++y)
+            {
+                for (int x = 0; x < 4; ++x)
+                {
+                    for (int i = 0; i < 3; ++i)
+                    {
+                        int c = x * (h[i] - o[i]) + y * (v[i] - o[i]) + 4 * o[i];
+                        texels[y * 4 + x][i] = clamp_to_u8((c + 2) >> 2);
+                    }
+                }
+            }
+            return;
+        }
+        base[0][0] = extend_5(r);
+        base[0][1] = extend_5(g);
+        base[0][2] = extend_5(b);
+        base[1][0] = extend_5(r + dr);
+        base[1][1] = extend_5(g + dg);
+        base[1][2] = extend_5(b + db);
+    }
+    else
+    {
+        base[0][0] = extend_4(bits(block, 63, 60));
+        base[1][0] = extend_4(bits(block, 59, 56));
+        base[0][1] = extend_4(bits(block, 55, 52));
+        base[1][1] = extend_4(bits(block, 51, 48));
+        base[0][2] = extend_4(bits(block, 47, 44));
+        base[1][2] = extend_4(bits(block, 43, 40));
+    }
+    uint32_t tables[2] = {bits(block, 39, 37), bits(block, 36, 34)};
+    for (int y = 0; y < 4; ++y)
+    {
+        for (int x = 0; x < 4; ++x)
+        {
+            int subblock = flip ? y >= 2 : x >= 2;
+            uint32_t idx = pixelIndex(x, y);
+            int modifier = kModifiers[tables[subblock]][idx & 1];
+            if (idx & 2)
+            {
+                modifier = -modifier;
+            }
+            for (int i = 0; i < 3; ++i)
+            {
+                texels[y * 4 + x][i] = clamp_to_u8(base[subblock][i] + modifier);
+            }
+        }
+    }
+}
+
+static void decode_eac_alpha_block(const uint8_t blockBytes[8], RGBABlock texels)
+{
+    constexpr static int kModifiers[16][8] = {
+        {-3, -6, -9, -15, 2, 5, 8, 14},
+        {-3, -7, -10, -13, 2, 6, 9, 12},
+        {-2, -5, -8, -13, 1, 4, 7, 12},
+        {-2, -4, -6, -13, 1, 3, 5, 12},
+        {-3, -6, -8, -12, 2, 5, 7, 11},
+        {-3, -7, -9, -11, 2, 6, 8, 10},
+        {-4, -7, -8, -11, 3, 6, 7, 10},
+        {-3, -5, -8, -11, 2, 4, 7, 10},
+        {-2, -6, -8, -10, 1, 5, 7, 9},
+        {-2, -5, -8, -10, 1, 4, 7, 9},
+        {-2, -4, -8, -10, 1, 3, 7, 9},
+        {-2, -5, -7, -10, 1, 4, 6, 9},
+        {-3, -4, -7, -10, 2, 3, 6, 9},
+        {-1, -2, -3, -10, 0, 1, 2, 9},
+        {-4, -6, -8, -9, 3, 5, 7, 8},
+        {-3, -5, -7, -9, 2, 4, 6, 8},
+    };
+    uint64_t block = read_be64(blockBytes);
+    int base = bits(block, 63, 56);
+    int multiplier = bits(block, 55, 52);
+    const int* modifiers = kModifiers[bits(block, 51, 48)];
+    for (int x = 0; x < 4; ++x)
+    {
+        for (int y = 0; y < 4; ++y)
+        {
+            // Indices are stored column by column, starting at the most significant bits.
+            int shift = 45 - (x * 4 + y) * 3;
+            texels[y * 4 + x][3] = clamp_to_u8(base + modifiers[bits(block, shift + 2, shift)] *
+                                                          multiplier);
+        }
+    }
+}
+
+// 128-bit block, with bit 0 in the least significant bit of the first byte.
+class Block128
+{
+public:
+    explicit Block128(const uint8_t bytes[16]) :
+        m_lo(read_le<uint64_t>(bytes)), m_hi(read_le<uint64_t>(bytes + 8))
+    {}
+
+    // Returns 'count' bits (no more than 32), starting at bit 'start'. Bits past the end of the
+    // block read as zero.
+    uint32_t bits(uint32_t start, uint32_t count) const
+    {
+        assert(count <= 32);
+        if (count == 0 || start >= 128)
+        {
+            return 0;
+        }
+        uint64_t value = start >= 64  ? m_hi >> (start - 64)
+                         : start == 0 ? m_lo
+                                      : (m_lo >> start) | (m_hi << (64 - start));
+        return static_cast<uint32_t>(value & ((1ull << count) - 1));
+    }
+
+    // Returns the block with the order of all 128 bits reversed.
+    Block128 reversed() const
+    {
+        Block128 result;
+        result.m_lo = reverse_bits(m_hi);
+        result.m_hi = reverse_bits(m_lo);
+        return result;
+    }
+
+private:
+    Block128() = default;
+
+    static uint64_t reverse_bits(uint64_t x)
+    {
+        uint64_t result = 0;
+        for (int i = 0; i < 64; ++i, x >>= 1)
+        {
+            result = (result << 1) | (x & 1);
+        }
+        return result;
+    }
+
+    uint64_t m_lo;
+    uint64_t m_hi;
+};
+
+// Reads a block's fields in order, starting at bit 0.
+class BlockReader
+{
+public:
+    explicit BlockReader(const Block128& block, uint32_t pos = 0) : m_block(block), m_pos(pos) {}
+
+    uint32_t read(uint32_t count)
+    {
+        uint32_t value = m_block.bits(m_pos, count);
+        m_pos += count;
+        return value;
+    }
+
+    uint32_t pos() const { return m_pos; }
+
+private:
+    const Block128& m_block;
+    uint32_t m_pos;
+};
+
+// Replicates the 'fromBits' bits of 'x' into a 'toBits'-bit value (e.g., 5 -> 8 bits).
+static uint32_t replicate_bits(uint32_t x, uint32_t fromBits, uint32_t toBits)
+{
+    assert(fromBits > 0);
+    uint32_t result = 0;
+    for (int shift = toBits - fromBits; shift > -static_cast<int>(fromBits); shift -= fromBits)
+    {
+        result |= shift >= 0 ? x << shift : x >> -shift;
+    }
+    return result;
+}
+
+// BC7 mode descriptions, from the BPTC section of the Khronos Data Format Specification.
+struct BC7Mode
+{
+    uint8_t subsetCount;
+    uint8_t partitionBits;
+    uint8_t rotationBits;
+    uint8_t indexSelectionBits;
+    uint8_t colorBits;
+    uint8_t alphaBits;
+    uint8_t endpointPBits;
+    uint8_t sharedPBits;
+    uint8_t indexBits;
+    uint8_t index2Bits;
+};
+
+constexpr static BC7Mode kBC7Modes[8] = {
+    {3, 4, 0, 0, 4, 0, 1, 0, 3, 0},
+    {2, 6, 0, 0, 6, 0, 0, 1, 3, 0},
+    {3, 6, 0, 0, 5, 0, 0, 0, 2, 0},
+    {2, 6, 0, 0, 7, 0, 1, 0, 2, 0},
+    {1, 0, 2, 1, 5, 6, 0, 0, 2, 3},
+    {1, 0, 2, 0, 7, 8, 0, 0, 2, 2},
+    {1, 0, 0, 0, 7, 7, 1, 0, 4, 0},
+    {2, 6, 0, 0, 5, 5, 1, 0, 2, 0},
+};
+
+// Subset of each texel in the 2-subset partitions, one bit per texel.
+constexpr static uint16_t kBC7Partitions2[64] = {
+    0xcccc, 0x8888, 0xeeee, 0xecc8, 0xc880, 0xfeec, 0xfec8, 0xec80, 0xc800, 0xffec, 0xfe80,
+    0xe800, 0xffe8, 0xff00, 0xfff0, 0xf000, 0xf710, 0x008e, 0x7100, 0x08ce, 0x008c, 0x7310,
+    0x3100, 0x8cce, 0x088c, 0x3110, 0x6666, 0x366c, 0x17e8, 0x0ff0, 0x718e, 0x399c, 0xaaaa,
+    0xf0f0, 0x5a5a, 0x33cc, 0x3c3c, 0x55aa, 0x9696, 0xa55a, 0x73ce, 0x13c8, 0x324c, 0x3bdc,
+    0x6996, 0xc33c, 0x9966, 0x0660, 0x0272, 0x04e4, 0x4e40, 0x2720, 0xc936, 0x936c, 0x39c6,
+    0x639c, 0x9336, 0x9cc6, 0x817e, 0xe718, 0xccf0, 0x0fcc, 0x7744, 0xee22,
+};
+
+// Subset of each texel in the 3-subset partitions, two bits per texel.
+constexpr static uint32_t kBC7Partitions3[64] = {
+    0xaa685050, 0x6a5a5040, 0x5a5a4200, 0x5450a0a8, 0xa5a50000, 0xa0a05050, 0x5555a0a0,
+    0x5a5a5050, 0xaa550000, 0xaa555500, 0xaaaa5500, 0x90909090, 0x94949494, 0xa4a4a4a4,
+    0xa9a59450, 0x2a0a4250, 0xa5945040, 0x0a425054, 0xa5a5a500, 0x55a0a0a0, 0xa8a85454,
+    0x6a6a4040, 0xa4a45000, 0x1a1a0500, 0x0050a4a4, 0xaaa59090, 0x14696914, 0x69691400,
+    0xa08585a0, 0xaa821414, 0x50a4a450, 0x6a5a0200, 0xa9a58000, 0x5090a0a8, 0xa8a09050,
+    0x24242424, 0x00aa5500, 0x24924924, 0x24499224, 0x50a50a50, 0x500aa550, 0xaaaa4444,
+    0x66660000, 0xa5a0a5a0, 0x50a050a0, 0x69286928, 0x44aaaa44, 0x66666600, 0xaa444444,
+    0x54a854a8, 0x95809580, 0x96969600, 0xa85454a8, 0x80959580, 0xaa141414, 0x96960000,
+    0xaaaa1414, 0xa05050a0, 0xa0a5a5a0, 0x96000000, 0x40804080, 0xa9a8a9a8, 0xaaaaaa44,
+    0x2a4a5254,
+};
+
+// Anchor texel of the second subset in each 2-subset partition.
+constexpr static uint8_t kBC7Anchors2[64] = {
+    15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 2,  8,  2,  2,  8,
+    8,  15, 2,  8,  2,  2,  8,  8,  2,  2,  15, 15, 6,  8,  2,  8,  15, 15, 2,  8,  2,  2,
+    2,  15, 15, 6,  6,  2,  6,  8,  15, 15, 2,  2,  15, 15, 15, 15, 15, 2,  2,  15,
+};
+
+// Anchor texels of the second and third subsets in each 3-subset partition.
+constexpr static uint8_t kBC7Anchors3[2][64] = {
+    {
+        3,  3, 15, 15, 8, 3,  15, 15, 8,  8,  6,  6,  6,  5,  3,  3,  3,  3,  8,  15, 3,  3,
+        6,  10, 5, 8,  8, 6,  8,  5,  15, 15, 8,  15, 3,  5,  6,  10, 8,  15, 15, 3,  15, 5,
+        15, 15, 15, 15, 3, 15, 5,  5,  5,  8,  5,  10, 5,  10, 8,  13, 15, 12, 3,  3,
+    },
+    {
+        15, 8,  8,  3,  15, 15, 3,  8,  15, 15, 15, 15, 15, 15, 15, 8,  15, 8,  15, 3,  15, 8,
+        15, 8,  3,  15, 6,  10, 15, 15, 10, 8,  15, 3,  15, 10, 10, 8,  9,  10, 6,  15, 8,  15,
+        3,  6,  6,  8,  15, 3,  15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 3,  15, 15, 8,
+    },
+};
+
+static uint8_t bc7_interpolate(uint32_t e0, uint32_t e1, uint32_t index, uint32_t indexBits)
+{
+    constexpr static uint8_t kWeights2[4] = {0, 21, 43, 64};
+    constexpr static uint8_t kWeights3[8] = {0, 9, 18, 27, 37, 46, 55, 64};
+    constexpr static uint8_t kWeights4[16] =
+        {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+    uint32_t w = indexBits == 2   ? kWeights2[index]
+                 : indexBits == 3 ? kWeights3[index]
+                                  : kWeights4[index];
+    return static_cast<uint8_t>(((64 - w) * e0 + w * e1 + 32) >> 6);
+}
+
+static void decode_bc7_block(const uint8_t blockBytes[16], RGBABlock texels)
+{
+    if (blockBytes[0] == 0)
+    {
+        // Reserved mode. Decodes to transparent black.
+        memset(texels, 0, sizeof(RGBABlock));
+        return;
+    }
+    // The mode is the number of zeros before the first set bit.
+    uint32_t modeIdx = 0;
+    while (!(blockBytes[0] & (1 << modeIdx)))
+    {
+        ++modeIdx;
+    }
+    const BC7Mode& mode = kBC7Modes[modeIdx];
+    Block128 block(blockBytes);
+    BlockReader reader(block, modeIdx + 1);
+    uint32_t partition = reader.read(mode.partitionBits);
+    uint32_t rotation = reader.read(mode.rotationBits);
+    uint32_t indexSelection = reader.read(mode.indexSelectionBits);
+
+    // Read the endpoints: all reds, then all greens, then all blues, then all alphas.
+    uint32_t endpointCount = mode.subsetCount * 2;
+    uint32_t endpoints[6][4];
+    for (uint32_t c = 0; c < 4; ++c)
+    {
+        uint32_t componentBits = c < 3 ? mode.colorBits : mode.alphaBits;
+        for (uint32_t e = 0; e < endpointCount; ++e)
+        {
+            endpoints[e][c] = reader.read(componentBits);
+        }
+    }
+    uint32_t colorBits = mode.colorBits;
+    uint32_t alphaBits = mode.alphaBits;
+    if (mode.endpointPBits || mode.sharedPBits)
+    {
+        uint32_t pBits[6];
+        for (uint32_t e = 0; e < endpointCount; ++e)
+        {
+            // Shared P bits are one per subset, i.e., one per pair of endpoints.
+            pBits[e] = mode.endpointPBits || (e & 1) == 0 ? reader.read(1) : pBits[e - 1];
+        }
+        for (uint32_t e = 0; e < endpointCount; ++e)
+        {
+            for (uint32_t c = 0; c < (alphaBits ? 4 : 3); ++c)
+            {
+                endpoints[e][c] = (endpoints[e][c] << 1) | pBits[e];
+            }
+        }
+        ++colorBits;
+        alphaBits = alphaBits ? alphaBits + 1 : 0;
+    }
+    for (uint32_t e = 0; e < endpointCount; ++e)
+    {
+        for (uint32_t c = 0; c < 3; ++c)
+        {
+            endpoints[e][c] = replicate_bits(endpoints[e][c], colorBits, 8);
+        }
+        endpoints[e][3] = alphaBits ? replicate_bits(endpoints[e][3], alphaBits, 8) : 255;
+    }
+
+    uint32_t subsets[16];
+    uint32_t anchors[3] = {0, 0, 0};
+    for (uint32_t i = 0; i < 16; ++i)
+    {
+        subsets[i] = mode.subsetCount == 1   ? 0
+                     : mode.subsetCount == 2 ? (kBC7Partitions2[partition] >> i) & 1
+                                             : (kBC7Partitions3[partition] >> (i * 2)) & 3;
+    }
+    if (mode.subsetCount == 2)
+    {
+        anchors[1] = kBC7Anchors2[partition];
+    }
+    else if (mode.subsetCount == 3)
+    {
+        anchors[1] = kBC7Anchors3[0][partition];
+        anchors[2] = kBC7Anchors3[1][partition];
+    }
+
+    // Anchor indices have an implicit leading zero.
+    uint32_t indices[16];
+    for (uint32_t i = 0; i < 16; ++i)
+    {
+        indices[i] = reader.read(mode.indexBits - (i == anchors[subsets[i]]));
+    }
+    uint32_t indices2[16];
+    for (uint32_t i = 0; i < 16 && mode.index2Bits; ++i)
+    {
+        indices2[i] = reader.read(mode.index2Bits - (i == 0));
+    }
+    assert(reader.pos() == 128);
+
+    for (uint32_t i = 0; i < 16; ++i)
+    {
+        const uint32_t* e0 = endpoints[subsets[i] * 2];
+        const uint32_t* e1 = endpoints[subsets[i] * 2 + 1];
+        uint32_t colorIndex = indices[i], colorIndexBits = mode.indexBits;
+        uint32_t alphaIndex = indices[i], alphaIndexBits = mode.indexBits;
+        if (mode.index2Bits)
+        {
+            // The index selection bit swaps which index set colors and alpha use.
+            (indexSelection ? colorIndex : alphaIndex) = indices2[i];
+            (indexSelection ? colorIndexBits : alphaIndexBits) = mode.index2Bits;
+        }
+        for (uint32_t c = 0; c < 3; ++c)
+        {
+            texels[i][c] = bc7_interpolate(e0[c], e1[c], colorIndex, colorIndexBits);
+        }
+        texels[i][3] = bc7_interpolate(e0[3], e1[3], alphaIndex, alphaIndexBits);
+        if (rotation != 0)
+        {
+            std::swap(texels[i][3], texels[i][rotation - 1]);
+        }
+    }
+}
+
+// Quantization ranges for ASTC's integer sequence encoding, indexed by quantization level: each
+// value is a number of plain bits, optionally multiplied by a trit or a quint.
+struct ASTCRange
+{
+    uint8_t bits;
+    uint8_t trits;
+    uint8_t quints;
+};
+
+constexpr static ASTCRange kASTCRanges[21] = {
+    {1, 0, 0}, {0, 1, 0}, {2, 0, 0}, {0, 0, 1}, {1, 1, 0}, {3, 0, 0}, {1, 0, 1},
+    {2, 1, 0}, {4, 0, 0}, {2, 0, 1}, {3, 1, 0}, {5, 0, 0}, {3, 0, 1}, {4, 1, 0},
+    {6, 0, 0}, {4, 0, 1}, {5, 1, 0}, {7, 0, 0}, {5, 0, 1}, {6, 1, 0}, {8, 0, 0},
+};
+
+// Smallest quantization level that color endpoints may use.
+constexpr static uint32_t kASTCMinColorQuantLevel = 4;
+
+static uint32_t astc_ise_bit_count(uint32_t count, uint32_t quantLevel)
+{
+    const ASTCRange& range = kASTCRanges[quantLevel];
+    return count * range.bits + (range.trits ? (8 * count + 4) / 5 : 0) +
+           (range.quints ? (7 * count + 2) / 3 : 0);
+}
+
+// Decodes 'count' integers from the 'bitCount' bits at 'start'. Each value is returned as its
+// trit or quint, shifted above its plain bits.
+static void astc_decode_ise(const Block128& block,
+                            uint32_t start,
+                            uint32_t count,
+                            uint32_t quantLevel,
+                            uint32_t values[])
+{
+    const ASTCRange& range = kASTCRanges[quantLevel];
+    uint32_t end = start + astc_ise_bit_count(count, quantLevel);
+    uint32_t pos = start;
+    // Sequences are padded with zeros out to a whole number of trit or quint blocks.
+    auto read = [&](uint32_t n) {
+        uint32_t value = pos < end ? block.bits(pos, std::min(n, end - pos)) : 0;
+        pos += n;
+        return value;
+    };
+    if (range.trits)
+    {
+        for (uint32_t i = 0; i < count; i += 5)
+        {
+            uint32_t m[5], t[5];
+            m[0] = read(range.bits);
+            uint32_t T = read(2);
+            m[1] = read(range.bits);
+            T |= read(2) << 2;
+            m[2] = read(range.bits);
+            T |= read(1) << 4;
+            m[3] = read(range.bits);
+            T |= read(2) << 5;
+            m[4] = read(range.bits);
+            T |= read(1) << 7;
+            uint32_t C;
+            if (((T >> 2) & 7) == 7)
+            {
+                C = ((T >> 5) << 2) | (T & 3);
+                t[4] = t[3] = 2;
+            }
+            else
+            {
+                C = T & 0x1f;
+                if (((T >> 5) & 3) == 3)
+                {
+                    t[4] = 2;
+                    t[3] = T >> 7;
+                }
+                else
+                {
+                    t[4] = T >> 7;
+                    t[3] = (T >> 5) & 3;
+                }
+            }
+            if ((C & 3) == 3)
+            {
+                t[2] = 2;
+                t[1] = C >> 4;
+                t[0] = (((C >> 3) & 1) << 1) | ((C >> 2) & ~(C >> 3) & 1);
+            }
+            else if (((C >> 2) & 3) == 3)
+            {
+                t[2] = t[1] = 2;
+                t[0] = C & 3;
+            }
+            else
+            {
+                t[2] = C >> 4;
+                t[1] = (C >> 2) & 3;
+                t[0] = (C & 2) | (C & ~(C >> 1) & 1);
+            }
+            for (uint32_t j = 0; j < 5 && i + j < count; ++j)
+            {
+                values[i + j] = (t[j] << range.bits) | m[j];
+            }
+        }
+    }
+    else if (range.quints)
+    {
+        for (uint32_t i = 0; i < count; i += 3)
+        {
+            uint32_t m[3], q[3];
+            m[0] = read(range.bits);
+            uint32_t Q = read(3);
+            m[1] = read(range.bits);
+            Q |= read(2) << 3;
+            m[2] = read(range.bits);
+            Q |= read(2) << 5;
+            if (((Q >> 1) & 3) == 3 && ((Q >> 5) & 3) == 0)
+            {
+                q[2] = ((Q & 1) << 2) | (((Q >> 4) & ~Q & 1) << 1) | ((Q >> 3) & ~Q & 1);
+                q[1] = q[0] = 4;
+            }
+            else
+            {
+                uint32_t C;
+                if (((Q >> 1) & 3) == 3)
+                {
+                    q[2] = 4;
+                    C = (((Q >> 3) & 3) << 3) | ((~Q >> 5 & 3) << 1) | (Q & 1);
+                }
+                else
+                {
+                    q[2] = (Q >> 5) & 3;
+                    C = Q & 0x1f;
+                }
+                if ((C & 7) == 5)
+                {
+                    q[1] = 4;
+                    q[0] = (C >> 3) & 3;
+                }
+                else
+                {
+                    q[1] = (C >> 3) & 3;
+                    q[0] = C & 7;
+                }
+            }
+            for (uint32_t j = 0; j < 3 && i + j < count; ++j)
+            {
+                values[i + j] = (q[j] << range.bits) | m[j];
+            }
+        }
+    }
+    else
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            values[i] = read(range.bits);
+        }
+    }
+}
+
+// Unquantizes a trit or quint encoded value with the given "C" constant and "B" bit pattern,
+// shared by color and weight unquantization.
+static uint32_t astc_unquantize_tq(uint32_t value,
+                                   uint32_t bits,
+                                   uint32_t C,
+                                   uint32_t B,
+                                   uint32_t topBitMask)
+{
+    uint32_t A = (value & 1) ? (topBitMask << 2) - 1 : 0;
+    uint32_t D = value >> bits;
+    uint32_t T = (D * C + B) ^ A;
+    return (A & topBitMask) | (T >> 2);
+}
+
+// Unquantizes a color endpoint value to 0..255.
+static uint32_t astc_unquantize_color(uint32_t value, uint32_t quantLevel)
+{
+    const ASTCRange& range = kASTCRanges[quantLevel];
+    if (!range.trits && !range.quints)
+    {
+        return replicate_bits(value, range.bits, 8);
+    }
+    // The bits above the lowest one, e.g. "cb" in the specification's tables.
+    uint32_t m = (value & ((1 << range.bits) - 1)) >> 1;
+    uint32_t B, C;
+    switch (quantLevel)
+    {
+        case 4: // 6 (trit, 1 bit)
+            B = 0, C = 204;
+            break;
+        case 6: // 10 (quint, 1 bit)
+            B = 0, C = 113;
+            break;
+        case 7: // 12 (trit, 2 bits)
+            B = (m << 8) | (m << 4) | (m << 2) | (m << 1), C = 93;
+            break;
+        case 9: // 20 (quint, 2 bits)
+            B = (m << 8) | (m << 3) | (m << 2), C = 54;
+            break;
+        case 10: // 24 (trit, 3 bits)
+            B = (m << 7) | (m << 2) | m, C = 44;
+            break;
+        case 12: // 40 (quint, 3 bits)
+            B = (m << 7) | (m << 1) | (m >> 1), C = 26;
+            break;
+        case 13: // 48 (trit, 4 bits)
+            B = (m << 6) | m, C = 22;
+            break;
+        case 15: // 80 (quint, 4 bits)
+            B = (m << 6) | (m >> 1), C = 13;
+            break;
+        case 16: // 96 (trit, 5 bits)
+            B = (m << 5) | (m >> 2), C = 11;
+            break;
+        case 18: // 160 (quint, 5 bits)
+            B = (m << 5) | (m >> 3), C = 6;
+            break;
+        case 19: // 192 (trit, 6 bits)
+            B = (m << 4) | (m >> 4), C = 5;
+            break;
+        default:
+            // Ranges 3 and 5 are too small for color endpoints.
+            RIVE_UNREACHABLE();
+    }
+    return astc_unquantize_tq(value, range.bits, C, B, 0x80);
+}
+
+// Unquantizes a weight to 0..64.
+static uint32_t astc_unquantize_weight(uint32_t value, uint32_t quantLevel)
+{
+    const ASTCRange& range = kASTCRanges[quantLevel];
+    uint32_t m = (value & ((1 << range.bits) - 1)) >> 1;
+    uint32_t w;
+    if (!range.trits && !range.quints)
+    {
+        w = replicate_bits(value, range.bits, 6);
+    }
+    else if (quantLevel == 1) // 3 (trit)
+    {
+        constexpr static uint8_t kValues[3] = {0, 32, 63};
+        w = kValues[value];
+    }
+    else if (quantLevel == 3) // 5 (quint)
+    {
+        constexpr static uint8_t kValues[5] = {0, 16, 32, 47, 63};
+        w = kValues[value];
+    }
+    else
+    {
+        uint32_t B, C;
+        switch (quantLevel)
+        {
+            case 4: // 6 (trit, 1 bit)
+                B = 0, C = 50;
+                break;
+            case 6: // 10 (quint, 1 bit)
+                B = 0, C = 28;
+                break;
+            case 7: // 12 (trit, 2 bits)
+                B = (m << 6) | (m << 2) | m, C = 23;
+                break;
+            case 9: // 20 (quint, 2 bits)
+                B = (m << 6) | (m << 1), C = 13;
+                break;
+            case 10: // 24 (trit, 3 bits)
+                B = (m << 5) | m, C = 11;
+                break;
+            default:
+                // Weights never use more than 5 bits.
+                RIVE_UNREACHABLE();
+        }
+        w = astc_unquantize_tq(value, range.bits, C, B, 0x20);
+    }
+    return w > 32 ? w + 1 : w;
+}
+
+// The hash from the ASTC specification that assigns texels to partitions.
+static uint32_t astc_select_partition(uint32_t seed,
+                                      uint32_t x,
+                                      uint32_t y,
+                                      uint32_t partitionCount)
+{
+    // 4x4 blocks have fewer than 31 texels, so they use the "small block" coordinates.
+    x <<= 1;
+    y <<= 1;
+    seed += (partitionCount - 1) * 1024;
+    uint32_t rnum = seed;
+    rnum ^= rnum >> 15;
+    rnum -= rnum << 17;
+    rnum += rnum << 7;
+    rnum += rnum << 4;
+    rnum ^= rnum >> 5;
+    rnum += rnum << 16;
+    rnum ^= rnum >> 7;
+    rnum ^= rnum >> 3;
+    rnum ^= rnum << 6;
+    rnum ^= rnum >> 17;
+
+    uint32_t seeds[8];
+    for (int i = 0; i < 8; ++i)
+    {
+        seeds[i] = (rnum >> (i * 4)) & 0xf;
+        seeds[i] *= seeds[i];
+    }
+    uint32_t sh1, sh2;
+    if (seed & 1)
+    {
+        sh1 = (seed & 2) ? 4 : 5;
+        sh2 = partitionCount == 3 ? 6 : 5;
+    }
+    else
+    {
+        sh1 = partitionCount == 3 ? 6 : 5;
+        sh2 = (seed & 2) ? 4 : 5;
+    }
+    for (int i = 0; i < 8; ++i)
+    {
+        seeds[i] >>= (i & 1) ? sh2 : sh1;
+    }
+    // (The z terms of the hash are zero for 2D blocks.)
+    uint32_t a = (seeds[0] * x + seeds[1] * y + (rnum >> 14)) & 0x3f;
+    uint32_t b = (seeds[2] * x + seeds[3] * y + (rnum >> 10)) & 0x3f;
+    uint32_t c = partitionCount < 3 ? 0 : (seeds[4] * x + seeds[5] * y + (rnum >> 6)) & 0x3f;
+    uint32_t d = partitionCount < 4 ? 0 : (seeds[6] * x + seeds[7] * y + (rnum >> 2)) & 0x3f;
+    if (a >= b && a >= c && a >= d)
+    {
+        return 0;
+    }
+    if (b >= c && b >= d)
+    {
+        return 1;
+    }
+    return c >= d ? 2 : 3;
+}
+
+static void astc_bit_transfer_signed(int& a, int& b)
+{
+    b >>= 1;
+    b |= a & 0x80;
+    a >>= 1;
+    a &= 0x3f;
+    if (a & 0x20)
+    {
+        a -= 0x40;
+    }
+}
+
+static void astc_blue_contract(int rgba[4])
+{
+    rgba[0] = (rgba[0] + rgba[2]) >> 1;
+    rgba[1] = (rgba[1] + rgba[2]) >> 1;
+}
+
+// Decodes a pair of LDR color endpoints. Returns false for HDR endpoint modes, which LDR textures
+// don't support.
+static bool astc_decode_endpoints(uint32_t cem, const uint32_t unquantized[], int e0[4], int e1[4])
+{
+    int v[8];
+    for (uint32_t i = 0; i < (cem / 4 + 1) * 2; ++i)
+    {
+        v[i] = unquantized[i];
+    }
+    auto set = [](int e[4], int r, int g, int b, int a) {
+        e[0] = r, e[1] = g, e[2] = b, e[3] = a;
+    };
+    switch (cem)
+    {
+        case 0: // Luminance, direct.
+            set(e0, v[0], v[0], v[0], 255);
+            set(e1, v[1], v[1], v[1], 255);
+            break;
+        case 1: // Luminance, base + offset.
+        {
+            int l0 = (v[0] >> 2) | (v[1] & 0xc0);
+            int l1 = std::min(l0 + (v[1] & 0x3f), 255);
+            set(e0, l0, l0, l0, 255);
+            set(e1, l1, l1, l1, 255);
+            break;
+        }
+        case 4: // Luminance + alpha, direct.
+            set(e0, v[0], v[0], v[0], v[2]);
+            set(e1, v[1], v[1], v[1], v[3]);
+            break;
+        case 5: // Luminance + alpha, base + offset.
+            astc_bit_transfer_signed(v[1], v[0]);
+            astc_bit_transfer_signed(v[3], v[2]);
+            set(e0, v[0], v[0], v[0], v[2]);
+            set(e1, v[0] + v[1], v[0] + v[1], v[0] + v[1], v[2] + v[3]);
+            break;
+        case 6: // RGB, base + scale.
+            set(e0, (v[0] * v[3]) >> 8, (v[1] * v[3]) >> 8, (v[2] * v[3]) >> 8, 255);
+            set(e1, v[0], v[1], v[2], 255);
+            break;
+        case 8:  // RGB, direct.
+        case 12: // RGBA, direct.
+        {
+            int a0 = cem == 12 ? v[6] : 255;
+            int a1 = cem == 12 ? v[7] : 255;
+            if (v[1] + v[3] + v[5] >= v[0] + v[2] + v[4])
+            {
+                set(e0, v[0], v[2], v[4], a0);
+                set(e1, v[1], v[3], v[5], a1);
+            }
+            else
+            {
+                set(e0, v[1], v[3], v[5], a1);
+                set(e1, v[0], v[2], v[4], a0);
+                astc_blue_contract(e0);
+                astc_blue_contract(e1);
+            }
+            break;
+        }
+        case 9:  // RGB, base + offset.
+        case 13: // RGBA, base + offset.
+        {
+            astc_bit_transfer_signed(v[1], v[0]);
+            astc_bit_transfer_signed(v[3], v[2]);
+            astc_bit_transfer_signed(v[5], v[4]);
+            int a0 = 255, a1 = 255;
+            if (cem == 13)
+            {
+                astc_bit_transfer_signed(v[7], v[6]);
+                a0 = v[6];
+                a1 = v[6] + v[7];
+            }
+            if (v[1] + v[3] + v[5] >= 0)
+            {
+                set(e0, v[0], v[2], v[4], a0);
+                set(e1, v[0] + v[1], v[2] + v[3], v[4] + v[5], a1);
+            }
+            else
+            {
+                set(e0, v[0] + v[1], v[2] + v[3], v[4] + v[5], a1);
+                set(e1, v[0], v[2], v[4], a0);
+                astc_blue_contract(e0);
+                astc_blue_contract(e1);
+            }
+            break;
+        }
+        case 10: // RGB, base + scale, plus two alphas.
+            set(e0, (v[0] * v[3]) >> 8, (v[1] * v[3]) >> 8, (v[2] * v[3]) >> 8, v[4]);
+            set(e1, v[0], v[1], v[2], v[5]);
+            break;
+        default:
+            return false;
+    }
+    for (int i = 0; i < 4; ++i)
+    {
+        e0[i] = std::clamp(e0[i], 0, 255);
+        e1[i] = std::clamp(e1[i], 0, 255);
+    }
+    return true;
+}
+
+// Decodes the weight grid dimensions, weight quantization level, and dual plane flag of an ASTC
+// block mode. Returns false if the block mode is reserved.
+static bool astc_decode_block_mode(uint32_t blockMode,
+                                   uint32_t* gridWidth,
+                                   uint32_t* gridHeight,
+                                   uint32_t* weightQuantLevel,
+                                   bool* dualPlane)
+{
+    uint32_t R = (blockMode >> 4) & 1;
+    uint32_t H = (blockMode >> 9) & 1;
+    uint32_t D = (blockMode >> 10) & 1;
+    uint32_t A = (blockMode >> 5) & 3;
+    if ((blockMode & 3) != 0)
+    {
+        R |= (blockMode & 3) << 1;
+        uint32_t B = (blockMode >> 7) & 3;
+        switch ((blockMode >> 2) & 3)
+        {
+            case 0:
+                *gridWidth = B + 4, *gridHeight = A + 2;
+                break;
+            case 1:
+                *gridWidth = B + 8, *gridHeight = A + 2;
+                break;
+            case 2:
+                *gridWidth = A + 2, *gridHeight = B + 8;
+                break;
+            case 3:
+                B &= 1;
+                if (blockMode & 0x100)
+                {
+                    *gridWidth = B + 2, *gridHeight = A + 2;
+                }
+                else
+                {
+                    *gridWidth = A + 2, *gridHeight = B + 6;
+                }
+                break;
+        }
+    }
+    else
+    {
+        R |= ((blockMode >> 2) & 3) << 1;
+        if (((blockMode >> 2) & 3) == 0)
+        {
+            return false;
+        }
+        uint32_t B = (blockMode >> 9) & 3;
+        switch ((blockMode >> 7) & 3)
+        {
+            case 0:
+                *gridWidth = 12, *gridHeight = A + 2;
+                break;
+            case 1:
+                *gridWidth = A + 2, *gridHeight = 12;
+                break;
+            case 2:
+                *gridWidth = A + 6, *gridHeight = B + 6;
+                D = H = 0;
+                break;
+            case 3:
+                if (A >= 2)
+                {
+                    return false;
+                }
+                *gridWidth = A ? 10 : 6, *gridHeight = A ? 6 : 10;
+                break;
+        }
+    }
+    *weightQuantLevel = (R - 2) + 6 * H;
+    *dualPlane = D;
+    return true;
+}
+
+// Decodes an ASTC 4x4 block from an LDR texture. Blocks that are invalid, or that use HDR
+// features, decode to the error color (opaque magenta).
+static void decode_astc_4x4_block(const uint8_t blockBytes[16], RGBABlock texels)
+{
+    Block128 block(blockBytes);
+    auto fillErrorColor = [texels]() {
+        for (int i = 0; i < 16; ++i)
+        {
+            texels[i][0] = texels[i][2] = texels[i][3] = 255;
+            texels[i][1] = 0;
+        }
+    };
+
+    uint32_t blockMode = block.bits(0, 11);
+    if ((blockMode & 0x1ff) == 0x1fc)
+    {
+        // Void-extent block: a constant color, stored as UNORM16. The extent itself is only an
+        // optimization hint, but it still has to be valid.
+        uint32_t minS = block.bits(12, 13), maxS = block.bits(25, 13);
+        uint32_t minT = block.bits(38, 13), maxT = block.bits(51, 13);
+        bool extentIsAllOnes = (minS & maxS & minT & maxT) == 0x1fff;
+        if ((blockMode & 0x200) || block.bits(10, 2) != 3 ||
+            (!extentIsAllOnes && (minS >= maxS || minT >= maxT)))
+        {
+            fillErrorColor(); // HDR, reserved bits not set, or an invalid extent.
+            return;
+        }
+        for (int i = 0; i < 16; ++i)
+        {
+            for (int c = 0; c < 4; ++c)
+            {
+                texels[i][c] = block.bits(64 + c * 16 + 8, 8);
+            }
+        }
+        return;
+    }
+
+    uint32_t gridWidth, gridHeight, weightQuantLevel;
+    bool dualPlane;
+    if (!astc_decode_block_mode(blockMode, &gridWidth, &gridHeight, &weightQuantLevel, &dualPlane))
+    {
+        fillErrorColor();
+        return;
+    }
+    uint32_t partitionCount = block.bits(11, 2) + 1;
+    uint32_t weightCount = gridWidth * gridHeight * (dualPlane ? 2 : 1);
+    uint32_t weightBits = astc_ise_bit_count(weightCount, weightQuantLevel);
+    if (gridWidth > 4 || gridHeight > 4 || weightCount > 64 || weightBits < 24 ||
+        weightBits > 96 || (dualPlane && partitionCount == 4))
+    {
+        fillErrorColor();
+        return;
+    }
+
+    // Decode the color endpoint modes of each partition.
+    uint32_t cems[4];
+    uint32_t partitionSeed = 0;
+    uint32_t colorStart;
+    uint32_t belowWeights = 128 - weightBits;
+    if (partitionCount == 1)
+    {
+        cems[0] = block.bits(13, 4);
+        colorStart = 17;
+    }
+    else
+    {
+        partitionSeed = block.bits(13, 10);
+        colorStart = 29;
+        uint32_t encodedCEM = block.bits(23, 6);
+        if ((encodedCEM & 3) == 0)
+        {
+            // Every partition uses the same mode.
+            for (uint32_t i = 0; i < partitionCount; ++i)
+            {
+                cems[i] = encodedCEM >> 2;
+            }
+        }
+        else
+        {
+            // The rest of the field is stored immediately below the weights.
+            uint32_t extraBits = 3 * partitionCount - 4;
+            belowWeights -= extraBits;
+            encodedCEM |= block.bits(belowWeights, extraBits) << 6;
+            uint32_t baseClass = (encodedCEM & 3) - 1;
+            for (uint32_t i = 0; i < partitionCount; ++i)
+            {
+                uint32_t cemClass = baseClass + ((encodedCEM >> (2 + i)) & 1);
+                uint32_t cemMode = (encodedCEM >> (2 + partitionCount + i * 2)) & 3;
+                cems[i] = cemClass * 4 + cemMode;
+            }
+        }
+    }
+    uint32_t colorComponentSelector = 0;
+    if (dualPlane)
+    {
+        belowWeights -= 2;
+        colorComponentSelector = block.bits(belowWeights, 2);
+    }
+
+    // Decode the color endpoints, using the finest quantization that fits in the space remaining.
+    uint32_t colorValueCount = 0;
+    for (uint32_t i = 0; i < partitionCount; ++i)
+    {
+        colorValueCount += (cems[i] / 4 + 1) * 2;
+    }
+    if (colorValueCount > 18 || belowWeights < colorStart)
+    {
+        fillErrorColor();
+        return;
+    }
+    uint32_t colorQuantLevel = 20;
+    while (colorQuantLevel >= kASTCMinColorQuantLevel &&
+           astc_ise_bit_count(colorValueCount, colorQuantLevel) > belowWeights - colorStart)
+    {
+        --colorQuantLevel;
+    }
+    if (colorQuantLevel < kASTCMinColorQuantLevel)
+    {
+        fillErrorColor();
+        return;
+    }
+    uint32_t colorValues[18];
+    astc_decode_ise(block, colorStart, colorValueCount, colorQuantLevel, colorValues);
+    for (uint32_t i = 0; i < colorValueCount; ++i)
+    {
+        colorValues[i] = astc_unquantize_color(colorValues[i], colorQuantLevel);
+    }
+    int endpoints[4][2][4];
+    for (uint32_t i = 0, valueIdx = 0; i < partitionCount; ++i)
+    {
+        if (!astc_decode_endpoints(cems[i],
+                                   colorValues + valueIdx,
+                                   endpoints[i][0],
+                                   endpoints[i][1]))
+        {
+            fillErrorColor();
+            return;
+        }
+        valueIdx += (cems[i] / 4 + 1) * 2;
+    }
+
+    // Decode the weights, which are stored in reverse, starting at the top of the block.
+    uint32_t weights[64];
+    astc_decode_ise(block.reversed(), 0, weightCount, weightQuantLevel, weights);
+    for (uint32_t i = 0; i < weightCount; ++i)
+    {
+        weights[i] = astc_unquantize_weight(weights[i], weightQuantLevel);
+    }
+
+    // Infill the weight grid to each texel and interpolate.
+    uint32_t planeCount = dualPlane ? 2 : 1;
+    for (uint32_t y = 0; y < 4; ++y)
+    {
+        for (uint32_t x = 0; x < 4; ++x)
+        {
+            // Ds = Dt = (1024 + 4 / 2) / (4 - 1)
+            uint32_t gs = (342 * x * (gridWidth - 1) + 32) >> 6;
+            uint32_t gt = (342 * y * (gridHeight - 1) + 32) >> 6;
+            uint32_t js = gs >> 4, fs = gs & 0xf;
+            uint32_t jt = gt >> 4, ft = gt & 0xf;
+            uint32_t w11 = (fs * ft + 8) >> 4;
+            uint32_t w10 = ft - w11;
+            uint32_t w01 = fs - w11;
+            uint32_t w00 = 16 - fs - ft + w11;
+            uint32_t v0 = js + jt * gridWidth;
+            auto gridWeight = [&](uint32_t idx, uint32_t plane) {
+                idx = idx * planeCount + plane;
+                return idx < weightCount ? weights[idx] : 0;
+            };
+            uint32_t texelWeights[2];
+            for (uint32_t plane = 0; plane < planeCount; ++plane)
+            {
+                texelWeights[plane] = (gridWeight(v0, plane) * w00 +
+                                       gridWeight(v0 + 1, plane) * w01 +
+                                       gridWeight(v0 + gridWidth, plane) * w10 +
+                                       gridWeight(v0 + gridWidth + 1, plane) * w11 + 8) >>
+                                      4;
+            }
+            uint32_t partition = partitionCount > 1
+                                     ? astc_select_partition(partitionSeed, x, y, partitionCount)
+                                     : 0;
+            uint8_t* texel = texels[y * 4 + x];
+            for (uint32_t c = 0; c < 4; ++c)
+            {
+                uint32_t w = texelWeights[dualPlane && c == colorComponentSelector ? 1 : 0];
+                // Endpoints are expanded to UNORM16 before interpolation. Like void-extent
+                // colors, the result is then truncated to its top 8 bits.
+                uint32_t c0 = endpoints[partition][0][c] * 257;
+                uint32_t c1 = endpoints[partition][1][c] * 257;
+                uint32_t color16 = (c0 * (64 - w) + c1 * w + 32) >> 6;
+                texel[c] = static_cast<uint8_t>(color16 >> 8);
+            }
+        }
+    }
+}
+
+bool DecodeCompressedImageRGBA(const CompressedImage& image, uint8_t imageDataRGBA[])
+{
+    CompressedTextureFormat format = image.format;
+    const uint8_t* block = image.mipLevelData[0];
+    uint32_t blockSize = CompressedTextureBlockSizeInBytes(format);
+    for (uint32_t blockY = 0; blockY < image.height; blockY += 4)
+    {
+        for (uint32_t blockX = 0; blockX < image.width; blockX += 4, block += blockSize)
+        {
+            RGBABlock texels;
+            switch (format)
+            {
+                case CompressedTextureFormat::etc2RGB8:
+                    decode_etc2_rgb_block(block, texels);
+                    for (auto& texel : texels)
+                    {
+                        texel[3] = 255;
+                    }
+                    break;
+                case CompressedTextureFormat::etc2RGBA8:
+                    decode_eac_alpha_block(block, texels);
+                    decode_etc2_rgb_block(block + 8, texels);
+                    break;
+                case CompressedTextureFormat::bc1RGBA:
+                    decode_bc1_color_block(block, false, texels);
+                    break;
+                case CompressedTextureFormat::bc3RGBA:
+                    decode_bc1_color_block(block + 8, true, texels);
+                    decode_bc3_alpha_block(block, texels);
+                    break;
+                case CompressedTextureFormat::astc4x4RGBA:
+                    decode_astc_4x4_block(block, texels);
+                    break;
+                case CompressedTextureFormat::bc7RGBA:
+                    decode_bc7_block(block, texels);
+                    break;
+            }
+            // Copy the block out, cropping it at the right and bottom edges.
+            uint32_t w = std::min(image.width - blockX, 4u);
+            uint32_t h = std::min(image.height - blockY, 4u);
+            for (uint32_t y = 0; y < h; ++y)
+            {
+                memcpy(imageDataRGBA +
+                           (static_cast<size_t>(blockY + y) * image.width + blockX) * 4,
+                       texels[y * 4],
+                       w * 4);
+            }
+        }
+    }
+    return true;
+}
+} // namespace rive::pls
@@ -0,0 +1,24 @@
+/*
+ * Copyright 2024 Rive
+ */
+
+#pragma once
+
+#include "rive/span.hpp"
+#include "rive/pls/pls.hpp"
+
+namespace rive::pls
+{
+// True if the bytes begin with the KTX2 file identifier.
+bool IsKTX2(Span<const uint8_t> bytes);
+
+// Parses a KTX2 container that holds a single 2D image (no array layers, cube faces, or
+// supercompression) in one of the pls::CompressedTextureFormats. The mip levels in 'image' point
+// into 'bytes'. Returns false if the container is malformed or unsupported.
+bool ParseKTX2(Span<const uint8_t> bytes, CompressedImage* image);
+
+// Decodes the top mip level of 'image' into 'width * height' RGBA8 pixels, for backends that can't
+// sample its format directly. ASTC blocks that use HDR features decode to the error color
+// (magenta), as they would on a GPU that only supports LDR.
+bool DecodeCompressedImageRGBA(const CompressedImage& image, uint8_t imageDataRGBA[]);
+} // namespace rive::pls
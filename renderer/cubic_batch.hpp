@@ -0,0 +1,228 @@
+/*
+ * Copyright 2024 Rive
+ */
+
+#pragma once
+
+#include "path_utils.hpp"
+#include "rive/math/mat2d.hpp"
+#include "rive/math/math_types.hpp"
+#include "rive/math/raw_path.hpp"
+#include "rive/math/simd.hpp"
+#include "rive/math/wangs_formula.hpp"
+#include <array>
+#include <string.h>
+
+namespace rive::pls
+{
+// Gathers cubics into SoA batches of 4 and evaluates wangs_formula::cubic_pow4() on all 4 at once.
+// Each result is written (as raw float bits) to the destination that was provided when its cubic
+// was pushed, so results are deferred until the batch fills up or flush() is called.
+//
+// The kernel performs the same operations, in the same order, as the scalar cubic_pow4(), so its
+// results are bit-for-bit identical. (Debug builds assert this.)
+class WangsFormulaCubicBatch
+{
+public:
+    constexpr static int kBatchSize = 4;
+
+    WangsFormulaCubicBatch(const Mat2D& matrix, float precision) :
+        m_m0(matrix[0]),
+        m_m1(matrix[1]),
+        m_m2(matrix[2]),
+        m_m3(matrix[3])
+#ifdef DEBUG
+        ,
+        m_precision(precision),
+        m_vectorXform(matrix)
+#endif
+    {
+        // Obtain the exact length term cubic_pow4() uses by evaluating it on a cubic whose
+        // (untransformed) second difference has a squared length of exactly 1.
+        constexpr static Vec2D kUnitCubic[4] = {{0, 0}, {0, 0}, {1, 0}, {2, 0}};
+        m_lengthTermPow2 =
+            wangs_formula::cubic_pow4(kUnitCubic, precision, wangs_formula::VectorXform(Mat2D()));
+    }
+
+    ~WangsFormulaCubicBatch() { assert(m_count == 0); }
+
+    // Queues Wang's formula (to the 4th power) for the given cubic, to be written to 'dst'.
+    RIVE_ALWAYS_INLINE void push(const Vec2D pts[4], uint32_t* dst)
+    {
+        assert(m_count < kBatchSize);
+        memcpy(m_p01[m_count], pts, sizeof(float) * 4);
+        memcpy(m_p23[m_count], pts + 2, sizeof(float) * 4);
+        m_dsts[m_count] = dst;
+        if (++m_count == kBatchSize)
+        {
+            flush();
+        }
+    }
+
+    // Evaluates and writes out any queued cubics.
+    void flush()
+    {
+        if (m_count == 0)
+        {
+            return;
+        }
+        for (int i = m_count; i < kBatchSize; ++i)
+        {
+            // Fill the unused lanes with empty cubics.
+            memset(m_p01[i], 0, sizeof(float) * 4);
+            memset(m_p23[i], 0, sizeof(float) * 4);
+        }
+        auto [p0x, p0y, p1x, p1y] = simd::load4x4f(&m_p01[0][0]);
+        auto [p2x, p2y, p3x, p3y] = simd::load4x4f(&m_p23[0][0]);
+        // Second differences of [p0, p1, p2] and [p1, p2, p3].
+        float4 v0x = -2.f * p1x + p0x + p2x;
+        float4 v0y = -2.f * p1y + p0y + p2y;
+        float4 v1x = -2.f * p2x + p1x + p3x;
+        float4 v1y = -2.f * p2y + p1y + p3y;
+        // Transform the vectors by the upper 2x2 of the matrix.
+        float4 u0x = m_m0 * v0x + m_m2 * v0y;
+        float4 u0y = m_m3 * v0y + m_m1 * v0x;
+        float4 u1x = m_m0 * v1x + m_m2 * v1y;
+        float4 u1y = m_m3 * v1y + m_m1 * v1x;
+        float4 uu0x = u0x * u0x;
+        float4 uu0y = u0y * u0y;
+        float4 uu1x = u1x * u1x;
+        float4 uu1y = u1y * u1y;
+        float4 l0 = uu0x + uu0y;
+        float4 l1 = uu1x + uu1y;
+        // Same semantics as std::max(l0, l1).
+        float4 n4 = simd::if_then_else(l0 < l1, l1, l0) * m_lengthTermPow2;
+        for (int i = 0; i < m_count; ++i)
+        {
+            assert(math::bit_cast<uint32_t>(n4[i]) ==
+                   math::bit_cast<uint32_t>(wangs_formula::cubic_pow4(debugCubic(i).data(),
+                                                                      m_precision,
+                                                                      m_vectorXform)));
+            RIVE_INLINE_MEMCPY(m_dsts[i], &n4[i], sizeof(uint32_t));
+        }
+        m_count = 0;
+    }
+
+private:
+#ifdef DEBUG
+    std::array<Vec2D, 4> debugCubic(int i) const
+    {
+        std::array<Vec2D, 4> pts;
+        memcpy(pts.data(), m_p01[i], sizeof(float) * 4);
+        memcpy(pts.data() + 2, m_p23[i], sizeof(float) * 4);
+        return pts;
+    }
+#endif
+
+    const float m_m0, m_m1, m_m2, m_m3;
+    float m_lengthTermPow2;
+    float m_p01[kBatchSize][4];
+    float m_p23[kBatchSize][4];
+    uint32_t* m_dsts[kBatchSize];
+    int m_count = 0;
+#ifdef DEBUG
+    const float m_precision;
+    const wangs_formula::VectorXform m_vectorXform;
+#endif
+};
+
+// Prefilters stroked cubics for pathutils::FindCubicConvex180Chops(), 4 at a time. Most cubics in
+// real-world content are already convex and rotate less than 180 degrees, and this class identifies
+// them with a SIMD kernel so the scalar root finder only has to run on the rest.
+//
+// The kernel is conservative: it only reports "no chops" when it can prove, with a generous error
+// bound, that FindCubicConvex180Chops() would return 0 chops and areCusps=false. Everything else
+// falls back on the scalar function, so the chops are bit-for-bit identical.
+class Convex180ChopFilter
+{
+public:
+    Convex180ChopFilter(RawPath::Iter end) : m_end(end) {}
+
+    // Returns true if the cubic at 'iter' definitely doesn't need to be chopped. Cubics must be
+    // queried in path order.
+    bool cubicNeedsNoChops(RawPath::Iter iter)
+    {
+        assert(iter.verb() == PathVerb::cubic);
+        if (m_idx == m_count)
+        {
+            refill(iter);
+        }
+        assert(m_cubics[m_idx] == iter.cubicPts());
+        return m_noChops[m_idx++];
+    }
+
+private:
+    void refill(RawPath::Iter iter)
+    {
+        float p01[4][4]{};
+        float p23[4][4]{};
+        m_idx = m_count = 0;
+        for (; iter != m_end && m_count < 4; ++iter)
+        {
+            if (iter.verb() == PathVerb::cubic)
+            {
+                const Vec2D* pts = iter.cubicPts();
+                m_cubics[m_count] = pts;
+                memcpy(p01[m_count], pts, sizeof(float) * 4);
+                memcpy(p23[m_count], pts + 2, sizeof(float) * 4);
+                ++m_count;
+            }
+        }
+        assert(m_count > 0);
+
+        // Same math as FindCubicConvex180Chops(), in SoA form.
+        auto [p0x, p0y, p1x, p1y] = simd::load4x4f(&p01[0][0]);
+        auto [p2x, p2y, p3x, p3y] = simd::load4x4f(&p23[0][0]);
+        float4 Cx = p1x - p0x, Cy = p1y - p0y;
+        float4 Dx = p2x - p1x, Dy = p2y - p1y;
+        float4 Ex = p3x - p0x, Ey = p3y - p0y;
+        float4 Bx = Dx - Cx, By = Dy - Cy;
+        float4 Ax = -3.f * Dx + Ex, Ay = -3.f * Dy + Ey;
+        float4 a = Ax * By - Ay * Bx;
+        float4 b = Ax * Cy - Ay * Cx;
+        float4 c = Bx * Cy - By * Cx;
+        float4 b_over_minus_2 = -.5f * b;
+        float4 discr_over_4 = b_over_minus_2 * b_over_minus_2 - a * c;
+        float4 cuspThreshold = a * (kEpsilon / 2);
+        cuspThreshold *= cuspThreshold;
+        float4 root = c / b_over_minus_2;
+
+        // Bound how far the scalar function's a, b, and c can be from ours. (A may be rounded
+        // differently if the compiler fuses its multiply-add, and so may the cross products.) The
+        // bounds are scaled far beyond a few ulps of the magnitudes that went into each value.
+        constexpr static float kRelErr = 1.f / (1 << 18);
+        float4 absAx = 3.f * abs(Dx) + abs(Ex), absAy = 3.f * abs(Dy) + abs(Ey);
+        float4 ea = (absAx * abs(By) + absAy * abs(Bx)) * kRelErr;
+        float4 eb2 = (absAx * abs(Cy) + absAy * abs(Cx)) * (kRelErr * .5f);
+        float4 ec = (abs(Bx * Cy) + abs(By * Cx)) * kRelErr;
+        float4 absA = abs(a), absC = abs(c), absBOverMinus2 = abs(b_over_minus_2);
+        float4 discrErr = 2.f * absBOverMinus2 * eb2 + eb2 * eb2 + absA * ec + absC * ea + ea * ec +
+                          (b_over_minus_2 * b_over_minus_2 + abs(a * c)) * kRelErr +
+                          (kEpsilon / 2) * (kEpsilon / 2) * (2.f * absA * ea + ea * ea) +
+                          cuspThreshold * kRelErr;
+        float4 rootErr = (ec + abs(root) * eb2) / (absBOverMinus2 - eb2) + abs(root) * kRelErr;
+
+        // The scalar function returns 0 chops with areCusps=false when discr_over_4 <
+        // -cuspThreshold (no inflections or cusps) and the 180-degree root is outside
+        // [kEpsilon, 1 - kEpsilon). NaNs fail every comparison and fall back on the scalar path.
+        auto noChops = (discr_over_4 + cuspThreshold + 2.f * discrErr < 0.f) &
+                       (absBOverMinus2 > 2.f * eb2) &
+                       ((root + rootErr < kEpsilon) | (root - rootErr > 1 - kEpsilon));
+        for (int i = 0; i < 4; ++i)
+        {
+            m_noChops[i] = noChops[i] != 0;
+        }
+    }
+
+    RIVE_ALWAYS_INLINE static float4 abs(float4 x) { return simd::max(x, -x); }
+
+    // Matches the epsilon in FindCubicConvex180Chops().
+    constexpr static float kEpsilon = 1.f / (1 << 10);
+
+    const RawPath::Iter m_end;
+    const Vec2D* m_cubics[4];
+    bool m_noChops[4];
+    int m_count = 0;
+    int m_idx = 0;
+};
+} // namespace rive::pls
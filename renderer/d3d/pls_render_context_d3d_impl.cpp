@@ -528,6 +528,34 @@ public:
         plsImpl->gpuContext()->GenerateMips(m_srv.Get());
     }
 
+    // Uploads a block-compressed image with its own mip chain.
+    PLSTextureD3DImpl(PLSRenderContextD3DImpl* plsImpl,
+                      const CompressedImage& image,
+                      DXGI_FORMAT format) :
+        PLSTexture(image.width, image.height)
+    {
+        m_texture = plsImpl->makeSimple2DTexture(format,
+                                                 image.width,
+                                                 image.height,
+                                                 image.mipLevelCount,
+                                                 D3D11_BIND_SHADER_RESOURCE,
+                                                 0);
+        for (uint32_t level = 0; level < image.mipLevelCount; ++level)
+        {
+            uint32_t levelWidthInBlocks = (std::max(image.width >> level, 1u) + 3) / 4;
+            UINT rowPitch = levelWidthInBlocks * CompressedTextureBlockSizeInBytes(image.format);
+            plsImpl->gpuContext()->UpdateSubresource(m_texture.Get(),
+                                                     level,
+                                                     NULL,
+                                                     image.mipLevelData[level],
+                                                     rowPitch,
+                                                     0);
+        }
+        VERIFY_OK(plsImpl->gpu()->CreateShaderResourceView(m_texture.Get(),
+                                                           NULL,
+                                                           m_srv.ReleaseAndGetAddressOf()));
+    }
+
     ID3D11ShaderResourceView* srv() const { return m_srv.Get(); }
     ID3D11ShaderResourceView* const* srvAddressOf() const { return m_srv.GetAddressOf(); }
 
@@ -544,6 +572,32 @@ rcp<PLSTexture> PLSRenderContextD3DImpl::makeImageTexture(uint32_t width,
     return make_rcp<PLSTextureD3DImpl>(this, width, height, mipLevelCount, imageDataRGBA);
 }
 
+rcp<PLSTexture> PLSRenderContextD3DImpl::makeCompressedImageTexture(const CompressedImage& image)
+{
+    DXGI_FORMAT format;
+    switch (image.format)
+    {
+        case CompressedTextureFormat::bc1RGBA:
+            format = DXGI_FORMAT_BC1_UNORM;
+            break;
+        case CompressedTextureFormat::bc3RGBA:
+            format = DXGI_FORMAT_BC3_UNORM;
+            break;
+        case CompressedTextureFormat::bc7RGBA:
+            format = DXGI_FORMAT_BC7_UNORM;
+            break;
+        default:
+            // D3D11 has no ETC2 or ASTC formats.
+            return nullptr;
+    }
+    if ((image.width | image.height) & 3)
+    {
+        // D3D11 requires the top level of a block-compressed texture to be whole blocks.
+        return nullptr;
+    }
+    return make_rcp<PLSTextureD3DImpl>(this, image, format);
+}
+
 class BufferRingD3D : public BufferRing
 {
 public:
@@ -583,9 +637,9 @@ protected:
         return shadowBuffer();
     }
 
-    void onUnmapAndSubmitBuffer(int bufferIdx, size_t mapSizeInBytes) override
+    void onUnmapAndSubmitBuffer(int bufferIdx, size_t updateSizeInBytes) override
     {
-        if (mapSizeInBytes == capacityInBytes())
+        if (updateSizeInBytes == capacityInBytes())
         {
             // Constant buffers don't allow partial updates, so special-case the event where we
             // update the entire buffer.
@@ -596,7 +650,7 @@ protected:
         {
             D3D11_BOX box;
             box.left = 0;
-            box.right = mapSizeInBytes;
+            box.right = updateSizeInBytes;
             box.top = 0;
             box.bottom = 1;
             box.front = 0;
@@ -877,10 +931,27 @@ ID3D11ShaderResourceView* PLSRenderContextD3DImpl::replaceStructuredBufferSRV(
                      firstHighLevelStruct * kStructIndexMultiplier);
 }
 
-void PLSRenderContextD3DImpl::setPipelineLayoutAndShaders(DrawType drawType,
-                                                          pls::ShaderFeatures shaderFeatures,
-                                                          pls::InterlockMode interlockMode,
-                                                          pls::ShaderMiscFlags pixelShaderMiscFlags)
+void PLSRenderContextD3DImpl::precompileShaders(const std::vector<pls::ShaderVariant>& variants)
+{
+    for (const pls::ShaderVariant& variant : variants)
+    {
+        if (variant.interlockMode == pls::InterlockMode::depthStencil ||
+            variant.drawType == DrawType::plsAtomicInitialize)
+        {
+            continue; // Not used by the D3D backend.
+        }
+        findOrCompileDrawShaders(variant.drawType,
+                                 variant.shaderFeatures,
+                                 variant.interlockMode,
+                                 variant.shaderMiscFlags);
+    }
+}
+
+std::tuple<const PLSRenderContextD3DImpl::DrawVertexShader*, ID3D11PixelShader*>
+PLSRenderContextD3DImpl::findOrCompileDrawShaders(DrawType drawType,
+                                                  pls::ShaderFeatures shaderFeatures,
+                                                  pls::InterlockMode interlockMode,
+                                                  pls::ShaderMiscFlags pixelShaderMiscFlags)
 {
     uint32_t vertexShaderKey = pls::ShaderUniqueKey(drawType,
                                                     shaderFeatures & kVertexShaderFeaturesMask,
@@ -947,6 +1018,7 @@ void PLSRenderContextD3DImpl::setPipelineLayoutAndShaders(DrawType drawType,
                 break;
             case DrawType::plsAtomicInitialize:
             case DrawType::stencilClipReset:
+            case DrawType::analyticShapes:
                 RIVE_UNREACHABLE();
         }
         s << glsl::constants << '\n';
@@ -987,6 +1059,7 @@ void PLSRenderContextD3DImpl::setPipelineLayoutAndShaders(DrawType drawType,
                 s << pls::glsl::atomic_draw << '\n';
                 break;
             case DrawType::plsAtomicInitialize:
+            case DrawType::analyticShapes:
                 RIVE_UNREACHABLE();
         }
 
@@ -1061,6 +1134,7 @@ void PLSRenderContextD3DImpl::setPipelineLayoutAndShaders(DrawType drawType,
                     break;
                 case DrawType::plsAtomicInitialize:
                 case DrawType::stencilClipReset:
+                case DrawType::analyticShapes:
                     RIVE_UNREACHABLE();
             }
             VERIFY_OK(m_gpu->CreateInputLayout(layoutDesc,
@@ -1088,9 +1162,19 @@ void PLSRenderContextD3DImpl::setPipelineLayoutAndShaders(DrawType drawType,
         }
     }
 
-    m_gpuContext->IASetInputLayout(vertexEntry->second.layout.Get());
-    m_gpuContext->VSSetShader(vertexEntry->second.shader.Get(), NULL, 0);
-    m_gpuContext->PSSetShader(pixelEntry->second.Get(), NULL, 0);
+    return {&vertexEntry->second, pixelEntry->second.Get()};
+}
+
+void PLSRenderContextD3DImpl::setPipelineLayoutAndShaders(DrawType drawType,
+                                                          pls::ShaderFeatures shaderFeatures,
+                                                          pls::InterlockMode interlockMode,
+                                                          pls::ShaderMiscFlags pixelShaderMiscFlags)
+{
+    auto [vertexShader, pixelShader] =
+        findOrCompileDrawShaders(drawType, shaderFeatures, interlockMode, pixelShaderMiscFlags);
+    m_gpuContext->IASetInputLayout(vertexShader->layout.Get());
+    m_gpuContext->VSSetShader(vertexShader->shader.Get(), NULL, 0);
+    m_gpuContext->PSSetShader(pixelShader, NULL, 0);
 }
 
 static ID3D11Buffer* submitted_buffer(const BufferRing* bufferRing)
@@ -1154,11 +1238,11 @@ void PLSRenderContextD3DImpl::flush(const FlushDescriptor& desc)
                                                                        desc.firstPath)
                            : nullptr,
         desc.pathCount > 0 ? replaceStructuredBufferSRV<pls::PaintData>(paintBufferRing(),
-                                                                        desc.pathCount,
+                                                                        desc.paintCount,
                                                                         desc.firstPaint)
                            : nullptr,
         desc.pathCount > 0 ? replaceStructuredBufferSRV<pls::PaintAuxData>(paintAuxBufferRing(),
-                                                                           desc.pathCount,
+                                                                           desc.paintCount,
                                                                            desc.firstPaintAux)
                            : nullptr,
         desc.contourCount > 0 ? replaceStructuredBufferSRV<pls::ContourData>(contourBufferRing(),
@@ -1519,6 +1603,7 @@ void PLSRenderContextD3DImpl::flush(const FlushDescriptor& desc)
                 break;
             case DrawType::plsAtomicInitialize:
             case DrawType::stencilClipReset:
+            case DrawType::analyticShapes:
                 RIVE_UNREACHABLE();
         }
     }
@@ -139,6 +139,11 @@ GLuint CompileShader(GLuint type,
 void LinkProgram(GLuint program)
 {
     glLinkProgram(program);
+    VerifyProgramLinked(program);
+}
+
+void VerifyProgramLinked(GLuint program)
+{
 #ifdef DEBUG
     GLint isLinked = 0;
     glGetProgramiv(program, GL_LINK_STATUS, &isLinked);
@@ -65,9 +65,11 @@ namespace rive::pls
 {
 PLSRenderContextGLImpl::PLSRenderContextGLImpl(const char* rendererString,
                                                GLCapabilities capabilities,
-                                               std::unique_ptr<PLSImpl> plsImpl) :
+                                               std::unique_ptr<PLSImpl> plsImpl,
+                                               const ContextOptions& contextOptions) :
     m_capabilities(capabilities),
     m_plsImpl(std::move(plsImpl)),
+    m_synchronousShaderCompilations(contextOptions.synchronousShaderCompilations),
     m_state(make_rcp<GLState>(m_capabilities))
 
 {
@@ -94,6 +96,45 @@ PLSRenderContextGLImpl::PLSRenderContextGLImpl(const char* rendererString,
         m_platformFeatures.avoidFlatVaryings = true;
     }
     m_platformFeatures.fragCoordBottomUp = true;
+    m_platformFeatures.compactTessVertexSpans = contextOptions.compactTessVertexSpans;
+    m_platformFeatures.supportsAnalyticShapes = contextOptions.enableAnalyticShapes;
+    m_imageAtlasEnabled = contextOptions.enableImageAtlas;
+
+#ifndef RIVE_WEBGL
+    if (contextOptions.programBinaryCacheDirectory != nullptr &&
+        (m_capabilities.isGLES || m_capabilities.isContextVersionAtLeast(4, 1)))
+    {
+        GLint binaryFormatCount = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &binaryFormatCount);
+        if (binaryFormatCount > 0)
+        {
+            m_programBinaryCacheDirectory = contextOptions.programBinaryCacheDirectory;
+            // Binaries are only valid for the exact driver, capabilities, and shader sources they
+            // were built with. (The rest of the program's configuration is in its ShaderUniqueKey.)
+            uint64_t salt = pls::kFNVOffsetBasis;
+            auto hashString = [&salt](const char* str) {
+                salt = pls::HashBytes(salt, str, strlen(str) + 1);
+            };
+            hashString(rendererString);
+            hashString(reinterpret_cast<const char*>(glGetString(GL_VERSION)));
+            hashString(m_plsImpl != nullptr ? m_plsImpl->shaderDefineName() : "");
+            salt = pls::HashValue(salt, m_capabilities);
+            salt = pls::HashValue(salt, m_platformFeatures.avoidFlatVaryings);
+            for (const char* source : {glsl::constants,
+                                       glsl::common,
+                                       glsl::advanced_blend,
+                                       glsl::draw_path_common,
+                                       glsl::draw_path,
+                                       glsl::atomic_draw,
+                                       glsl::draw_image_mesh,
+                                       glsl::stencil_draw})
+            {
+                hashString(source);
+            }
+            m_programBinaryCacheSalt = salt;
+        }
+    }
+#endif
 
     std::vector<const char*> generalDefines;
     if (!m_capabilities.ARB_shader_storage_buffer_object)
@@ -123,31 +164,46 @@ PLSRenderContextGLImpl::PLSRenderContextGLImpl(const char* rendererString,
     glEnableVertexAttribArray(0);
     glVertexAttribDivisor(0, 1);
 
+    // Frames fall back to full TessVertexSpans when fp16 can't encode a draw within tolerance, so
+    // the compact program is compiled in addition to the full one, not instead of it.
     const char* tessellateSources[] = {glsl::constants, glsl::common, glsl::tessellate};
-    m_tessellateProgram.compileAndAttachShader(GL_VERTEX_SHADER,
-                                               generalDefines.data(),
-                                               generalDefines.size(),
-                                               tessellateSources,
-                                               std::size(tessellateSources),
-                                               m_capabilities);
-    m_tessellateProgram.compileAndAttachShader(GL_FRAGMENT_SHADER,
-                                               generalDefines.data(),
-                                               generalDefines.size(),
-                                               tessellateSources,
-                                               std::size(tessellateSources),
-                                               m_capabilities);
-    m_tessellateProgram.link();
-    m_state->bindProgram(m_tessellateProgram);
-    glUniformBlockBinding(m_tessellateProgram,
-                          glGetUniformBlockIndex(m_tessellateProgram, GLSL_FlushUniforms),
-                          FLUSH_UNIFORM_BUFFER_IDX);
-    if (!m_capabilities.ARB_shader_storage_buffer_object)
+    auto compileTessellateProgram = [&](glutils::Program& program, bool compactTessVertexSpans) {
+        std::vector<const char*> tessellateDefines = generalDefines;
+        if (compactTessVertexSpans)
+        {
+            tessellateDefines.push_back(GLSL_COMPACT_TESS_VERTEX_SPANS);
+        }
+        program.compileAndAttachShader(GL_VERTEX_SHADER,
+                                       tessellateDefines.data(),
+                                       tessellateDefines.size(),
+                                       tessellateSources,
+                                       std::size(tessellateSources),
+                                       m_capabilities);
+        program.compileAndAttachShader(GL_FRAGMENT_SHADER,
+                                       tessellateDefines.data(),
+                                       tessellateDefines.size(),
+                                       tessellateSources,
+                                       std::size(tessellateSources),
+                                       m_capabilities);
+        program.link();
+        m_state->bindProgram(program);
+        glUniformBlockBinding(program,
+                              glGetUniformBlockIndex(program, GLSL_FlushUniforms),
+                              FLUSH_UNIFORM_BUFFER_IDX);
+        if (!m_capabilities.ARB_shader_storage_buffer_object)
+        {
+            // Our GL driver doesn't support storage buffers. We polyfill these buffers as
+            // textures.
+            glUniform1i(glGetUniformLocation(program, GLSL_pathBuffer),
+                        kPLSTexIdxOffset + PATH_BUFFER_IDX);
+            glUniform1i(glGetUniformLocation(program, GLSL_contourBuffer),
+                        kPLSTexIdxOffset + CONTOUR_BUFFER_IDX);
+        }
+    };
+    compileTessellateProgram(m_tessellateProgram, false);
+    if (m_platformFeatures.compactTessVertexSpans)
     {
-        // Our GL driver doesn't support storage buffers. We polyfill these buffers as textures.
-        glUniform1i(glGetUniformLocation(m_tessellateProgram, GLSL_pathBuffer),
-                    kPLSTexIdxOffset + PATH_BUFFER_IDX);
-        glUniform1i(glGetUniformLocation(m_tessellateProgram, GLSL_contourBuffer),
-                    kPLSTexIdxOffset + CONTOUR_BUFFER_IDX);
+        compileTessellateProgram(m_tessellateCompactProgram, true);
     }
 
     m_state->bindVAO(m_tessellateVAO);
@@ -190,6 +246,11 @@ PLSRenderContextGLImpl::PLSRenderContextGLImpl(const char* rendererString,
     m_state->bindVAO(m_trianglesVAO);
     glEnableVertexAttribArray(0);
 
+    m_state->bindVAO(m_analyticShapesVAO);
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+    glEnableVertexAttribArray(2);
+
     if (!m_capabilities.ARB_bindless_texture)
     {
         // We only have to draw imageRects when in atomic mode and bindless textures are not
@@ -325,6 +386,100 @@ rcp<PLSTexture> PLSRenderContextGLImpl::makeImageTexture(uint32_t width,
     return adoptImageTexture(width, height, textureID);
 }
 
+rcp<PLSTexture> PLSRenderContextGLImpl::makeImageAtlasTexture(uint32_t size, uint32_t mipLevelCount)
+{
+    GLuint textureID;
+    glGenTextures(1, &textureID);
+    glActiveTexture(GL_TEXTURE0 + kPLSTexIdxOffset + IMAGE_TEXTURE_IDX);
+    glBindTexture(GL_TEXTURE_2D, textureID);
+    glTexStorage2D(GL_TEXTURE_2D, mipLevelCount, GL_RGBA8, size, size);
+    glutils::SetTexture2DSamplingParams(GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR);
+    return adoptImageTexture(size, size, textureID);
+}
+
+void PLSRenderContextGLImpl::updateImageAtlasTexture(PLSTexture* texture,
+                                                     uint32_t mipLevel,
+                                                     const IAABB& region,
+                                                     const uint8_t regionDataRGBA[])
+{
+    glActiveTexture(GL_TEXTURE0 + kPLSTexIdxOffset + IMAGE_TEXTURE_IDX);
+    glBindTexture(GL_TEXTURE_2D, static_cast<PLSTextureGLImpl*>(texture)->textureID());
+    m_state->bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    glTexSubImage2D(GL_TEXTURE_2D,
+                    mipLevel,
+                    region.left,
+                    region.top,
+                    region.width(),
+                    region.height(),
+                    GL_RGBA,
+                    GL_UNSIGNED_BYTE,
+                    regionDataRGBA);
+}
+
+rcp<PLSTexture> PLSRenderContextGLImpl::makeCompressedImageTexture(const CompressedImage& image)
+{
+    GLenum internalformat = 0;
+    bool supported = false;
+    switch (image.format)
+    {
+        case CompressedTextureFormat::etc2RGB8:
+            internalformat = GL_COMPRESSED_RGB8_ETC2;
+            supported = m_capabilities.ARB_ES3_compatibility;
+            break;
+        case CompressedTextureFormat::etc2RGBA8:
+            internalformat = GL_COMPRESSED_RGBA8_ETC2_EAC;
+            supported = m_capabilities.ARB_ES3_compatibility;
+            break;
+        case CompressedTextureFormat::astc4x4RGBA:
+            internalformat = GL_COMPRESSED_RGBA_ASTC_4x4_KHR;
+            supported = m_capabilities.KHR_texture_compression_astc_ldr;
+            break;
+        case CompressedTextureFormat::bc1RGBA:
+            internalformat = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+            supported = m_capabilities.EXT_texture_compression_s3tc;
+            break;
+        case CompressedTextureFormat::bc3RGBA:
+            internalformat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+            supported = m_capabilities.EXT_texture_compression_s3tc;
+            break;
+        case CompressedTextureFormat::bc7RGBA:
+            internalformat = GL_COMPRESSED_RGBA_BPTC_UNORM_EXT;
+            supported = m_capabilities.EXT_texture_compression_bptc;
+            break;
+    }
+    if (!supported)
+    {
+        return nullptr;
+    }
+
+    GLuint textureID;
+    glGenTextures(1, &textureID);
+    glActiveTexture(GL_TEXTURE0 + kPLSTexIdxOffset + IMAGE_TEXTURE_IDX);
+    glBindTexture(GL_TEXTURE_2D, textureID);
+    glTexStorage2D(GL_TEXTURE_2D, image.mipLevelCount, internalformat, image.width, image.height);
+    m_state->bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    for (uint32_t level = 0; level < image.mipLevelCount; ++level)
+    {
+        uint32_t levelWidth = std::max(image.width >> level, 1u);
+        uint32_t levelHeight = std::max(image.height >> level, 1u);
+        glCompressedTexSubImage2D(
+            GL_TEXTURE_2D,
+            level,
+            0,
+            0,
+            levelWidth,
+            levelHeight,
+            internalformat,
+            CompressedTextureSizeInBytes(image.format, levelWidth, levelHeight),
+            image.mipLevelData[level]);
+    }
+    // Use the image's own mip chain, however long it is, instead of generating one.
+    glutils::SetTexture2DSamplingParams(
+        image.mipLevelCount > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR,
+        GL_LINEAR);
+    return adoptImageTexture(image.width, image.height, textureID);
+}
+
 rcp<PLSTexture> PLSRenderContextGLImpl::adoptImageTexture(uint32_t width,
                                                           uint32_t height,
                                                           GLuint textureID)
@@ -332,6 +487,50 @@ rcp<PLSTexture> PLSRenderContextGLImpl::adoptImageTexture(uint32_t width,
     return make_rcp<PLSTextureGLImpl>(width, height, textureID, m_capabilities);
 }
 
+// Image texture that owns its GL texture object. Offscreen targets are rendered to and sampled by
+// the PLS renderer only, so nobody else is responsible for deleting them.
+class OffscreenTextureGLImpl : public PLSTextureGLImpl
+{
+public:
+    OffscreenTextureGLImpl(uint32_t width,
+                           uint32_t height,
+                           GLuint textureID,
+                           const GLCapabilities& capabilities) :
+        PLSTextureGLImpl(width, height, textureID, capabilities)
+    {
+        // Draws into a render target leave premultiplied colors behind.
+        m_hasPremultipliedAlpha = true;
+    }
+
+    ~OffscreenTextureGLImpl() override
+    {
+        GLuint id = textureID();
+        glDeleteTextures(1, &id);
+    }
+};
+
+bool PLSRenderContextGLImpl::makeOffscreenTarget(uint32_t width,
+                                                 uint32_t height,
+                                                 PLSRenderContext::OffscreenTarget* target)
+{
+    GLuint textureID;
+    glGenTextures(1, &textureID);
+    glActiveTexture(GL_TEXTURE0 + kPLSTexIdxOffset + IMAGE_TEXTURE_IDX);
+    glBindTexture(GL_TEXTURE_2D, textureID);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, width, height);
+    // There is only one mip level, so don't use the image paint's default mipmap filter.
+    glutils::SetTexture2DSamplingParams(GL_LINEAR, GL_LINEAR);
+
+    auto renderTarget = make_rcp<TextureRenderTargetGL>(width, height);
+    renderTarget->setTargetTexture(textureID);
+
+    target->renderTarget = std::move(renderTarget);
+    target->texture = make_rcp<OffscreenTextureGLImpl>(width, height, textureID, m_capabilities);
+    // GL framebuffers are bottom-up.
+    target->textureIsBottomUp = true;
+    return true;
+}
+
 // BufferRingImpl in GL on a given buffer target. In order to support WebGL2, we don't do hardware
 // mapping.
 class BufferRingGLImpl : public BufferRing
@@ -384,12 +583,15 @@ protected:
 #endif
     }
 
-    void onUnmapAndSubmitBuffer(int bufferIdx, size_t mapSizeInBytes) override
+    void onUnmapAndSubmitBuffer(int bufferIdx, size_t updateSizeInBytes) override
     {
         m_state->bindBuffer(m_target, m_ids[bufferIdx]);
 #ifdef RIVE_WEBGL
-        // WebGL doesn't support buffer mapping.
-        glBufferSubData(m_target, 0, mapSizeInBytes, shadowBuffer());
+        // WebGL doesn't support buffer mapping. Only upload the bytes that were actually written.
+        if (updateSizeInBytes != 0)
+        {
+            glBufferSubData(m_target, 0, updateSizeInBytes, shadowBuffer());
+        }
 #else
         glUnmapBuffer(m_target);
 #endif
@@ -501,32 +703,64 @@ public:
     ~TexelBufferRingWebGL() { glDeleteTextures(pls::kBufferRingSize, m_textures); }
 
     void* onMapBuffer(int bufferIdx, size_t mapSizeInBytes) override { return shadowBuffer(); }
-    void onUnmapAndSubmitBuffer(int bufferIdx, size_t mapSizeInBytes) override {}
+
+    void onUnmapAndSubmitBuffer(int bufferIdx, size_t updateSizeInBytes) override
+    {
+        // The texture gets updated from the shadow buffer when it's bound.
+        m_updateSizeInBytes = updateSizeInBytes;
+    }
 
     void bindToRenderContext(uint32_t bindingIdx,
                              size_t bindingSizeInBytes,
                              size_t offsetSizeInBytes) const
     {
-        auto [updateWidth, updateHeight] =
-            pls::StorageTextureSize(bindingSizeInBytes, m_bufferStructure);
+        assert(offsetSizeInBytes + bindingSizeInBytes <= m_updateSizeInBytes);
         m_state->bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
         glActiveTexture(GL_TEXTURE0 + kPLSTexIdxOffset + bindingIdx);
         glBindTexture(GL_TEXTURE_2D, m_textures[submittedBufferIdx()]);
-        glTexSubImage2D(GL_TEXTURE_2D,
-                        0,
-                        0,
-                        0,
-                        updateWidth,
-                        updateHeight,
-                        storage_texture_format(m_bufferStructure),
-                        storage_texture_type(m_bufferStructure),
-                        shadowBuffer() + offsetSizeInBytes);
+
+        // Only upload the texels that this binding touches. Upload the complete rows in one call,
+        // followed by the partial last row in a second one, so we never read past the end of the
+        // binding or transfer the tail of a row the shaders won't fetch.
+        size_t elementSizeInBytes = pls::StorageBufferElementSizeInBytes(m_bufferStructure);
+        assert(bindingSizeInBytes % elementSizeInBytes == 0);
+        size_t elementCount = bindingSizeInBytes / elementSizeInBytes;
+        uint32_t fullRowCount = elementCount / STORAGE_TEXTURE_WIDTH;
+        uint32_t lastRowWidth = elementCount % STORAGE_TEXTURE_WIDTH;
+        const uint8_t* data = shadowBuffer() + offsetSizeInBytes;
+        GLenum format = storage_texture_format(m_bufferStructure);
+        GLenum type = storage_texture_type(m_bufferStructure);
+        if (fullRowCount > 0)
+        {
+            glTexSubImage2D(GL_TEXTURE_2D,
+                            0,
+                            0,
+                            0,
+                            STORAGE_TEXTURE_WIDTH,
+                            fullRowCount,
+                            format,
+                            type,
+                            data);
+        }
+        if (lastRowWidth > 0)
+        {
+            glTexSubImage2D(GL_TEXTURE_2D,
+                            0,
+                            0,
+                            fullRowCount,
+                            lastRowWidth,
+                            1,
+                            format,
+                            type,
+                            data + fullRowCount * STORAGE_TEXTURE_WIDTH * elementSizeInBytes);
+        }
     }
 
 protected:
     const pls::StorageBufferStructure m_bufferStructure;
     const rcp<GLState> m_state;
     GLuint m_textures[pls::kBufferRingSize];
+    size_t m_updateSizeInBytes = 0;
 };
 
 std::unique_ptr<BufferRing> PLSRenderContextGLImpl::makeUniformBufferRing(size_t capacityInBytes)
@@ -695,6 +929,15 @@ PLSRenderContextGLImpl::DrawShader::DrawShader(PLSRenderContextGLImpl* plsContex
             sources.push_back(interlockMode == pls::InterlockMode::atomics ? pls::glsl::atomic_draw
                                                                            : pls::glsl::draw_path);
             break;
+        case pls::DrawType::analyticShapes:
+            assert(interlockMode != pls::InterlockMode::depthStencil);
+            // Analytic shapes are a variant of interior triangles that compute their own coverage.
+            defines.push_back(GLSL_DRAW_INTERIOR_TRIANGLES);
+            defines.push_back(GLSL_DRAW_ANALYTIC_SHAPES);
+            sources.push_back(pls::glsl::draw_path_common);
+            sources.push_back(interlockMode == pls::InterlockMode::atomics ? pls::glsl::atomic_draw
+                                                                           : pls::glsl::draw_path);
+            break;
         case pls::DrawType::imageRect:
             assert(interlockMode == pls::InterlockMode::atomics);
             defines.push_back(GLSL_DRAW_IMAGE);
@@ -745,35 +988,101 @@ PLSRenderContextGLImpl::DrawProgram::DrawProgram(PLSRenderContextGLImpl* plsCont
                                                  pls::ShaderFeatures shaderFeatures,
                                                  pls::InterlockMode interlockMode,
                                                  pls::ShaderMiscFlags fragmentShaderMiscFlags) :
-    m_fragmentShader(plsContextImpl,
-                     GL_FRAGMENT_SHADER,
-                     drawType,
-                     shaderFeatures,
-                     interlockMode,
-                     fragmentShaderMiscFlags),
+    m_drawType(drawType),
+    m_shaderFeatures(shaderFeatures),
+    m_interlockMode(interlockMode),
+    m_programKey(
+        pls::ShaderUniqueKey(drawType, shaderFeatures, interlockMode, fragmentShaderMiscFlags)),
     m_state(plsContextImpl->m_state)
 {
-    // Not every vertex shader is unique. Cache them by just the vertex features and reuse when
-    // possible.
-    ShaderFeatures vertexShaderFeatures = shaderFeatures & kVertexShaderFeaturesMask;
-    uint32_t vertexShaderKey = pls::ShaderUniqueKey(drawType,
-                                                    vertexShaderFeatures,
-                                                    interlockMode,
-                                                    pls::ShaderMiscFlags::none);
-    const DrawShader& vertexShader = plsContextImpl->m_vertexShaders
-                                         .try_emplace(vertexShaderKey,
-                                                      plsContextImpl,
-                                                      GL_VERTEX_SHADER,
-                                                      drawType,
-                                                      vertexShaderFeatures,
-                                                      interlockMode,
-                                                      pls::ShaderMiscFlags::none)
-                                         .first->second;
-
     m_id = glCreateProgram();
-    glAttachShader(m_id, vertexShader.id());
-    glAttachShader(m_id, m_fragmentShader.id());
-    glutils::LinkProgram(m_id);
+
+    if (plsContextImpl->loadProgramBinary(m_programKey, m_id))
+    {
+        finishLinking(plsContextImpl, /*didCompile=*/false);
+    }
+    else
+    {
+        // Not every vertex shader is unique. Cache them by just the vertex features and reuse when
+        // possible.
+        ShaderFeatures vertexShaderFeatures = shaderFeatures & kVertexShaderFeaturesMask;
+        uint32_t vertexShaderKey = pls::ShaderUniqueKey(drawType,
+                                                        vertexShaderFeatures,
+                                                        interlockMode,
+                                                        pls::ShaderMiscFlags::none);
+        const DrawShader& vertexShader = plsContextImpl->m_vertexShaders
+                                             .try_emplace(vertexShaderKey,
+                                                          plsContextImpl,
+                                                          GL_VERTEX_SHADER,
+                                                          drawType,
+                                                          vertexShaderFeatures,
+                                                          interlockMode,
+                                                          pls::ShaderMiscFlags::none)
+                                             .first->second;
+
+        // The fragment shader is only flagged for deletion when it goes out of scope. GL keeps it
+        // alive for as long as it's attached to the program.
+        DrawShader fragmentShader(plsContextImpl,
+                                  GL_FRAGMENT_SHADER,
+                                  drawType,
+                                  shaderFeatures,
+                                  interlockMode,
+                                  fragmentShaderMiscFlags);
+
+        glAttachShader(m_id, vertexShader.id());
+        glAttachShader(m_id, fragmentShader.id());
+#ifndef RIVE_WEBGL
+        if (!plsContextImpl->m_programBinaryCacheDirectory.empty())
+        {
+            glProgramParameteri(m_id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        }
+#endif
+        glLinkProgram(m_id);
+        if (plsContextImpl->m_capabilities.KHR_parallel_shader_compile)
+        {
+            // Don't query anything about the program yet; that would block until the driver
+            // finishes compiling. isReady() polls GL_COMPLETION_STATUS_KHR instead.
+            m_linkPending = true;
+        }
+        else
+        {
+            finishLinking(plsContextImpl, /*didCompile=*/true);
+        }
+    }
+}
+
+bool PLSRenderContextGLImpl::DrawProgram::isReady(PLSRenderContextGLImpl* plsContextImpl,
+                                                  bool wait)
+{
+    if (m_linkPending)
+    {
+        if (!wait)
+        {
+            GLint completionStatus = GL_FALSE;
+            glGetProgramiv(m_id, GL_COMPLETION_STATUS_KHR, &completionStatus);
+            if (completionStatus == GL_FALSE)
+            {
+                return false;
+            }
+        }
+        m_linkPending = false;
+        finishLinking(plsContextImpl, /*didCompile=*/true);
+    }
+    return true;
+}
+
+void PLSRenderContextGLImpl::DrawProgram::finishLinking(PLSRenderContextGLImpl* plsContextImpl,
+                                                        bool didCompile)
+{
+    const pls::DrawType drawType = m_drawType;
+    const pls::ShaderFeatures shaderFeatures = m_shaderFeatures;
+    const pls::InterlockMode interlockMode = m_interlockMode;
+
+    if (didCompile)
+    {
+        glutils::VerifyProgramLinked(m_id);
+        plsContextImpl->storeProgramBinary(m_programKey, m_id);
+    }
 
     m_state->bindProgram(m_id);
     glUniformBlockBinding(m_id,
@@ -819,6 +1128,204 @@ PLSRenderContextGLImpl::DrawProgram::DrawProgram(PLSRenderContextGLImpl* plsCont
 
 PLSRenderContextGLImpl::DrawProgram::~DrawProgram() { m_state->deleteProgram(m_id); }
 
+namespace
+{
+constexpr uint32_t kProgramBinaryMagic = 0x42504c52; // "RLPB"
+constexpr uint32_t kProgramBinaryFileVersion = 1;
+
+struct ProgramBinaryHeader
+{
+    uint32_t magic;
+    uint32_t fileVersion;
+    uint64_t salt;
+    uint32_t binaryFormat;
+    uint32_t binaryLength;
+};
+static_assert(sizeof(ProgramBinaryHeader) == 24);
+} // namespace
+
+std::string PLSRenderContextGLImpl::programBinaryPath(uint32_t programKey) const
+{
+    char filename[32];
+    snprintf(filename, sizeof(filename), "/rive_pls_%08x.bin", programKey);
+    return m_programBinaryCacheDirectory + filename;
+}
+
+bool PLSRenderContextGLImpl::loadProgramBinary(uint32_t programKey, GLuint programID)
+{
+#ifndef RIVE_WEBGL
+    if (m_programBinaryCacheDirectory.empty())
+    {
+        return false;
+    }
+    std::string path = programBinaryPath(programKey);
+    FILE* file = fopen(path.c_str(), "rb");
+    if (file == nullptr)
+    {
+        return false;
+    }
+    ProgramBinaryHeader header;
+    std::vector<uint8_t> binary;
+    bool valid = fread(&header, sizeof(header), 1, file) == 1 &&
+                 header.magic == kProgramBinaryMagic &&
+                 header.fileVersion == kProgramBinaryFileVersion &&
+                 header.salt == m_programBinaryCacheSalt && header.binaryLength > 0;
+    if (valid)
+    {
+        binary.resize(header.binaryLength);
+        valid = fread(binary.data(), 1, binary.size(), file) == binary.size();
+    }
+    fclose(file);
+    if (valid)
+    {
+        glProgramBinary(programID, header.binaryFormat, binary.data(), header.binaryLength);
+        GLint linkStatus = GL_FALSE;
+        glGetProgramiv(programID, GL_LINK_STATUS, &linkStatus);
+        // Drivers are allowed to reject binaries at any time (e.g., after an update).
+        valid = linkStatus == GL_TRUE;
+        if (!valid)
+        {
+            glGetError(); // Clear the GL_INVALID_ENUM from a format the driver no longer accepts.
+        }
+    }
+    if (!valid)
+    {
+        // Stale or corrupt. The caller will compile from source and store a fresh binary.
+        remove(path.c_str());
+    }
+    return valid;
+#else
+    return false;
+#endif
+}
+
+void PLSRenderContextGLImpl::storeProgramBinary(uint32_t programKey, GLuint programID)
+{
+#ifndef RIVE_WEBGL
+    if (m_programBinaryCacheDirectory.empty())
+    {
+        return;
+    }
+    GLint binaryLength = 0;
+    glGetProgramiv(programID, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+    if (binaryLength <= 0)
+    {
+        return;
+    }
+    std::vector<uint8_t> binary(binaryLength);
+    GLsizei writtenLength = 0;
+    GLenum binaryFormat = 0;
+    glGetProgramBinary(programID, binaryLength, &writtenLength, &binaryFormat, binary.data());
+    if (writtenLength <= 0)
+    {
+        return;
+    }
+
+    ProgramBinaryHeader header;
+    header.magic = kProgramBinaryMagic;
+    header.fileVersion = kProgramBinaryFileVersion;
+    header.salt = m_programBinaryCacheSalt;
+    header.binaryFormat = binaryFormat;
+    header.binaryLength = writtenLength;
+
+    // Write to a temporary file first so a crash or a concurrent process never observes a
+    // truncated binary.
+    std::string path = programBinaryPath(programKey);
+    std::string tempPath = path + ".tmp";
+    FILE* file = fopen(tempPath.c_str(), "wb");
+    if (file == nullptr)
+    {
+        return;
+    }
+    size_t binarySize = writtenLength;
+    bool success = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                   fwrite(binary.data(), 1, binarySize, file) == binarySize;
+    success = fclose(file) == 0 && success;
+    remove(path.c_str()); // rename() doesn't overwrite on Windows.
+    if (!success || rename(tempPath.c_str(), path.c_str()) != 0)
+    {
+        remove(tempPath.c_str());
+    }
+#endif
+}
+
+void PLSRenderContextGLImpl::precompileShaders(const std::vector<pls::ShaderVariant>& variants)
+{
+    for (const pls::ShaderVariant& variant : variants)
+    {
+#ifndef ENABLE_PLS_EXPERIMENTAL_ATOMICS
+        if (variant.interlockMode == pls::InterlockMode::atomics)
+        {
+            continue;
+        }
+#endif
+        if (variant.drawType == pls::DrawType::plsAtomicInitialize)
+        {
+            continue; // The GL backend initializes PLS with clears, not draws.
+        }
+        // With KHR_parallel_shader_compile, this only kicks off compilation. flush() picks the
+        // programs up once they're ready.
+        m_drawPrograms.try_emplace(variant.uniqueKey(),
+                                   this,
+                                   variant.drawType,
+                                   variant.shaderFeatures,
+                                   variant.interlockMode,
+                                   variant.shaderMiscFlags);
+    }
+}
+
+const PLSRenderContextGLImpl::DrawProgram* PLSRenderContextGLImpl::findCompatibleDrawProgram(
+    pls::DrawType drawType,
+    pls::ShaderFeatures shaderFeatures,
+    pls::InterlockMode interlockMode,
+    pls::ShaderMiscFlags fragmentShaderMiscFlags)
+{
+    uint32_t programKey =
+        pls::ShaderUniqueKey(drawType, shaderFeatures, interlockMode, fragmentShaderMiscFlags);
+    DrawProgram& drawProgram = m_drawPrograms
+                                   .try_emplace(programKey,
+                                                this,
+                                                drawType,
+                                                shaderFeatures,
+                                                interlockMode,
+                                                fragmentShaderMiscFlags)
+                                   .first->second;
+
+    // Find a fully-featured superset of features whose program we can fall back on while waiting
+    // for this one to compile.
+    ShaderFeatures fullyFeaturedProgramFeatures =
+        pls::ShaderFeaturesMaskFor(drawType, interlockMode);
+    if (interlockMode != pls::InterlockMode::rasterOrdering)
+    {
+        // Never add ENABLE_ADVANCED_BLEND to an atomic or depthStencil program that doesn't use
+        // advanced blend. In atomic mode the shaders behave differently depending on whether
+        // advanced blend is enabled, and in depthStencil mode it requires blend state and a
+        // dstColorTexture that we only set up when the flush actually uses advanced blend.
+        fullyFeaturedProgramFeatures &= shaderFeatures | ~ShaderFeatures::ENABLE_ADVANCED_BLEND;
+    }
+    if (interlockMode == pls::InterlockMode::atomics)
+    {
+        // Never add ENABLE_CLIPPING to an atomic program that doesn't use clipping; it changes how
+        // the shader interprets the PLS planes.
+        fullyFeaturedProgramFeatures &= shaderFeatures | ~ShaderFeatures::ENABLE_CLIPPING;
+    }
+    fullyFeaturedProgramFeatures |= shaderFeatures;
+
+    // Poll to see if the program is done compiling, but only wait if it's already fully featured.
+    // Otherwise, we can fall back on the fully-featured program while we wait.
+    bool shouldWaitForCompilation =
+        shaderFeatures == fullyFeaturedProgramFeatures || m_synchronousShaderCompilations;
+    if (drawProgram.isReady(this, shouldWaitForCompilation))
+    {
+        return &drawProgram;
+    }
+    assert(shaderFeatures != fullyFeaturedProgramFeatures);
+    return findCompatibleDrawProgram(drawType,
+                                     fullyFeaturedProgramFeatures,
+                                     interlockMode,
+                                     fragmentShaderMiscFlags);
+}
+
 static GLuint gl_buffer_id(const BufferRing* bufferRing)
 {
     return static_cast<const BufferRingGLImpl*>(bufferRing)->submittedBufferID();
@@ -960,13 +1467,13 @@ void PLSRenderContextGLImpl::flush(const FlushDescriptor& desc)
         bind_storage_buffer(m_capabilities,
                             paintBufferRing(),
                             PAINT_BUFFER_IDX,
-                            desc.pathCount * sizeof(pls::PaintData),
+                            desc.paintCount * sizeof(pls::PaintData),
                             desc.firstPaint * sizeof(pls::PaintData));
 
         bind_storage_buffer(m_capabilities,
                             paintAuxBufferRing(),
                             PAINT_AUX_BUFFER_IDX,
-                            desc.pathCount * sizeof(pls::PaintAuxData),
+                            desc.paintCount * sizeof(pls::PaintAuxData),
                             desc.firstPaintAux * sizeof(pls::PaintAuxData));
     }
 
@@ -1036,29 +1543,60 @@ void PLSRenderContextGLImpl::flush(const FlushDescriptor& desc)
         m_state->bindBuffer(GL_ARRAY_BUFFER, gl_buffer_id(tessSpanBufferRing()));
         m_state->bindVAO(m_tessellateVAO);
         m_state->setCullFace(GL_BACK);
-        size_t tessSpanOffsetInBytes = desc.firstTessVertexSpan * sizeof(pls::TessVertexSpan);
-        for (uintptr_t i = 0; i < 3; ++i)
+        GLsizei tessSpanIndexCount;
+        const glutils::Program* tessellateProgram;
+        if (desc.compactTessVertexSpans)
         {
-            glVertexAttribPointer(i,
-                                  4,
-                                  GL_FLOAT,
-                                  GL_FALSE,
-                                  sizeof(TessVertexSpan),
-                                  reinterpret_cast<const void*>(tessSpanOffsetInBytes + i * 4 * 4));
+            assert(m_platformFeatures.compactTessVertexSpans);
+            // Compact spans only have 2 attributes.
+            glDisableVertexAttribArray(2);
+            glDisableVertexAttribArray(3);
+            size_t tessSpanOffsetInBytes =
+                desc.firstTessVertexSpan * sizeof(pls::TessVertexSpanCompact);
+            for (uintptr_t i = 0; i < 2; ++i)
+            {
+                glVertexAttribIPointer(
+                    i,
+                    4,
+                    GL_UNSIGNED_INT,
+                    sizeof(TessVertexSpanCompact),
+                    reinterpret_cast<const void*>(tessSpanOffsetInBytes + i * 4 * 4));
+            }
+            // Compact spans don't pack a reflection. Only draw the first rectangle.
+            tessSpanIndexCount = pls::kCompactTessSpanIndexCount;
+            tessellateProgram = &m_tessellateCompactProgram;
+        }
+        else
+        {
+            glEnableVertexAttribArray(2);
+            glEnableVertexAttribArray(3);
+            size_t tessSpanOffsetInBytes = desc.firstTessVertexSpan * sizeof(pls::TessVertexSpan);
+            for (uintptr_t i = 0; i < 3; ++i)
+            {
+                glVertexAttribPointer(
+                    i,
+                    4,
+                    GL_FLOAT,
+                    GL_FALSE,
+                    sizeof(TessVertexSpan),
+                    reinterpret_cast<const void*>(tessSpanOffsetInBytes + i * 4 * 4));
+            }
+            glVertexAttribIPointer(3,
+                                   4,
+                                   GL_UNSIGNED_INT,
+                                   sizeof(TessVertexSpan),
+                                   reinterpret_cast<const void*>(tessSpanOffsetInBytes +
+                                                                 offsetof(TessVertexSpan, x0x1)));
+            tessSpanIndexCount = std::size(pls::kTessSpanIndices);
+            tessellateProgram = &m_tessellateProgram;
         }
-        glVertexAttribIPointer(
-            3,
-            4,
-            GL_UNSIGNED_INT,
-            sizeof(TessVertexSpan),
-            reinterpret_cast<const void*>(tessSpanOffsetInBytes + offsetof(TessVertexSpan, x0x1)));
         glViewport(0, 0, pls::kTessTextureWidth, desc.tessDataHeight);
         glBindFramebuffer(GL_FRAMEBUFFER, m_tessellateFBO);
-        m_state->bindProgram(m_tessellateProgram);
+        m_state->bindProgram(*tessellateProgram);
         GLenum colorAttachment0 = GL_COLOR_ATTACHMENT0;
         glInvalidateFramebuffer(GL_FRAMEBUFFER, 1, &colorAttachment0);
         glDrawElementsInstanced(GL_TRIANGLES,
-                                std::size(pls::kTessSpanIndices),
+                                tessSpanIndexCount,
                                 GL_UNSIGNED_SHORT,
                                 0,
                                 desc.tessVertexSpanCount);
@@ -1067,6 +1605,7 @@ void PLSRenderContextGLImpl::flush(const FlushDescriptor& desc)
     // Compile the draw programs before activating pixel local storage.
     // Cache specific compilations by DrawType and ShaderFeatures.
     // (ANGLE_shader_pixel_local_storage doesn't allow shader compilation while active.)
+    m_batchDrawPrograms.clear();
     for (const DrawBatch& batch : *desc.drawList)
     {
         auto shaderFeatures = desc.interlockMode == pls::InterlockMode::atomics
@@ -1075,16 +1614,10 @@ void PLSRenderContextGLImpl::flush(const FlushDescriptor& desc)
         auto fragmentShaderMiscFlags = batch.drawType == pls::DrawType::plsAtomicResolve
                                            ? m_plsImpl->atomicResolveShaderMiscFlags(desc)
                                            : pls::ShaderMiscFlags::none;
-        uint32_t fragmentShaderKey = pls::ShaderUniqueKey(batch.drawType,
-                                                          shaderFeatures,
-                                                          desc.interlockMode,
-                                                          fragmentShaderMiscFlags);
-        m_drawPrograms.try_emplace(fragmentShaderKey,
-                                   this,
-                                   batch.drawType,
-                                   shaderFeatures,
-                                   desc.interlockMode,
-                                   fragmentShaderMiscFlags);
+        m_batchDrawPrograms.push_back(findCompatibleDrawProgram(batch.drawType,
+                                                                shaderFeatures,
+                                                                desc.interlockMode,
+                                                                fragmentShaderMiscFlags));
     }
 
     // Bind the currently-submitted buffer in the triangleBufferRing to its vertex array.
@@ -1093,6 +1626,22 @@ void PLSRenderContextGLImpl::flush(const FlushDescriptor& desc)
         m_state->bindVAO(m_trianglesVAO);
         m_state->bindBuffer(GL_ARRAY_BUFFER, gl_buffer_id(triangleBufferRing()));
         glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
+
+        // Analytic shapes reinterpret the same buffer as AnalyticShapeVertex records.
+        m_state->bindVAO(m_analyticShapesVAO);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(pls::AnalyticShapeVertex), nullptr);
+        glVertexAttribPointer(1,
+                              4,
+                              GL_FLOAT,
+                              GL_FALSE,
+                              sizeof(pls::AnalyticShapeVertex),
+                              reinterpret_cast<const void*>(sizeof(float) * 3));
+        glVertexAttribPointer(2,
+                              2,
+                              GL_FLOAT,
+                              GL_FALSE,
+                              sizeof(pls::AnalyticShapeVertex),
+                              reinterpret_cast<const void*>(sizeof(float) * 7));
     }
 
     glViewport(0, 0, renderTarget->width(), renderTarget->height());
@@ -1153,24 +1702,15 @@ void PLSRenderContextGLImpl::flush(const FlushDescriptor& desc)
     bool clipPlanesEnabled = false;
 
     // Execute the DrawList.
+    size_t batchIdx = 0;
     for (const DrawBatch& batch : *desc.drawList)
     {
+        const DrawProgram& drawProgram = *m_batchDrawPrograms[batchIdx++];
         if (batch.elementCount == 0)
         {
             continue;
         }
 
-        auto shaderFeatures = desc.interlockMode == pls::InterlockMode::atomics
-                                  ? desc.combinedShaderFeatures
-                                  : batch.shaderFeatures;
-        auto fragmentShaderMiscFlags = batch.drawType == pls::DrawType::plsAtomicResolve
-                                           ? m_plsImpl->atomicResolveShaderMiscFlags(desc)
-                                           : pls::ShaderMiscFlags::none;
-        uint32_t fragmentShaderKey = pls::ShaderUniqueKey(batch.drawType,
-                                                          shaderFeatures,
-                                                          desc.interlockMode,
-                                                          fragmentShaderMiscFlags);
-        const DrawProgram& drawProgram = m_drawPrograms.find(fragmentShaderKey)->second;
         if (drawProgram.id() == 0)
         {
             fprintf(stderr, "WARNING: skipping draw due to missing GL program.\n");
@@ -1284,6 +1824,38 @@ void PLSRenderContextGLImpl::flush(const FlushDescriptor& desc)
                 drawHelper.setIndexRange(pls::PatchFanIndexCount(drawType),
                                          pls::PatchFanBaseIndex(drawType));
 
+                if (drawType == pls::DrawType::outerCurvePatches)
+                {
+                    // These are the outer curves of an interior triangulation. Stencil them before
+                    // the interior triangles, then cover them after. (See
+                    // DrawType::interiorTriangulation.)
+                    GLuint windingMask = isEvenOddFill ? 0x1 : 0x7f;
+                    m_state->setCullFace(GL_NONE);
+                    if (!batch.isStencilCover)
+                    {
+                        glStencilFunc(hasActiveClip ? GL_LEQUAL : GL_ALWAYS, 0x80, 0xff);
+                        glStencilOpSeparate(GL_FRONT, GL_KEEP, GL_KEEP, GL_INCR_WRAP);
+                        glStencilOpSeparate(GL_BACK, GL_KEEP, GL_KEEP, GL_DECR_WRAP);
+                        m_state->setWriteMasks(false, false, windingMask);
+                        drawHelper.draw();
+                    }
+                    // Nested clip updates do the "cover" operation during
+                    // DrawType::stencilClipReset.
+                    else if (!isNestedClipUpdate)
+                    {
+                        m_state->setWriteMasks(!isClipUpdate,
+                                               !isClipUpdate,
+                                               isClipUpdate ? 0xff : windingMask);
+                        drawHelper.drawWithStencilSettings(GL_NOTEQUAL,
+                                                           0x80,
+                                                           0x7f,
+                                                           GL_KEEP,
+                                                           GL_KEEP,
+                                                           isClipUpdate ? GL_REPLACE : GL_ZERO);
+                    }
+                    break;
+                }
+
                 // "nonZero" fill rules (that aren't nested clip updates) can be optimized to render
                 // directly instead of using a "stencil then cover" approach.
                 if (!isEvenOddFill && !isNestedClipUpdate)
@@ -1376,10 +1948,70 @@ void PLSRenderContextGLImpl::flush(const FlushDescriptor& desc)
             }
             case pls::DrawType::interiorTriangulation:
             {
-                assert(desc.interlockMode != pls::InterlockMode::depthStencil); // TODO!
-                m_plsImpl->ensureRasterOrderingEnabled(this, false);
                 m_state->bindVAO(m_trianglesVAO);
-                m_state->setCullFace(GL_BACK);
+                if (desc.interlockMode != pls::InterlockMode::depthStencil)
+                {
+                    m_plsImpl->ensureRasterOrderingEnabled(this, false);
+                    m_state->setCullFace(GL_BACK);
+                    glDrawArrays(GL_TRIANGLES, batch.baseElement, batch.elementCount);
+                    break;
+                }
+
+                // MSAA interior triangles are wound like a Redbook fan, so their winding numbers
+                // can be combined in the stencil buffer with the outer curves', which have already
+                // been stencilled.
+                bool hasActiveClip = ((batch.drawContents & pls::DrawContents::activeClip));
+                bool isClipUpdate = ((batch.drawContents & pls::DrawContents::clipUpdate));
+                bool isNestedClipUpdate =
+                    (batch.drawContents & pls::kNestedClipUpdateMask) == pls::kNestedClipUpdateMask;
+                bool isEvenOddFill = (batch.drawContents & pls::DrawContents::evenOddFill);
+                GLuint windingMask = isEvenOddFill ? 0x1 : 0x7f;
+                m_state->setCullFace(GL_NONE);
+                if (!hasActiveClip && !isClipUpdate)
+                {
+                    // Most of the interior is untouched by the outer curves. Fill those pixels
+                    // directly (the depth test prevents double hits), and only add the interior's
+                    // winding numbers to the stencil buffer where the outer curves left a nonzero
+                    // value. The outer curves' cover pass will fill the rest.
+                    glStencilFunc(GL_EQUAL, 0, windingMask);
+                    glStencilOpSeparate(GL_FRONT, GL_INCR_WRAP, GL_KEEP, GL_KEEP);
+                    glStencilOpSeparate(GL_BACK, GL_DECR_WRAP, GL_KEEP, GL_KEEP);
+                    m_state->setWriteMasks(true, true, windingMask);
+                    glDrawArrays(GL_TRIANGLES, batch.baseElement, batch.elementCount);
+                    break;
+                }
+
+                // With clipping, a failed stencil test might mean the pixel is outside the clip
+                // instead of having a nonzero winding number. Fall back on stencil-then-cover.
+                glStencilFunc(hasActiveClip ? GL_LEQUAL : GL_ALWAYS, 0x80, 0xff);
+                glStencilOpSeparate(GL_FRONT, GL_KEEP, GL_KEEP, GL_INCR_WRAP);
+                glStencilOpSeparate(GL_BACK, GL_KEEP, GL_KEEP, GL_DECR_WRAP);
+                m_state->setWriteMasks(false, false, windingMask);
+                glDrawArrays(GL_TRIANGLES, batch.baseElement, batch.elementCount);
+
+                // Nested clip updates do the "cover" operation during DrawType::stencilClipReset.
+                if (!isNestedClipUpdate)
+                {
+                    m_state->setWriteMasks(!isClipUpdate,
+                                           !isClipUpdate,
+                                           isClipUpdate ? 0xff : windingMask);
+                    glStencilFunc(GL_NOTEQUAL, 0x80, 0x7f);
+                    glStencilOp(GL_KEEP, GL_KEEP, isClipUpdate ? GL_REPLACE : GL_ZERO);
+                    glDrawArrays(GL_TRIANGLES, batch.baseElement, batch.elementCount);
+                }
+                break;
+            }
+            case pls::DrawType::analyticShapes:
+            {
+                assert(desc.interlockMode != pls::InterlockMode::depthStencil);
+                // Shapes in the same batch may overlap in rasterOrdering mode. (Atomic mode
+                // already separates overlapping draws with barriers.)
+                m_plsImpl->ensureRasterOrderingEnabled(
+                    this,
+                    desc.interlockMode == pls::InterlockMode::rasterOrdering);
+                m_state->bindVAO(m_analyticShapesVAO);
+                // The quad's winding depends on the matrix, and coverage is computed analytically.
+                m_state->setCullFace(GL_NONE);
                 glDrawArrays(GL_TRIANGLES, batch.baseElement, batch.elementCount);
                 break;
             }
@@ -1619,16 +2251,22 @@ std::unique_ptr<PLSRenderContext> PLSRenderContextGLImpl::MakeContext(
         {
             capabilities.ARB_shader_storage_buffer_object = true;
         }
+#ifndef RIVE_WEBGL
+        // ETC2 is core in GLES 3.0 (but not WebGL 2).
+        capabilities.ARB_ES3_compatibility = true;
+#endif
     }
     else
     {
         if (capabilities.isContextVersionAtLeast(4, 2))
         {
             capabilities.ARB_shader_image_load_store = true;
+            capabilities.EXT_texture_compression_bptc = true;
         }
         if (capabilities.isContextVersionAtLeast(4, 3))
         {
             capabilities.ARB_shader_storage_buffer_object = true;
+            capabilities.ARB_ES3_compatibility = true;
         }
         capabilities.EXT_clip_cull_distance = true;
     }
@@ -1663,6 +2301,10 @@ std::unique_ptr<PLSRenderContext> PLSRenderContextGLImpl::MakeContext(
         {
             capabilities.ARM_shader_framebuffer_fetch = true;
         }
+        else if (strcmp(ext, "GL_ARB_ES3_compatibility") == 0)
+        {
+            capabilities.ARB_ES3_compatibility = true;
+        }
         else if (strcmp(ext, "GL_ARB_fragment_shader_interlock") == 0)
         {
             capabilities.ARB_fragment_shader_interlock = true;
@@ -1683,6 +2325,15 @@ std::unique_ptr<PLSRenderContext> PLSRenderContextGLImpl::MakeContext(
         {
             capabilities.KHR_blend_equation_advanced_coherent = true;
         }
+        else if (strcmp(ext, "GL_KHR_parallel_shader_compile") == 0 ||
+                 strcmp(ext, "GL_ARB_parallel_shader_compile") == 0)
+        {
+            capabilities.KHR_parallel_shader_compile = true;
+        }
+        else if (strcmp(ext, "GL_KHR_texture_compression_astc_ldr") == 0)
+        {
+            capabilities.KHR_texture_compression_astc_ldr = true;
+        }
         else if (strcmp(ext, "GL_EXT_base_instance") == 0)
         {
             capabilities.EXT_base_instance = true;
@@ -1707,6 +2358,15 @@ std::unique_ptr<PLSRenderContext> PLSRenderContextGLImpl::MakeContext(
         {
             capabilities.EXT_shader_pixel_local_storage = true;
         }
+        else if (strcmp(ext, "GL_EXT_texture_compression_bptc") == 0 ||
+                 strcmp(ext, "GL_ARB_texture_compression_bptc") == 0)
+        {
+            capabilities.EXT_texture_compression_bptc = true;
+        }
+        else if (strcmp(ext, "GL_EXT_texture_compression_s3tc") == 0)
+        {
+            capabilities.EXT_texture_compression_s3tc = true;
+        }
         else if (strcmp(ext, "GL_QCOM_shader_framebuffer_fetch_noncoherent") == 0)
         {
             capabilities.QCOM_shader_framebuffer_fetch_noncoherent = true;
@@ -1727,6 +2387,31 @@ std::unique_ptr<PLSRenderContext> PLSRenderContextGLImpl::MakeContext(
     {
         capabilities.EXT_clip_cull_distance = true;
     }
+    if (emscripten_webgl_enable_extension(emscripten_webgl_get_current_context(),
+                                          "KHR_parallel_shader_compile"))
+    {
+        capabilities.KHR_parallel_shader_compile = true;
+    }
+    if (emscripten_webgl_enable_extension(emscripten_webgl_get_current_context(),
+                                          "WEBGL_compressed_texture_etc"))
+    {
+        capabilities.ARB_ES3_compatibility = true;
+    }
+    if (emscripten_webgl_enable_extension(emscripten_webgl_get_current_context(),
+                                          "WEBGL_compressed_texture_astc"))
+    {
+        capabilities.KHR_texture_compression_astc_ldr = true;
+    }
+    if (emscripten_webgl_enable_extension(emscripten_webgl_get_current_context(),
+                                          "EXT_texture_compression_bptc"))
+    {
+        capabilities.EXT_texture_compression_bptc = true;
+    }
+    if (emscripten_webgl_enable_extension(emscripten_webgl_get_current_context(),
+                                          "WEBGL_compressed_texture_s3tc"))
+    {
+        capabilities.EXT_texture_compression_s3tc = true;
+    }
 #endif // RIVE_WEBGL
 
 #ifdef RIVE_DESKTOP_GL
@@ -1794,40 +2479,51 @@ std::unique_ptr<PLSRenderContext> PLSRenderContextGLImpl::MakeContext(
             (capabilities.ARM_shader_framebuffer_fetch ||
              capabilities.EXT_shader_framebuffer_fetch))
         {
-            return MakeContext(rendererString, capabilities, MakePLSImplEXTNative(capabilities));
+            return MakeContext(rendererString,
+                               capabilities,
+                               MakePLSImplEXTNative(capabilities),
+                               contextOptions);
         }
 
         if (capabilities.EXT_shader_framebuffer_fetch)
         {
             return MakeContext(rendererString,
                                capabilities,
-                               MakePLSImplFramebufferFetch(capabilities));
+                               MakePLSImplFramebufferFetch(capabilities),
+                               contextOptions);
         }
 #else
         if (capabilities.ANGLE_shader_pixel_local_storage_coherent)
         {
-            return MakeContext(rendererString, capabilities, MakePLSImplWebGL());
+            return MakeContext(rendererString, capabilities, MakePLSImplWebGL(), contextOptions);
         }
 #endif
 
 #ifdef RIVE_DESKTOP_GL
         if (capabilities.ARB_shader_image_load_store)
         {
-            return MakeContext(rendererString, capabilities, MakePLSImplRWTexture());
+            return MakeContext(rendererString,
+                               capabilities,
+                               MakePLSImplRWTexture(),
+                               contextOptions);
         }
 #endif
     }
 
-    return MakeContext(rendererString, capabilities, nullptr);
+    return MakeContext(rendererString, capabilities, nullptr, contextOptions);
 }
 
 std::unique_ptr<PLSRenderContext> PLSRenderContextGLImpl::MakeContext(
     const char* rendererString,
     GLCapabilities capabilities,
-    std::unique_ptr<PLSImpl> plsImpl)
+    std::unique_ptr<PLSImpl> plsImpl,
+    const ContextOptions& contextOptions)
 {
-    auto plsContextImpl = std::unique_ptr<PLSRenderContextGLImpl>(
-        new PLSRenderContextGLImpl(rendererString, capabilities, std::move(plsImpl)));
+    auto plsContextImpl = std::unique_ptr<PLSRenderContextGLImpl>(new PLSRenderContextGLImpl(
+        rendererString,
+        capabilities,
+        std::move(plsImpl),
+        contextOptions));
     return std::make_unique<PLSRenderContext>(std::move(plsContextImpl));
 }
 } // namespace rive::pls
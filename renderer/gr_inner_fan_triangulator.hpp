@@ -22,16 +22,20 @@ class GrInnerFanTriangulator : private GrTriangulator
 public:
     using GrTriangulator::GroutTriangleList;
 
+    // If 'emitRedbookTriangles' is true, the triangles are emitted for stencil-based rendering
+    // instead of with winding weights. (See GrTriangulator::fEmitRedbookTriangles.)
     GrInnerFanTriangulator(const RawPath& path,
                            const Mat2D& viewMatrix,
                            Comparator::Direction direction,
                            FillRule fillRule,
-                           TrivialBlockAllocator* alloc) :
+                           TrivialBlockAllocator* alloc,
+                           bool emitRedbookTriangles = false) :
         GrTriangulator(direction, fillRule, alloc),
         m_shouldReverseTriangles(viewMatrix[0] * viewMatrix[3] - viewMatrix[2] * viewMatrix[1] < 0)
     {
         fPreserveCollinearVertices = true;
         fCollectGroutTriangles = true;
+        fEmitRedbookTriangles = emitRedbookTriangles;
         bool isLinear;
         auto [polys, success] = GrTriangulator::pathToPolys(path, 0, AABB{}, &isLinear);
         if (success)
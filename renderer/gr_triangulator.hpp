@@ -91,7 +91,7 @@ protected:
                             VertexList* back,
                             VertexList* result,
                             const Comparator&);
-    static void SortMesh(VertexList* vertices, const Comparator&);
+    static void SortMesh(VertexList* vertices, const Comparator&, TrivialBlockAllocator*);
 
     // 4) Simplify the mesh by inserting new vertices at intersecting edges:
     enum class SimplifyResult
@@ -114,7 +114,9 @@ protected:
                           pls::WriteOnlyMappedMemory<pls::TriangleVertex>*) const;
 
     // The vertex sorting in step (3) is a merge sort, since it plays well with the linked list
-    // of vertices (and the necessity of inserting new vertices on intersection).
+    // of vertices (and the necessity of inserting new vertices on intersection). Large meshes
+    // instead gather their vertices into temporary arrays and radix sort them on their coordinates,
+    // then relink the list in the new order.
     //
     // Stages (4) and (5) use an active edge list -- a list of all edges for which the
     // sweep line has crossed the top vertex, but not the bottom vertex.  It's sorted
@@ -148,6 +150,12 @@ protected:
     // Only type 2 vertices (see paper) require the O(N) lookups, and these are much less
     // frequent. There may be other data structures worth investigating, however.
     //
+    // TODO: Large polygons (e.g., map outlines) still spend most of their time in steps (4) and
+    // (5) chasing Vertex/Edge pointers. Two follow-ups remain, and each must beat the current code
+    // on those paths before it lands. (a) Move Vertex and Edge into index-based pools with SoA
+    // coordinates. (b) Give the active edge list a skip-list or balanced-tree index for the type 2
+    // lookups only, leaving the O(1) topological inserts and removals as they are.
+    //
     // Note that the orientation of the line sweep algorithms is determined by the aspect ratio of
     // the path bounds. When the path is taller than it is wide, we sort vertices based on
     // increasing Y coordinate, and secondarily by increasing X coordinate. When the path is wider
@@ -253,7 +261,9 @@ protected:
                                         float tolerance,
                                         const AABB& clipBounds,
                                         bool* isLinear);
-    static int64_t CountPoints(const Poly* polys, FillRule overrideFillRule);
+    static int64_t CountPoints(const Poly* polys,
+                               FillRule overrideFillRule,
+                               bool repeatByWinding = false);
     size_t countMaxTriangleVertices(const Poly*) const;
     size_t polysToTriangles(const Poly*,
                             uint64_t maxVertexCount,
@@ -274,6 +284,10 @@ protected:
 #endif
     bool fPreserveCollinearVertices = false;
     bool fCollectGroutTriangles = false;
+    // Emit triangles wound in the same direction as a classic Redbook fan, repeated abs(winding)
+    // times for nonZero, instead of once with a winding weight. (For stencil-based rendering,
+    // where each triangle can only change the winding number by 1.)
+    bool fEmitRedbookTriangles = false;
 
     // The grout triangles serve as a glue that erases T-junctions between a path's outer
     // curves and its inner polygon triangulation. Drawing a path's outer curves, grout
@@ -354,7 +368,7 @@ protected:
 /**
  * Vertices are used in three ways: first, the path contours are converted into a
  * circularly-linked list of Vertices for each contour. After edge construction, the same Vertices
- * are re-ordered by the merge sort according to the sweep_lt comparator (usually, increasing
+ * are re-ordered by the sort according to the sweep_lt comparator (usually, increasing
  * in Y) using the same fPrev/fNext pointers that were used for the contours, to avoid
  * reallocation. Finally, MonotonePolys are built containing a circularly-linked list of
  * Vertices. (Currently, those Vertices are newly-allocated for the MonotonePolys, since
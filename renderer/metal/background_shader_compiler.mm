@@ -198,6 +198,7 @@ void BackgroundShaderCompiler::threadMain()
 #endif
                 break;
             case DrawType::stencilClipReset:
+            case DrawType::analyticShapes:
                 RIVE_UNREACHABLE();
         }
 
@@ -128,6 +128,7 @@ public:
             case DrawType::plsAtomicInitialize:
             case DrawType::plsAtomicResolve:
             case DrawType::stencilClipReset:
+            case DrawType::analyticShapes:
                 RIVE_UNREACHABLE();
         }
 
@@ -266,7 +267,7 @@ protected:
         return m_buffers[bufferIdx].contents;
     }
 
-    void onUnmapAndSubmitBuffer(int bufferIdx, size_t mapSizeInBytes) override {}
+    void onUnmapAndSubmitBuffer(int bufferIdx, size_t updateSizeInBytes) override {}
 
 private:
     id<MTLBuffer> m_buffers[kBufferRingSize];
@@ -546,6 +547,37 @@ public:
                      bytesPerRow:width * 4];
     }
 
+    // Creates a texture in 'pixelFormat' from a block-compressed image and its own mip chain.
+    PLSTextureMetalImpl(id<MTLDevice> gpu,
+                        const CompressedImage& image,
+                        MTLPixelFormat pixelFormat) :
+        PLSTexture(image.width, image.height)
+    {
+        MTLTextureDescriptor* desc = [[MTLTextureDescriptor alloc] init];
+        desc.pixelFormat = pixelFormat;
+        desc.width = image.width;
+        desc.height = image.height;
+        desc.mipmapLevelCount = image.mipLevelCount;
+        desc.usage = MTLTextureUsageShaderRead;
+        desc.storageMode = MTLStorageModeShared;
+        desc.textureType = MTLTextureType2D;
+        m_texture = [gpu newTextureWithDescriptor:desc];
+
+        for (uint32_t level = 0; level < image.mipLevelCount; ++level)
+        {
+            uint32_t levelWidth = std::max(image.width >> level, 1u);
+            uint32_t levelHeight = std::max(image.height >> level, 1u);
+            // For compressed formats, bytesPerRow is the stride of one row of blocks.
+            [m_texture replaceRegion:MTLRegionMake2D(0, 0, levelWidth, levelHeight)
+                         mipmapLevel:level
+                           withBytes:image.mipLevelData[level]
+                         bytesPerRow:(levelWidth + 3) / 4 *
+                                     CompressedTextureBlockSizeInBytes(image.format)];
+        }
+        // Compressed textures aren't renderable, so they always bring their own mips.
+        m_mipsDirty = false;
+    }
+
     void ensureMipmaps(id<MTLCommandBuffer> commandBuffer) const
     {
         if (m_mipsDirty)
@@ -573,6 +605,57 @@ rcp<PLSTexture> PLSRenderContextMetalImpl::makeImageTexture(uint32_t width,
     return make_rcp<PLSTextureMetalImpl>(m_gpu, width, height, mipLevelCount, imageDataRGBA);
 }
 
+rcp<PLSTexture> PLSRenderContextMetalImpl::makeCompressedImageTexture(const CompressedImage& image)
+{
+    MTLPixelFormat pixelFormat = MTLPixelFormatInvalid;
+    // ETC2 and ASTC are supported by every Apple GPU, including Apple Silicon Macs.
+    if (@available(macOS 11, iOS 13, *))
+    {
+        if ([m_gpu supportsFamily:MTLGPUFamilyApple2])
+        {
+            switch (image.format)
+            {
+                case CompressedTextureFormat::etc2RGB8:
+                    pixelFormat = MTLPixelFormatETC2_RGB8;
+                    break;
+                case CompressedTextureFormat::etc2RGBA8:
+                    pixelFormat = MTLPixelFormatEAC_RGBA8;
+                    break;
+                case CompressedTextureFormat::astc4x4RGBA:
+                    pixelFormat = MTLPixelFormatASTC_4x4_LDR;
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+#if !defined(RIVE_IOS) && !defined(RIVE_IOS_SIMULATOR)
+    // Every Mac2-family GPU supports the BC formats.
+    if ([m_gpu supportsFamily:MTLGPUFamilyMac2])
+    {
+        switch (image.format)
+        {
+            case CompressedTextureFormat::bc1RGBA:
+                pixelFormat = MTLPixelFormatBC1_RGBA;
+                break;
+            case CompressedTextureFormat::bc3RGBA:
+                pixelFormat = MTLPixelFormatBC3_RGBA;
+                break;
+            case CompressedTextureFormat::bc7RGBA:
+                pixelFormat = MTLPixelFormatBC7_RGBAUnorm;
+                break;
+            default:
+                break;
+        }
+    }
+#endif
+    if (pixelFormat == MTLPixelFormatInvalid)
+    {
+        return nullptr;
+    }
+    return make_rcp<PLSTextureMetalImpl>(m_gpu, image, pixelFormat);
+}
+
 std::unique_ptr<BufferRing> PLSRenderContextMetalImpl::makeUniformBufferRing(size_t capacityInBytes)
 {
     return BufferRingMetalImpl::Make(m_gpu, capacityInBytes);
@@ -631,6 +714,35 @@ void PLSRenderContextMetalImpl::resizeTessellationTexture(uint32_t width, uint32
     m_tessVertexTexture = [m_gpu newTextureWithDescriptor:desc];
 }
 
+void PLSRenderContextMetalImpl::precompileShaders(const std::vector<pls::ShaderVariant>& variants)
+{
+    for (const pls::ShaderVariant& variant : variants)
+    {
+#ifdef RIVE_IOS
+        if (variant.interlockMode != pls::InterlockMode::rasterOrdering)
+        {
+            continue;
+        }
+#endif
+        if (variant.interlockMode == pls::InterlockMode::depthStencil)
+        {
+            continue;
+        }
+        uint32_t pipelineKey = variant.uniqueKey();
+        if (m_drawPipelines.find(pipelineKey) == m_drawPipelines.end())
+        {
+            // findCompatibleDrawPipeline() picks the result up once it's finished compiling.
+            m_backgroundShaderCompiler->pushJob({
+                .drawType = variant.drawType,
+                .shaderFeatures = variant.shaderFeatures,
+                .interlockMode = variant.interlockMode,
+                .shaderMiscFlags = variant.shaderMiscFlags,
+            });
+            m_drawPipelines.insert({pipelineKey, nullptr});
+        }
+    }
+}
+
 const PLSRenderContextMetalImpl::DrawPipeline* PLSRenderContextMetalImpl::
     findCompatibleDrawPipeline(pls::DrawType drawType,
                                pls::ShaderFeatures shaderFeatures,
@@ -1131,6 +1243,7 @@ void PLSRenderContextMetalImpl::flush(const FlushDescriptor& desc)
                 break;
             }
             case DrawType::stencilClipReset:
+            case DrawType::analyticShapes:
             {
                 RIVE_UNREACHABLE();
             }
@@ -14,6 +14,8 @@
 
 #include "rive/math/math_types.hpp"
 #include "rive/math/simd.hpp"
+#include "rive/math/wangs_formula.hpp"
+#include <vector>
 
 namespace rive::pathutils
 {
@@ -301,7 +303,6 @@ int FindCubicConvex180Chops(const Vec2D pts[], float T[2], bool* areCusps)
     return 0;
 }
 
-#if 0
 namespace
 {
 // This value only protects us against getting stuck in infinite recursion due to fp32 precision
@@ -317,185 +318,115 @@ constexpr static int kMaxChopsPerCurve = 128 /*magnitude of +fp32_max - -fp32_ma
                                          6 /*max number of chops to reduce the length by half*/ *
                                          6 /*max number of viewport boundary crosses*/;
 
-// Writes a new path, chopping as necessary so no verbs require more segments than
-// kMaxTessellationSegmentsPerCurve. Curves completely outside the viewport are flattened into
-// lines.
-class PathChopper
+// Returns true if the device-space points all lie outside the same edge of 'viewport', meaning
+// their convex hull doesn't touch it.
+bool are_outside_viewport(const Vec2D devPts[], int count, const AABB& viewport)
 {
-public:
-    PathChopper(float tessellationPrecision, const SkMatrix& matrix, const SkRect& viewport) :
-        fTessellationPrecision(tessellationPrecision),
-        fCullTest(viewport, matrix),
-        fVectorXform(matrix)
-    {
-        fPath.setIsVolatile(true);
-    }
-
-    SkPath path() const { return fPath; }
-
-    void moveTo(SkPoint p) { fPath.moveTo(p); }
-    void lineTo(const SkPoint p[2]) { fPath.lineTo(p[1]); }
-    void close() { fPath.close(); }
-
-    void quadTo(const SkPoint quad[3])
-    {
-        assert(fPointStack.empty());
-        // Use a heap stack to recursively chop the quad into manageable, on-screen segments.
-        fPointStack.push_back_n(3, quad);
-        int numChops = 0;
-        while (!fPointStack.empty())
-        {
-            const SkPoint* p = fPointStack.end() - 3;
-            if (!fCullTest.areVisible3(p))
-            {
-                fPath.lineTo(p[2]);
-            }
-            else
-            {
-                float n4 = wangs_formula::quadratic_p4(fTessellationPrecision, p, fVectorXform);
-                if (n4 > kMaxSegmentsPerCurve_p4 && numChops < kMaxChopsPerCurve)
-                {
-                    SkPoint chops[5];
-                    SkChopQuadAtHalf(p, chops);
-                    fPointStack.pop_back_n(3);
-                    fPointStack.push_back_n(3, chops + 2);
-                    fPointStack.push_back_n(3, chops);
-                    ++numChops;
-                    continue;
-                }
-                fPath.quadTo(p[1], p[2]);
-            }
-            fPointStack.pop_back_n(3);
-        }
-    }
-
-    void conicTo(const SkPoint conic[3], float weight)
+    uint32_t outsideEdges = 0xf;
+    for (int i = 0; i < count; ++i)
     {
-        assert(fPointStack.empty());
-        assert(fWeightStack.empty());
-        // Use a heap stack to recursively chop the conic into manageable, on-screen segments.
-        fPointStack.push_back_n(3, conic);
-        fWeightStack.push_back(weight);
-        int numChops = 0;
-        while (!fPointStack.empty())
-        {
-            const SkPoint* p = fPointStack.end() - 3;
-            float w = fWeightStack.back();
-            if (!fCullTest.areVisible3(p))
-            {
-                fPath.lineTo(p[2]);
-            }
-            else
-            {
-                float n2 = wangs_formula::conic_p2(fTessellationPrecision, p, w, fVectorXform);
-                if (n2 > kMaxSegmentsPerCurve_p2 && numChops < kMaxChopsPerCurve)
-                {
-                    SkConic chops[2];
-                    if (!SkConic(p, w).chopAt(.5, chops))
-                    {
-                        SkPoint line[2] = {p[0], p[2]};
-                        this->lineTo(line);
-                        continue;
-                    }
-                    fPointStack.pop_back_n(3);
-                    fWeightStack.pop_back();
-                    fPointStack.push_back_n(3, chops[1].fPts);
-                    fWeightStack.push_back(chops[1].fW);
-                    fPointStack.push_back_n(3, chops[0].fPts);
-                    fWeightStack.push_back(chops[0].fW);
-                    ++numChops;
-                    continue;
-                }
-                fPath.conicTo(p[1], p[2], w);
-            }
-            fPointStack.pop_back_n(3);
-            fWeightStack.pop_back();
-        }
-        assert(fWeightStack.empty());
+        outsideEdges &= (devPts[i].x < viewport.left() ? 1 : 0) |
+                        (devPts[i].y < viewport.top() ? 2 : 0) |
+                        (devPts[i].x > viewport.right() ? 4 : 0) |
+                        (devPts[i].y > viewport.bottom() ? 8 : 0);
     }
+    return outsideEdges != 0;
+}
 
-    void cubicTo(const SkPoint cubic[4])
+// Writes a new path, chopping as necessary so no cubics require more than 'maxParametricSegments'.
+// Cubics completely outside the viewport are flattened into lines.
+class PathChopper
+{
+public:
+    PathChopper(const Mat2D& matrix,
+                const AABB& viewport,
+                float parametricPrecision,
+                float maxParametricSegments,
+                RawPath* dst) :
+        m_matrix(matrix),
+        m_viewport(viewport),
+        m_parametricPrecision(parametricPrecision),
+        m_maxParametricSegmentsPow4(powf(maxParametricSegments, 4)),
+        m_vectorXform(matrix),
+        m_dst(dst)
+    {}
+
+    void cubicTo(const Vec2D cubic[4])
     {
-        assert(fPointStack.empty());
+        assert(m_pointStack.empty());
         // Use a heap stack to recursively chop the cubic into manageable, on-screen segments.
-        fPointStack.push_back_n(4, cubic);
+        m_pointStack.insert(m_pointStack.end(), cubic, cubic + 4);
         int numChops = 0;
-        while (!fPointStack.empty())
+        while (!m_pointStack.empty())
         {
-            SkPoint* p = fPointStack.end() - 4;
-            if (!fCullTest.areVisible4(p))
+            const Vec2D* p = m_pointStack.data() + m_pointStack.size() - 4;
+            Vec2D devPts[4];
+            m_matrix.mapPoints(devPts, p, 4);
+            if (are_outside_viewport(devPts, 4, m_viewport))
             {
-                fPath.lineTo(p[3]);
+                m_dst->line(p[3]);
             }
             else
             {
-                float n4 = wangs_formula::cubic_p4(fTessellationPrecision, p, fVectorXform);
-                if (n4 > kMaxSegmentsPerCurve_p4 && numChops < kMaxChopsPerCurve)
+                float n4 = wangs_formula::cubic_pow4(p, m_parametricPrecision, m_vectorXform);
+                if (n4 > m_maxParametricSegmentsPow4 && numChops < kMaxChopsPerCurve)
                 {
-                    SkPoint chops[7];
-                    SkChopCubicAtHalf(p, chops);
-                    fPointStack.pop_back_n(4);
-                    fPointStack.push_back_n(4, chops + 3);
-                    fPointStack.push_back_n(4, chops);
+                    Vec2D chops[7];
+                    ChopCubicAt(p, chops, .5f);
+                    m_pointStack.resize(m_pointStack.size() - 4);
+                    m_pointStack.insert(m_pointStack.end(), chops + 3, chops + 7);
+                    m_pointStack.insert(m_pointStack.end(), chops, chops + 4);
                     ++numChops;
                     continue;
                 }
-                fPath.cubicTo(p[1], p[2], p[3]);
+                m_dst->cubic(p[1], p[2], p[3]);
             }
-            fPointStack.pop_back_n(4);
+            m_pointStack.resize(m_pointStack.size() - 4);
         }
     }
 
 private:
-    const float fTessellationPrecision;
-    const CullTest fCullTest;
-    const wangs_formula::VectorXform fVectorXform;
-    SkPath fPath;
+    const Mat2D m_matrix;
+    const AABB m_viewport;
+    const float m_parametricPrecision;
+    const float m_maxParametricSegmentsPow4;
+    const wangs_formula::VectorXform m_vectorXform;
+    RawPath* const m_dst;
 
     // Used for stack-based recursion (instead of using the runtime stack).
-    SkSTArray<8, SkPoint> fPointStack;
-    SkSTArray<2, float> fWeightStack;
+    std::vector<Vec2D> m_pointStack;
 };
 } // namespace
 
-SkPath PreChopPathCurves(float tessellationPrecision,
-                         const SkPath& path,
-                         const SkMatrix& matrix,
-                         const SkRect& viewport)
+void PreChopPathCurves(const RawPath& path,
+                       const Mat2D& matrix,
+                       const AABB& viewport,
+                       float parametricPrecision,
+                       float maxParametricSegments,
+                       RawPath* dst)
 {
-    // If the viewport is exceptionally large, we could end up blowing out memory with an unbounded
-    // number of of chops. Therefore, we require that the viewport is manageable enough that a fully
-    // contained curve can be tessellated in kMaxTessellationSegmentsPerCurve or fewer. (Any larger
-    // and that amount of pixels wouldn't fit in memory anyway.)
-    assert(wangs_formula::worst_case_cubic(tessellationPrecision,
-                                             viewport.width(),
-                                             viewport.height()) <= kMaxSegmentsPerCurve);
-    PathChopper chopper(tessellationPrecision, matrix, viewport);
-    for (auto [verb, p, w] : SkPathPriv::Iterate(path))
+    assert(dst != &path);
+    dst->rewind();
+    PathChopper chopper(matrix, viewport, parametricPrecision, maxParametricSegments, dst);
+    for (const auto [verb, pts] : path)
     {
         switch (verb)
         {
-            case SkPathVerb::kMove:
-                chopper.moveTo(p[0]);
-                break;
-            case SkPathVerb::kLine:
-                chopper.lineTo(p);
-                break;
-            case SkPathVerb::kQuad:
-                chopper.quadTo(p);
+            case PathVerb::move:
+                dst->move(pts[0]);
                 break;
-            case SkPathVerb::kConic:
-                chopper.conicTo(p, *w);
+            case PathVerb::line:
+                dst->line(pts[1]);
                 break;
-            case SkPathVerb::kCubic:
-                chopper.cubicTo(p);
+            case PathVerb::quad:
+                RIVE_UNREACHABLE();
+            case PathVerb::cubic:
+                chopper.cubicTo(pts);
                 break;
-            case SkPathVerb::kClose:
-                chopper.close();
+            case PathVerb::close:
+                dst->close();
                 break;
         }
     }
-    return chopper.path();
 }
-#endif
 } // namespace rive::pathutils
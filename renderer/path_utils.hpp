@@ -12,6 +12,9 @@
 
 #pragma once
 
+#include "rive/math/aabb.hpp"
+#include "rive/math/mat2d.hpp"
+#include "rive/math/raw_path.hpp"
 #include "rive/math/vec2d.hpp"
 #include <math.h>
 
@@ -20,9 +23,9 @@ namespace rive::pathutils
 // Decides the number of polar segments the tessellator adds for each curve. (Uniform steps in
 // tangent angle.) The tessellator will add this number of polar segments for each radian of
 // rotation in local path space.
-template <int Precision> float CalcPolarSegmentsPerRadian(float approxDevStrokeRadius)
+inline float CalcPolarSegmentsPerRadian(float polarPrecision, float approxDevStrokeRadius)
 {
-    float cosTheta = 1.f - (1.f / Precision) / approxDevStrokeRadius;
+    float cosTheta = 1.f - (1.f / polarPrecision) / approxDevStrokeRadius;
     return .5f / acosf(std::max(cosTheta, -1.f));
 }
 
@@ -57,15 +60,15 @@ float MeasureAngleBetweenVectors(Vec2D a, Vec2D b);
 // point(s) occurred at 180-degree turnaround points on a degenerate flat line.
 int FindCubicConvex180Chops(const Vec2D[], float T[2], bool* areCusps);
 
-#if 0
-// Returns a new path, equivalent to 'path' within the given viewport, whose verbs can all be drawn
-// with 'maxSegments' tessellation segments or fewer, while staying within '1/tessellationPrecision'
-// pixels of the true curve. Curves and chops that fall completely outside the viewport are
-// flattened into lines.
-SkPath PreChopPathCurves(float tessellationPrecision,
-                         const SkPath&,
-                         const SkMatrix&,
-                         const SkRect& viewport);
-#endif
+// Writes a new path to 'dst', equivalent to 'path' within the given device-space viewport, whose
+// cubics can all be drawn with 'maxParametricSegments' or fewer while staying within
+// '1/parametricPrecision' pixels of the true curve. Curves (and chops) whose control points fall
+// completely outside the viewport are flattened into lines.
+void PreChopPathCurves(const RawPath& path,
+                       const Mat2D& matrix,
+                       const AABB& viewport,
+                       float parametricPrecision,
+                       float maxParametricSegments,
+                       RawPath* dst);
 
 } // namespace rive::pathutils
@@ -11,6 +11,12 @@
 
 #include "shaders/out/generated/draw_path.exports.h"
 
+#include <algorithm>
+#include <array>
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+
 namespace rive::pls
 {
 static_assert(kGradTextureWidth == GRAD_TEXTURE_WIDTH);
@@ -60,6 +66,10 @@ uint32_t ShaderUniqueKey(DrawType drawType,
             assert(interlockMode == pls::InterlockMode::depthStencil);
             drawTypeKey = 6;
             break;
+        case DrawType::analyticShapes:
+            assert(interlockMode != pls::InterlockMode::depthStencil);
+            drawTypeKey = 7;
+            break;
     }
     uint32_t key = static_cast<uint32_t>(miscFlags);
     assert(static_cast<uint32_t>(interlockMode) < 1 << 2);
@@ -71,6 +81,120 @@ uint32_t ShaderUniqueKey(DrawType drawType,
     return key;
 }
 
+// Bump the version whenever the meaning of ShaderVariant's fields changes.
+constexpr static char kShaderManifestHeader[] = "rive_pls_shader_manifest 1";
+
+// Mirrors the assertions in ShaderUniqueKey(), so a malformed manifest can't trip them.
+static bool is_valid_shader_variant(const ShaderVariant& variant)
+{
+    switch (variant.drawType)
+    {
+        case DrawType::midpointFanPatches:
+        case DrawType::outerCurvePatches:
+        case DrawType::interiorTriangulation:
+        case DrawType::imageMesh:
+            break;
+        case DrawType::imageRect:
+        case DrawType::plsAtomicInitialize:
+        case DrawType::plsAtomicResolve:
+            if (variant.interlockMode != InterlockMode::atomics)
+            {
+                return false;
+            }
+            break;
+        case DrawType::stencilClipReset:
+            if (variant.interlockMode != InterlockMode::depthStencil)
+            {
+                return false;
+            }
+            break;
+        case DrawType::analyticShapes:
+            if (variant.interlockMode == InterlockMode::depthStencil)
+            {
+                return false;
+            }
+            break;
+    }
+    if ((variant.shaderMiscFlags & ShaderMiscFlags::coalescedResolveAndTransfer) &&
+        (variant.drawType != DrawType::plsAtomicResolve ||
+         !(variant.shaderFeatures & ShaderFeatures::ENABLE_ADVANCED_BLEND)))
+    {
+        return false;
+    }
+    if ((variant.shaderMiscFlags &
+         (ShaderMiscFlags::storeColorClear | ShaderMiscFlags::swizzleColorBGRAToRGBA)) &&
+        variant.drawType != DrawType::plsAtomicInitialize)
+    {
+        return false;
+    }
+    return true;
+}
+
+std::string WriteShaderManifest(const std::vector<ShaderVariant>& variants)
+{
+    std::string manifest = kShaderManifestHeader;
+    manifest.push_back('\n');
+    for (const ShaderVariant& variant : variants)
+    {
+        char line[64];
+        snprintf(line,
+                 sizeof(line),
+                 "%u %u 0x%x 0x%x\n",
+                 static_cast<unsigned int>(variant.drawType),
+                 static_cast<unsigned int>(variant.interlockMode),
+                 static_cast<unsigned int>(variant.shaderFeatures),
+                 static_cast<unsigned int>(variant.shaderMiscFlags));
+        manifest.append(line);
+    }
+    return manifest;
+}
+
+bool ParseShaderManifest(const char* manifest, std::vector<ShaderVariant>* variants)
+{
+    size_t headerLength = strlen(kShaderManifestHeader);
+    if (strncmp(manifest, kShaderManifestHeader, headerLength) != 0)
+    {
+        return false;
+    }
+    const char* cursor = manifest + headerLength;
+    for (;;)
+    {
+        while (isspace(*cursor))
+        {
+            ++cursor;
+        }
+        if (*cursor == '\0')
+        {
+            return true;
+        }
+        unsigned int drawType, interlockMode, shaderFeatures, shaderMiscFlags;
+        int charsRead = 0;
+        if (sscanf(cursor,
+                   "%u %u %x %x%n",
+                   &drawType,
+                   &interlockMode,
+                   &shaderFeatures,
+                   &shaderMiscFlags,
+                   &charsRead) != 4 ||
+            drawType > static_cast<unsigned int>(DrawType::analyticShapes) ||
+            interlockMode > static_cast<unsigned int>(InterlockMode::depthStencil) ||
+            (shaderFeatures & ~static_cast<unsigned int>(kAllShaderFeatures)) != 0)
+        {
+            return false;
+        }
+        ShaderVariant variant = {static_cast<DrawType>(drawType),
+                                 static_cast<ShaderFeatures>(shaderFeatures),
+                                 static_cast<InterlockMode>(interlockMode),
+                                 static_cast<ShaderMiscFlags>(shaderMiscFlags)};
+        if (!is_valid_shader_variant(variant))
+        {
+            return false;
+        }
+        variants->push_back(variant);
+        cursor += charsRead;
+    }
+}
+
 const char* GetShaderFeatureGLSLName(ShaderFeatures feature)
 {
     switch (feature)
@@ -385,16 +509,19 @@ static void write_matrix(volatile float* dst, const Mat2D& matrix)
     }
 }
 
-void PathData::set(const Mat2D& m, float strokeRadius, uint32_t zIndex)
+void PathData::set(const Mat2D& m, float strokeRadius, uint32_t zIndex, uint32_t paintID)
 {
+    assert(zIndex <= 0xffff);
+    assert(paintID <= 0xffff);
     write_matrix(m_matrix, m);
     m_strokeRadius = strokeRadius; // 0 if the path is filled.
-    m_zIndex = zIndex;
+    m_paintIDAndZIndex = (paintID << 16) | zIndex;
 }
 
 void PaintData::set(FillRule fillRule,
                     PaintType paintType,
                     SimplePaintValue simplePaintValue,
+                    const PLSTexture* imageTexture,
                     GradTextureLayout gradTextureLayout,
                     uint32_t clipID,
                     bool hasClipRect,
@@ -429,12 +556,20 @@ void PaintData::set(FillRule fillRule,
         {
             m_opacity = simplePaintValue.imageOpacity;
             localParams |= shiftedClipID | shiftedBlendMode;
+            if (imageTexture->hasPremultipliedAlpha())
+            {
+                localParams |= PAINT_FLAG_PREMULTIPLIED_IMAGE;
+            }
             break;
         }
         case PaintType::clipUpdate:
         {
             m_shiftedClipReplacementID = shiftedClipID;
             localParams |= simplePaintValue.outerClipID << 16;
+            if (imageTexture != nullptr)
+            {
+                localParams |= PAINT_FLAG_CLIP_MASK;
+            }
             break;
         }
     }
@@ -464,6 +599,15 @@ void PaintAuxData::set(const Mat2D& viewMatrix,
         {
             break;
         }
+        case PaintType::clipUpdate:
+        {
+            if (imageTexture == nullptr)
+            {
+                break;
+            }
+            // Clip masks are sampled the same way as image paints.
+            [[fallthrough]];
+        }
         case PaintType::linearGradient:
         case PaintType::radialGradient:
         case PaintType::image:
@@ -475,7 +619,7 @@ void PaintAuxData::set(const Mat2D& viewMatrix,
                 // Flip _fragCoord.y.
                 paintMatrix = paintMatrix * Mat2D(1, 0, 0, -1, 0, renderTarget->height());
             }
-            if (paintType == PaintType::image)
+            if (imageTexture != nullptr)
             {
                 uint64_t bindlessTextureHandle = imageTexture->bindlessTextureHandle();
                 m_bindlessTextureHandle[0] = bindlessTextureHandle;
@@ -514,10 +658,6 @@ void PaintAuxData::set(const Mat2D& viewMatrix,
             write_matrix(m_matrix, paintMatrix);
             break;
         }
-        case PaintType::clipUpdate:
-        {
-            break;
-        }
     }
 
     if (clipRectInverseMatrix != nullptr)
@@ -542,13 +682,16 @@ void PaintAuxData::set(const Mat2D& viewMatrix,
 
 ImageDrawUniforms::ImageDrawUniforms(const Mat2D& matrix,
                                      float opacity,
+                                     const PLSTexture* imageTexture,
                                      const ClipRectInverseMatrix* clipRectInverseMatrix,
                                      uint32_t clipID,
                                      BlendMode blendMode,
-                                     uint32_t zIndex)
+                                     uint32_t zIndex,
+                                     const AABB& texCoordRect)
 {
     write_matrix(m_matrix, matrix);
     m_opacity = opacity;
+    m_flags = imageTexture->hasPremultipliedAlpha() ? IMAGE_DRAW_FLAG_PREMULTIPLIED : 0;
     write_matrix(m_clipRectInverseMatrix,
                  clipRectInverseMatrix != nullptr
                      ? clipRectInverseMatrix->inverseMatrix()
@@ -556,6 +699,10 @@ ImageDrawUniforms::ImageDrawUniforms(const Mat2D& matrix,
     m_clipID = clipID;
     m_blendMode = ConvertBlendModeToPLSBlendMode(blendMode);
     m_zIndex = zIndex;
+    m_texCoordTransform[0] = texCoordRect.width();
+    m_texCoordTransform[1] = texCoordRect.height();
+    m_texCoordTransform[2] = texCoordRect.left();
+    m_texCoordTransform[3] = texCoordRect.top();
 }
 
 std::tuple<uint32_t, uint32_t> StorageTextureSize(size_t bufferSizeInBytes,
@@ -594,4 +741,151 @@ float FindTransformedArea(const AABB& bounds, const Mat2D& matrix)
                   screenSpacePts[3] - screenSpacePts[0]};
     return (fabsf(Vec2D::cross(v[0], v[1])) + fabsf(Vec2D::cross(v[1], v[2]))) * .5f;
 }
+
+TriangulationCostFeatures FindTriangulationCostFeatures(const PathCostMetrics& metrics,
+                                                        float boundsPixelArea,
+                                                        const Mat2D& matrix,
+                                                        InterlockMode interlockMode)
+{
+    TriangulationCostFeatures features;
+    float pixelScale = fabsf(matrix.xx() * matrix.yy() - matrix.xy() * matrix.yx());
+    features.fanOverdrawPixels =
+        std::clamp((metrics.coarseFanArea - fabsf(metrics.coarseArea)) * pixelScale,
+                   0.f,
+                   boundsPixelArea);
+    features.verbCount = static_cast<float>(metrics.verbCount);
+    features.contourCount = static_cast<float>(metrics.contourCount);
+    // We need a barrier between the outer cubics and interior triangles in atomic mode.
+    features.barrierCount = interlockMode == InterlockMode::atomics ? 1 : 0;
+    // depthStencil mode stencils the outer curves along with the interior, then draws them again to
+    // cover the regions the interior triangles couldn't fill on their own.
+    features.coverPassCount = interlockMode == InterlockMode::depthStencil ? 1 : 0;
+    return features;
+}
+
+TriangulationCostModel FitTriangulationCostModel(const TriangulationCostSample* samples,
+                                                 size_t sampleCount,
+                                                 const TriangulationCostModel& fallback)
+{
+    // triangulationSavings() is linear in the weights, with one term per weight.
+    constexpr static int kWeightCount = 6;
+    auto terms = [](const TriangulationCostFeatures& f) {
+        return std::array<double, kWeightCount>{f.fanOverdrawPixels,
+                                                -1,
+                                                -f.verbCount,
+                                                -f.contourCount,
+                                                -f.barrierCount,
+                                                -f.coverPassCount};
+    };
+    std::array<double, kWeightCount> weights = {fallback.fanOverdrawPixelCost,
+                                                fallback.triangulationFixedCost,
+                                                fallback.triangulationVerbCost,
+                                                fallback.triangulationContourCost,
+                                                fallback.barrierCost,
+                                                fallback.coverPassCost};
+
+    // Only fit the weights whose terms are nonzero in at least one sample.
+    std::array<bool, kWeightCount> isActive{};
+    for (size_t i = 0; i < sampleCount; ++i)
+    {
+        auto t = terms(samples[i].features);
+        for (int j = 0; j < kWeightCount; ++j)
+        {
+            isActive[j] = isActive[j] || t[j] != 0;
+        }
+    }
+    int activeIdx[kWeightCount];
+    int n = 0;
+    for (int j = 0; j < kWeightCount; ++j)
+    {
+        if (isActive[j])
+        {
+            activeIdx[n++] = j;
+        }
+    }
+    if (!isActive[0] || sampleCount < static_cast<size_t>(n))
+    {
+        return fallback;
+    }
+
+    // Build the normal equations, (A^T A) x = A^T y. Inactive weights keep their fallback values.
+    double ata[kWeightCount][kWeightCount + 1]{};
+    for (size_t i = 0; i < sampleCount; ++i)
+    {
+        auto t = terms(samples[i].features);
+        double y = samples[i].measuredSavings;
+        for (int j = 0; j < kWeightCount; ++j)
+        {
+            if (!isActive[j])
+            {
+                y -= t[j] * weights[j];
+            }
+        }
+        for (int r = 0; r < n; ++r)
+        {
+            for (int c = 0; c < n; ++c)
+            {
+                ata[r][c] += t[activeIdx[r]] * t[activeIdx[c]];
+            }
+            ata[r][n] += t[activeIdx[r]] * y;
+        }
+    }
+
+    // Solve with Gaussian elimination and partial pivoting.
+    double scale = 0;
+    for (int k = 0; k < n; ++k)
+    {
+        scale = std::max(scale, ata[k][k]);
+    }
+    for (int k = 0; k < n; ++k)
+    {
+        int pivot = k;
+        for (int r = k + 1; r < n; ++r)
+        {
+            if (fabs(ata[r][k]) > fabs(ata[pivot][k]))
+            {
+                pivot = r;
+            }
+        }
+        if (!(fabs(ata[pivot][k]) > scale * 1e-12))
+        {
+            return fallback; // The samples don't distinguish between some of the weights.
+        }
+        for (int c = k; c <= n; ++c)
+        {
+            std::swap(ata[k][c], ata[pivot][c]);
+        }
+        for (int r = k + 1; r < n; ++r)
+        {
+            double f = ata[r][k] / ata[k][k];
+            for (int c = k; c <= n; ++c)
+            {
+                ata[r][c] -= f * ata[k][c];
+            }
+        }
+    }
+    for (int k = n - 1; k >= 0; --k)
+    {
+        double x = ata[k][n];
+        for (int c = k + 1; c < n; ++c)
+        {
+            x -= ata[k][c] * weights[activeIdx[c]];
+        }
+        // Costs can't be negative; clamp out the noise.
+        weights[activeIdx[k]] = std::max(x / ata[k][k], 0.0);
+    }
+    if (!(weights[0] > 0))
+    {
+        return fallback; // Fan overdraw has to cost something, or we would never triangulate.
+    }
+
+    TriangulationCostModel model;
+    model.fanOverdrawPixelCost = static_cast<float>(weights[0]);
+    model.triangulationFixedCost = static_cast<float>(weights[1]);
+    model.triangulationVerbCost = static_cast<float>(weights[2]);
+    model.triangulationContourCost = static_cast<float>(weights[3]);
+    model.barrierCost = static_cast<float>(weights[4]);
+    model.coverPassCost = static_cast<float>(weights[5]);
+    return model;
+}
 } // namespace rive::pls
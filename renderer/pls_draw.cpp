@@ -4,12 +4,14 @@
 
 #include "rive/pls/pls_draw.hpp"
 
+#include "cubic_batch.hpp"
 #include "gr_inner_fan_triangulator.hpp"
 #include "path_utils.hpp"
 #include "pls_path.hpp"
 #include "pls_paint.hpp"
 #include "rive/math/wangs_formula.hpp"
 #include "rive/pls/pls_image.hpp"
+#include "rive/pls/pls_renderer.hpp"
 #include "shaders/constants.glsl"
 
 namespace rive::pls
@@ -17,6 +19,8 @@ namespace rive::pls
 namespace
 {
 constexpr static int kNumSegmentsInMiterOrBevelJoin = 5;
+// Strokes no wider than this many device pixels are drawn as hairlines.
+constexpr static float kHairlineMaxPixelWidth = 1;
 constexpr static int kStrokeStyleFlag = 8;
 constexpr static int kRoundJoinStyleFlag = kStrokeStyleFlag << 1;
 RIVE_ALWAYS_INLINE constexpr int style_flags(bool isStroked, bool roundJoinStroked)
@@ -324,6 +328,123 @@ void PLSDraw::releaseRefs()
     safe_unref(m_gradientRef);
 }
 
+uint64_t PLSDraw::contentHash() const
+{
+    uint64_t hash = kFNVOffsetBasis;
+    hash = HashValue(hash, m_type);
+    hash = HashValue(hash, m_matrix);
+    hash = HashValue(hash, m_blendMode);
+    hash = HashValue(hash, m_drawContents);
+    hash = HashValue(hash, m_clipID);
+    if (m_clipRectInverseMatrix != nullptr)
+    {
+        hash = HashValue(hash, m_clipRectInverseMatrix->inverseMatrix());
+    }
+    if (m_imageTextureRef != nullptr)
+    {
+        hash = HashValue(hash, m_imageTextureRef->textureResourceHash());
+    }
+    if (m_gradientRef != nullptr)
+    {
+        // The colorRampLocation in m_simplePaintValue is assigned per flush. Hash the gradient's
+        // contents instead.
+        hash = m_gradientRef->hashContents(hash);
+    }
+    else
+    {
+        hash = HashValue(hash, m_simplePaintValue);
+    }
+    return hash;
+}
+
+// Paths whose device-space bounds are this many times larger than their visible area get
+// pre-chopped against the viewport before tessellation.
+constexpr static float kPreChopVisibleAreaRatio = 4;
+
+// Combines the frame's and the paint's tessellation quality.
+static float find_tessellation_quality(const PLSRenderContext* context, const PLSPaint* paint)
+{
+    float quality =
+        context->frameDescriptor().tessellationQuality * paint->getTessellationQuality();
+    return std::clamp(quality, kMinTessellationQuality, 1.f);
+}
+
+// Number of tessellation spans that each line or curve occupies. A full pls::TessVertexSpan packs
+// the forward and mirrored copies of a curve together, but compact spans store them separately.
+// (Counted in compact units even if the frame falls back to full spans, since that never
+// undercounts.)
+static size_t find_tess_spans_per_segment(const PLSRenderContext* context,
+                                          pls::ContourDirections contourDirections)
+{
+    return context->platformFeatures().compactTessVertexSpans &&
+                   contourDirections == pls::ContourDirections::reverseAndForward
+               ? 2
+               : 1;
+}
+
+// Largest magnitude of any coordinate in [pts, end), measured as an offset from origin.
+static float find_max_offset(const Vec2D* pts, const Vec2D* end, Vec2D origin)
+{
+    float maxOffset = 0;
+    for (; pts != end; ++pts)
+    {
+        Vec2D offset = *pts - origin;
+        maxOffset = std::max({maxOffset, fabsf(offset.x), fabsf(offset.y)});
+    }
+    return maxOffset;
+}
+
+// Compact tessellation spans store control points as fp16 offsets from their contour's origin.
+// Switches the frame back to full pls::TessVertexSpans if offsets as large as maxOffset would
+// overflow fp16, or would round off by more than half the flattening tolerance in device space.
+static void check_compact_tess_span_precision(PLSRenderContext* context,
+                                              float maxOffset,
+                                              const Mat2D& matrix,
+                                              float parametricPrecision)
+{
+    if (!context->frameUsesCompactTessVertexSpans())
+    {
+        return;
+    }
+    // fp16 has an 11-bit significand, so rounding moves each coordinate by at most
+    // |offset| * 2^-11. (The negated comparisons also catch NaN.)
+    constexpr static float kMaxFP16 = 65504;
+    float maxDeviceError = maxOffset * (1.f / 2048) * math::SQRT2 * matrix.findMaxScale();
+    if (!(maxOffset < kMaxFP16) || !(maxDeviceError <= .5f / parametricPrecision))
+    {
+        context->disableCompactTessVertexSpans();
+    }
+}
+
+// Chooses between midpoint fans and interior triangulation for a filled path.
+static bool should_use_interior_triangulation(const PLSRenderContext* context,
+                                              const PLSPath* path,
+                                              const AABB& localBounds,
+                                              const Mat2D& matrix)
+{
+    switch (context->frameDescriptor().fillAlgorithm)
+    {
+        case pls::FillAlgorithm::costModel:
+            break;
+        case pls::FillAlgorithm::midpointFans:
+            return false;
+        case pls::FillAlgorithm::interiorTriangulation:
+            return true;
+    }
+    const pls::TriangulationCostModel& costModel = context->triangulationCostModel();
+    float boundsPixelArea = pls::FindTransformedArea(localBounds, matrix);
+    if (!costModel.canTriangulationSaveAnything(boundsPixelArea))
+    {
+        return false;
+    }
+    pls::TriangulationCostFeatures features =
+        pls::FindTriangulationCostFeatures(path->getCoarseMetrics(),
+                                           boundsPixelArea,
+                                           matrix,
+                                           context->frameInterlockMode());
+    return costModel.triangulationSavings(features) > 0;
+}
+
 PLSDrawUniquePtr PLSPathDraw::Make(PLSRenderContext* context,
                                    const Mat2D& matrix,
                                    rcp<const PLSPath> path,
@@ -333,6 +454,14 @@ PLSDrawUniquePtr PLSPathDraw::Make(PLSRenderContext* context,
 {
     assert(path != nullptr);
     assert(paint != nullptr);
+    if (context->frameSupportsAnalyticShapes())
+    {
+        // Rects, rounded rects, and ellipses don't need to be tessellated at all.
+        if (PLSDrawUniquePtr analyticShape = AnalyticShapeDraw::Make(context, matrix, path, paint))
+        {
+            return analyticShape;
+        }
+    }
     AABB mappedBounds;
     if (context->frameInterlockMode() == pls::InterlockMode::atomics)
     {
@@ -347,6 +476,7 @@ PLSDrawUniquePtr PLSPathDraw::Make(PLSRenderContext* context,
     }
     assert(mappedBounds.width() >= 0);
     assert(mappedBounds.height() >= 0);
+    AABB strokePixelOutset = {};
     if (paint->getIsStroked())
     {
         // Outset the path's bounding box to account for stroking.
@@ -359,18 +489,44 @@ PLSDrawUniquePtr PLSPathDraw::Make(PLSRenderContext* context,
         {
             strokeOutset *= math::SQRT2;
         }
-        AABB strokePixelOutset = matrix.mapBoundingBox({0, 0, strokeOutset, strokeOutset});
+        strokePixelOutset = matrix.mapBoundingBox({0, 0, strokeOutset, strokeOutset});
         mappedBounds = mappedBounds.inset(-strokePixelOutset.width(), -strokePixelOutset.height());
     }
     IAABB pixelBounds = mappedBounds.roundOut();
+
+    // Deep zooms and paths that lie mostly off screen can generate enormous tessellation counts for
+    // geometry nobody will see. Pre-chop these paths so their visible curves never exceed
+    // kMaxParametricSegments, and flatten any curves that lie completely outside the viewport.
+    // (Outset the viewport by the stroke radius so flattened curves can't affect visible pixels.)
+    const PLSRenderContext::FrameDescriptor& frameDesc = context->frameDescriptor();
+    AABB viewport = AABB(0,
+                         0,
+                         static_cast<float>(frameDesc.renderTargetWidth),
+                         static_cast<float>(frameDesc.renderTargetHeight))
+                        .inset(-strokePixelOutset.width() - 1, -strokePixelOutset.height() - 1);
+    float visibleWidth = std::min(mappedBounds.right(), viewport.right()) -
+                         std::max(mappedBounds.left(), viewport.left());
+    float visibleHeight = std::min(mappedBounds.bottom(), viewport.bottom()) -
+                          std::max(mappedBounds.top(), viewport.top());
+    if (visibleWidth > 0 && visibleHeight > 0 &&
+        visibleWidth * visibleHeight * kPreChopVisibleAreaRatio <
+            mappedBounds.width() * mappedBounds.height())
+    {
+        path = path->getPreChoppedPath(fillRule,
+                                       matrix,
+                                       viewport,
+                                       kParametricPrecision *
+                                           find_tessellation_quality(context, paint),
+                                       kMaxParametricSegments,
+                                       scratchPath);
+    }
+
     if (!paint->getIsStroked())
     {
-        // Use interior triangulation to draw filled paths if they're large enough to benefit from
-        // it.
+        // Use interior triangulation to draw filled paths if the cost model predicts the fan
+        // overdraw it saves will outweigh the extra CPU work.
         const AABB& localBounds = path->getBounds();
-        // FIXME! Implement interior triangulation in depthStencil mode.
-        if (context->frameInterlockMode() != pls::InterlockMode::depthStencil &&
-            pls::FindTransformedArea(localBounds, matrix) > 512 * 512)
+        if (should_use_interior_triangulation(context, path.get(), localBounds, matrix))
         {
             return PLSDrawUniquePtr(context->make<InteriorTriangulationDraw>(
                 context,
@@ -428,6 +584,25 @@ PLSPathDraw::PLSPathDraw(IAABB pixelBounds,
             m_drawContents |= pls::DrawContents::activeClip;
         }
     }
+    else if ((m_drawContents & pls::DrawContents::opaquePaint) && !paint->getIsStroked() &&
+             matrix.xy() == 0 && matrix.yx() == 0)
+    {
+        // Opaque, axis-aligned rectangles (backgrounds, card bodies, etc.) completely cover every
+        // pixel that lies fully inside them.
+        AABB rect;
+        if (PLSRenderer::IsAABB(m_pathRef->getRawPath(), &rect))
+        {
+            AABB pixelRect = matrix.mapBoundingBox(rect);
+            IAABB coverage = {static_cast<int32_t>(ceilf(pixelRect.left())),
+                              static_cast<int32_t>(ceilf(pixelRect.top())),
+                              static_cast<int32_t>(floorf(pixelRect.right())),
+                              static_cast<int32_t>(floorf(pixelRect.bottom()))};
+            if (!coverage.empty())
+            {
+                m_opaqueCoverageBounds = coverage;
+            }
+        }
+    }
 
     if (isStroked())
     {
@@ -439,7 +614,7 @@ PLSPathDraw::PLSPathDraw(IAABB pixelBounds,
         // atomic and rasterOrdering fills need reverse AND forward triangles.
         m_contourDirections = pls::ContourDirections::reverseAndForward;
     }
-    else if (m_fillRule != FillRule::evenOdd)
+    else if (m_fillRule != FillRule::evenOdd && type == Type::midpointFanPath)
     {
         // Emit "nonZero" depthStencil fills in a direction such that the dominant triangle winding
         // area is always clockwise. This maximizes pixel throughput since we will draw
@@ -451,7 +626,9 @@ PLSPathDraw::PLSPathDraw(IAABB pixelBounds,
     }
     else
     {
-        // "evenOdd" depthStencil fils just get drawn twice, so any direction is fine.
+        // "evenOdd" depthStencil fils just get drawn twice, so any direction is fine. Interior
+        // triangulations are also stencilled, but their outer curves have to be forward in order
+        // to wind consistently with the interior triangles.
         m_contourDirections = pls::ContourDirections::forward;
     }
 
@@ -466,6 +643,13 @@ void PLSPathDraw::pushToRenderContext(PLSRenderContext::LogicalFlush* flush)
     // Make sure the rawPath in our path reference hasn't changed since we began holding!
     assert(m_rawPathMutationID == m_pathRef->getRawPathMutationID());
 
+    if (m_type == Type::analyticShapePath)
+    {
+        // Analytic shapes push their own path record, and don't have any tessellation.
+        onPushToRenderContext(flush);
+        return;
+    }
+
     size_t tessVertexCount = m_type == Type::midpointFanPath
                                  ? m_resourceCounts.midpointFanTessVertexCount
                                  : m_resourceCounts.outerCubicTessVertexCount;
@@ -492,6 +676,18 @@ void PLSPathDraw::releaseRefs()
     m_pathRef->unref();
 }
 
+uint64_t PLSPathDraw::contentHash() const
+{
+    uint64_t hash = PLSDraw::contentHash();
+    hash = HashValue(hash, m_pathRef->getRawPathMutationID());
+    hash = HashValue(hash, m_fillRule);
+    hash = HashValue(hash, m_paintType);
+    hash = HashValue(hash, m_strokeRadius);
+    hash = HashValue(hash, m_parametricPrecision);
+    hash = HashValue(hash, m_polarPrecision);
+    return hash;
+}
+
 MidpointFanPathDraw::MidpointFanPathDraw(PLSRenderContext* context,
                                          IAABB pixelBounds,
                                          const Mat2D& matrix,
@@ -506,11 +702,32 @@ MidpointFanPathDraw::MidpointFanPathDraw(PLSRenderContext* context,
                 Type::midpointFanPath,
                 context->frameInterlockMode())
 {
+    float tessellationQuality = find_tessellation_quality(context, paint);
+    m_parametricPrecision = kParametricPrecision * tessellationQuality;
+    m_polarPrecision = kPolarPrecision * tessellationQuality;
     if (isStroked())
     {
         m_strokeMatrixMaxScale = m_matrix.findMaxScale();
         m_strokeJoin = paint->getJoin();
         m_strokeCap = paint->getCap();
+        if (m_strokeRadius * 2 * m_strokeMatrixMaxScale <= kHairlineMaxPixelWidth)
+        {
+            // At a pixel wide or less, the shape of joins and the smoothness of the stroke's
+            // outer edge aren't visible. Draw a hairline: tessellate the centerline with
+            // parametric segments only, and don't emit any joins. (The shader already scales
+            // coverage down for strokes thinner than a pixel.)
+            m_isHairline = true;
+            // Round joins and caps would require polar segments. Square them off instead, which
+            // extends the same (sub-pixel) distance.
+            if (m_strokeJoin == StrokeJoin::round)
+            {
+                m_strokeJoin = StrokeJoin::miter;
+            }
+            if (m_strokeCap == StrokeCap::round)
+            {
+                m_strokeCap = StrokeCap::square;
+            }
+        }
     }
 
     // Count up how much temporary storage this function will need to reserve in CPU buffers.
@@ -580,9 +797,11 @@ MidpointFanPathDraw::MidpointFanPathDraw(PLSRenderContext* context,
     size_t curveIdx = 0;
     size_t rotationIdx = 0; // We measure rotations on both curves and round joins.
     bool roundJoinStroked = isStroked() && m_strokeJoin == StrokeJoin::round;
-    wangs_formula::VectorXform vectorXform(m_matrix);
+    // Wang's formula and the convex-180 chop search are evaluated on SoA batches of 4 cubics.
+    WangsFormulaCubicBatch wangsFormulaBatch(m_matrix, m_parametricPrecision);
     RawPath::Iter startOfContour = rawPath.begin();
     RawPath::Iter end = rawPath.end();
+    Convex180ChopFilter convex180ChopFilter(end);
     int preChopVerbCount = 0; // Original number of lines and curves, before chopping.
     Vec2D endpointsSum{};
     bool closed = !isStroked();
@@ -593,6 +812,8 @@ MidpointFanPathDraw::MidpointFanPathDraw(PLSRenderContext* context,
     assert(contourFirstCurveIdx % 4 == 0);
     size_t contourFirstRotationIdx = rotationIdx;
     assert(contourFirstRotationIdx % 4 == 0);
+    bool measureCompactTessOffsets = context->frameUsesCompactTessVertexSpans();
+    float maxCompactTessOffset = 0;
     auto finishAndAppendContour = [&](RawPath::Iter iter) {
         if (closed)
         {
@@ -627,6 +848,13 @@ MidpointFanPathDraw::MidpointFanPathDraw(PLSRenderContext* context,
         {
             strokeJoinCount = std::max<size_t>(strokeJoinCount, 1) - 1;
         }
+        Vec2D midpoint = isStroked() ? Vec2D() : endpointsSum * (1.f / preChopVerbCount);
+        if (measureCompactTessOffsets && preChopVerbCount != 0)
+        {
+            maxCompactTessOffset =
+                std::max(maxCompactTessOffset,
+                         find_max_offset(startOfContour.rawPtsPtr(), iter.rawPtsPtr(), midpoint));
+        }
         assert(contourIdx < contourCount);
         m_contours[contourIdx++] = {
             iter,
@@ -635,7 +863,7 @@ MidpointFanPathDraw::MidpointFanPathDraw(PLSRenderContext* context,
             curveIdx,
             contourFirstRotationIdx,
             rotationIdx,
-            isStroked() ? Vec2D() : endpointsSum * (1.f / preChopVerbCount),
+            midpoint,
             closed,
             strokeJoinCount,
             0,                 // strokeCapSegmentCount
@@ -731,8 +959,20 @@ MidpointFanPathDraw::MidpointFanPathDraw(PLSRenderContext* context,
                 // not rotate more than 180 degrees. This is required by the GPU
                 // parametric/polar sorter.
                 float t[2];
-                bool areCusps;
-                uint8_t numChops = pathutils::FindCubicConvex180Chops(p, t, &areCusps);
+                bool areCusps = false;
+                uint8_t numChops = 0;
+                if (!convex180ChopFilter.cubicNeedsNoChops(iter))
+                {
+                    numChops = pathutils::FindCubicConvex180Chops(p, t, &areCusps);
+                }
+#ifdef DEBUG
+                else
+                {
+                    bool dbgAreCusps;
+                    assert(pathutils::FindCubicConvex180Chops(p, t, &dbgAreCusps) == 0);
+                    assert(!dbgAreCusps);
+                }
+#endif
                 uint8_t chopKey = chop_key(areCusps, numChops);
                 m_numChops.push_back(chopKey);
                 Vec2D localChopBuffer[16];
@@ -769,12 +1009,14 @@ MidpointFanPathDraw::MidpointFanPathDraw(PLSRenderContext* context,
                 for (const Vec2D* end = p + numChops * 3 + 3; p != end;
                      p += 3, ++curveIdx, ++rotationIdx)
                 {
-                    float n4 = wangs_formula::cubic_pow4(p, kParametricPrecision, vectorXform);
                     // Record n^4 for now. This will get resolved later.
                     assert(curveIdx < maxPaddedCurves);
-                    RIVE_INLINE_MEMCPY(m_parametricSegmentCounts + curveIdx, &n4, sizeof(uint32_t));
+                    wangsFormulaBatch.push(p, m_parametricSegmentCounts + curveIdx);
                     assert(rotationIdx < maxPaddedRotations);
-                    find_cubic_tangents(p, m_tangentPairs[rotationIdx].data());
+                    if (!m_isHairline)
+                    {
+                        find_cubic_tangents(p, m_tangentPairs[rotationIdx].data());
+                    }
                 }
                 break;
             }
@@ -783,10 +1025,9 @@ MidpointFanPathDraw::MidpointFanPathDraw(PLSRenderContext* context,
                 const Vec2D* p = iter.cubicPts();
                 ++preChopVerbCount;
                 endpointsSum += p[3];
-                float n4 = wangs_formula::cubic_pow4(p, kParametricPrecision, vectorXform);
                 // Record n^4 for now. This will get resolved later.
                 assert(curveIdx < maxPaddedCurves);
-                RIVE_INLINE_MEMCPY(m_parametricSegmentCounts + curveIdx++, &n4, sizeof(uint32_t));
+                wangsFormulaBatch.push(p, m_parametricSegmentCounts + curveIdx++);
                 break;
             }
         }
@@ -795,6 +1036,11 @@ MidpointFanPathDraw::MidpointFanPathDraw(PLSRenderContext* context,
     {
         finishAndAppendContour(end);
     }
+    wangsFormulaBatch.flush();
+    check_compact_tess_span_precision(context,
+                                      maxCompactTessOffset,
+                                      m_matrix,
+                                      m_parametricPrecision);
     assert(contourIdx == contourCount);
     assert(contourCount > 0);
     assert(curveIdx <= maxPaddedCurves);
@@ -854,9 +1100,19 @@ MidpointFanPathDraw::MidpointFanPathDraw(PLSRenderContext* context,
             // round join.
             const float r_ = m_strokeRadius * m_strokeMatrixMaxScale;
             const float polarSegmentsPerRad =
-                pathutils::CalcPolarSegmentsPerRadian<kPolarPrecision>(r_);
+                pathutils::CalcPolarSegmentsPerRadian(m_polarPrecision, r_);
             for (j = contour->firstRotationIdx; j < contour->endRotationIdx; j += 4)
             {
+                if (m_isHairline)
+                {
+                    // Hairlines don't have polar segments. (Their curves were still chopped at
+                    // inflections and 180-degree rotations, so a single polar segment, which only
+                    // contributes the endpoints, is valid for the GPU parametric/polar sorter.)
+                    assert(j + 4 <= rotationIdx);
+                    simd::store(m_polarSegmentCounts + j, uint4(1));
+                    mergedTessVertexSums4 += 1;
+                    continue;
+                }
                 // Measure the rotations of curves in batches of 4.
                 assert(j + 4 <= rotationIdx);
                 auto [tx0, ty0, tx1, ty1] = simd::load4x4f(&m_tangentPairs[j][0].x);
@@ -900,7 +1156,7 @@ MidpointFanPathDraw::MidpointFanPathDraw(PLSRenderContext* context,
                 // round join is "joinSegmentCount - 1". Do all the -1's here.
                 contourVertexCount -= contour->strokeJoinCount;
             }
-            else
+            else if (!m_isHairline) // Hairlines don't have joins.
             {
                 // The shader needs 3 segments for each miter and bevel join (which
                 // translates to two interior vertices, since joins share their beginning
@@ -987,17 +1243,27 @@ MidpointFanPathDraw::MidpointFanPathDraw(PLSRenderContext* context,
     {
         m_resourceCounts.pathCount = 1;
         m_resourceCounts.contourCount = contourCount;
-        // maxTessellatedSegmentCount does not get doubled when we emit both forward and mirrored
-        // contours because the forward and mirrored pair both get packed into a single
-        // pls::TessVertexSpan.
+        // maxTessellatedSegmentCount is in units of the tessellation span format in use.
         m_resourceCounts.maxTessellatedSegmentCount =
-            lineCount + unpaddedCurveCount + emptyStrokeCountForCaps;
+            (lineCount + unpaddedCurveCount + emptyStrokeCountForCaps) *
+            find_tess_spans_per_segment(context, m_contourDirections);
         m_resourceCounts.midpointFanTessVertexCount =
             m_contourDirections == pls::ContourDirections::reverseAndForward ? tessVertexCount * 2
                                                                              : tessVertexCount;
     }
 }
 
+uint64_t MidpointFanPathDraw::contentHash() const
+{
+    uint64_t hash = PLSPathDraw::contentHash();
+    if (isStroked())
+    {
+        hash = HashValue(hash, m_strokeJoin);
+        hash = HashValue(hash, m_strokeCap);
+    }
+    return hash;
+}
+
 void MidpointFanPathDraw::onPushToRenderContext(PLSRenderContext::LogicalFlush* flush)
 {
     const RawPath& rawPath = m_pathRef->getRawPath();
@@ -1019,6 +1285,9 @@ void MidpointFanPathDraw::onPushToRenderContext(PLSRenderContext::LogicalFlush*
         bool roundJoinStroked = false;
         bool needsFirstEmulatedCapAsJoin = false; // Emit a starting cap before the next cubic?
         uint32_t emulatedCapAsJoinFlags = 0;
+        // A join segment count of 1 means no join; hairlines go straight from one curve to the
+        // next.
+        const int miterOrBevelJoinSegmentCount = m_isHairline ? 1 : kNumSegmentsInMiterOrBevelJoin;
         if (isStroked())
         {
             joinTypeFlags = join_type_flags(m_strokeJoin);
@@ -1090,7 +1359,7 @@ void MidpointFanPathDraw::onPushToRenderContext(PLSRenderContext::LogicalFlush*
                                                         end.rawPtsPtr(),
                                                         contour.closed,
                                                         pts);
-                        joinSegmentCount = kNumSegmentsInMiterOrBevelJoin;
+                        joinSegmentCount = miterOrBevelJoinSegmentCount;
                         RIVE_DEBUG_CODE(--m_pendingStrokeJoinCount;)
                     }
                     else
@@ -1219,7 +1488,7 @@ void MidpointFanPathDraw::onPushToRenderContext(PLSRenderContext::LogicalFlush*
                                                             end.rawPtsPtr(),
                                                             contour.closed,
                                                             pts);
-                            joinSegmentCount = kNumSegmentsInMiterOrBevelJoin;
+                            joinSegmentCount = miterOrBevelJoinSegmentCount;
                         }
                         RIVE_DEBUG_CODE(--m_pendingStrokeJoinCount;)
                     }
@@ -1282,7 +1551,7 @@ void MidpointFanPathDraw::onPushToRenderContext(PLSRenderContext::LogicalFlush*
                 else if (isStroked())
                 {
                     joinTangent = find_starting_tangent(pts, end.rawPtsPtr());
-                    joinSegmentCount = kNumSegmentsInMiterOrBevelJoin;
+                    joinSegmentCount = miterOrBevelJoinSegmentCount;
                     RIVE_DEBUG_CODE(--m_pendingStrokeJoinCount;)
                 }
                 flush->pushCubic(cubic.data(), joinTangent, joinTypeFlags, 1, 1, joinSegmentCount);
@@ -1342,11 +1611,45 @@ InteriorTriangulationDraw::InteriorTriangulationDraw(PLSRenderContext* context,
 {
     assert(!isStroked());
     assert(m_strokeRadius == 0);
+    m_parametricPrecision = kParametricPrecision * find_tessellation_quality(context, paint);
     processPath(PathOp::countDataAndTriangulate,
                 &context->perFrameAllocator(),
                 scratchPath,
                 triangulatorAxis,
                 nullptr);
+    m_resourceCounts.maxTessellatedSegmentCount *=
+        find_tess_spans_per_segment(context, m_contourDirections);
+    if (context->frameUsesCompactTessVertexSpans())
+    {
+        // Outer cubics are stored relative to the first point in their contour.
+        float maxCompactTessOffset = 0;
+        Vec2D origin = {0, 0};
+        for (const auto [verb, pts] : m_pathRef->getRawPath())
+        {
+            switch (verb)
+            {
+                case PathVerb::move:
+                    origin = pts[0];
+                    break;
+                case PathVerb::line:
+                    maxCompactTessOffset =
+                        std::max(maxCompactTessOffset, find_max_offset(pts + 1, pts + 2, origin));
+                    break;
+                case PathVerb::quad:
+                    RIVE_UNREACHABLE();
+                case PathVerb::cubic:
+                    maxCompactTessOffset =
+                        std::max(maxCompactTessOffset, find_max_offset(pts + 1, pts + 4, origin));
+                    break;
+                case PathVerb::close:
+                    break;
+            }
+        }
+        check_compact_tess_span_precision(context,
+                                          maxCompactTessOffset,
+                                          m_matrix,
+                                          m_parametricPrecision);
+    }
 }
 
 void InteriorTriangulationDraw::onPushToRenderContext(PLSRenderContext::LogicalFlush* flush)
@@ -1401,7 +1704,9 @@ void InteriorTriangulationDraw::processPath(PathOp op,
                 }
                 else
                 {
-                    flush->pushContour({0, 0}, true, 0);
+                    // Outer cubics don't fan around a midpoint, but compact tessellation spans
+                    // are stored relative to it, so keep it near the contour.
+                    flush->pushContour(pts[0], true, 0);
                 }
                 p0 = pts[0];
                 ++contourCount;
@@ -1426,7 +1731,8 @@ void InteriorTriangulationDraw::processPath(PathOp op,
                 RIVE_UNREACHABLE();
             case PathVerb::cubic:
             {
-                size_t numSubdivisions = FindSubdivisionCount(pts, vectorXform);
+                size_t numSubdivisions =
+                    FindSubdivisionCount(pts, m_parametricPrecision, vectorXform);
                 if (numSubdivisions == 1)
                 {
                     if (op == PathOp::countDataAndTriangulate)
@@ -1500,15 +1806,16 @@ void InteriorTriangulationDraw::processPath(PathOp op,
                 ? GrTriangulator::Comparator::Direction::kHorizontal
                 : GrTriangulator::Comparator::Direction::kVertical,
             m_fillRule,
-            allocator);
+            allocator,
+            // Only depthStencil fills aren't reverseAndForward. They accumulate the interior's
+            // winding numbers in the stencil buffer instead of using winding weights.
+            m_contourDirections != pls::ContourDirections::reverseAndForward);
         // We also draw each "grout" triangle using an outerCubic patch.
         patchCount += m_triangulator->groutList().count();
 
         m_resourceCounts.pathCount = 1;
         m_resourceCounts.contourCount = contourCount;
-        // maxTessellatedSegmentCount does not get doubled when we emit both forward and mirrored
-        // contours because the forward and mirrored pair both get packed into a single
-        // pls::TessVertexSpan.
+        // The constructor converts this to units of the tessellation span format in use.
         m_resourceCounts.maxTessellatedSegmentCount = patchCount;
         // outerCubic patches emit their tessellated geometry twice: once forward and once mirrored.
         m_resourceCounts.outerCubicTessVertexCount =
@@ -1533,7 +1840,8 @@ void InteriorTriangulationDraw::processPath(PathOp op,
             ++patchCount;
         }
         assert(contourCount == m_resourceCounts.contourCount);
-        assert(patchCount == m_resourceCounts.maxTessellatedSegmentCount);
+        assert(patchCount == m_resourceCounts.maxTessellatedSegmentCount ||
+               patchCount * 2 == m_resourceCounts.maxTessellatedSegmentCount);
         assert(patchCount * kOuterCurvePatchSegmentSpan * 2 ==
                    m_resourceCounts.outerCubicTessVertexCount ||
                patchCount * kOuterCurvePatchSegmentSpan ==
@@ -1541,14 +1849,311 @@ void InteriorTriangulationDraw::processPath(PathOp op,
     }
 }
 
+namespace
+{
+// Tolerance for recognizing analytic shapes, relative to the size of the shape.
+constexpr static float kAnalyticShapeTolerance = 1.f / 4096;
+
+// Cubics that approximate a quarter ellipse place their inner control points "kappa" of the way
+// from the endpoints to the corner. (Rive uses both ~.5519 and ~.5523, depending on where the path
+// came from.)
+constexpr static float kMinQuarterEllipseKappa = .5515f;
+constexpr static float kMaxQuarterEllipseKappa = .553f;
+
+// Within the above range of kappa, a cubic corner deviates from the true ellipse by up to this
+// fraction of its radius. Analytic coverage draws the true ellipse, so this error grows with zoom.
+constexpr static float kMaxQuarterEllipseDeviation = 4.8e-4f;
+
+// Corners that deviate from their path by more than this many pixels go through the path pipeline.
+constexpr static float kMaxAnalyticCornerDeviationInPixels = 1.f / 8;
+
+// Returns true if the cubic is a quarter ellipse that rounds off one corner of 'bounds', tangent to
+// both of the corner's edges. Writes out the corner's index and radii.
+bool find_rrect_corner(const Vec2D pts[4],
+                       const AABB& bounds,
+                       float tolerance,
+                       int* cornerIdx,
+                       Vec2D* radii)
+{
+    bool isRight = pts[1].x + pts[2].x > bounds.left() + bounds.right();
+    bool isBottom = pts[1].y + pts[2].y > bounds.top() + bounds.bottom();
+    Vec2D corner = {isRight ? bounds.right() : bounds.left(),
+                    isBottom ? bounds.bottom() : bounds.top()};
+
+    // Orient the cubic so it travels from the corner's vertical edge to its horizontal edge.
+    Vec2D p0 = pts[0], p1 = pts[1], p2 = pts[2], p3 = pts[3];
+    if (fabsf(p0.x - corner.x) > tolerance)
+    {
+        std::swap(p0, p3);
+        std::swap(p1, p2);
+    }
+    if (fabsf(p0.x - corner.x) > tolerance || fabsf(p1.x - corner.x) > tolerance ||
+        fabsf(p2.y - corner.y) > tolerance || fabsf(p3.y - corner.y) > tolerance)
+    {
+        return false;
+    }
+
+    // Signed radii, pointing from the ellipse's center toward the corner.
+    float rx = corner.x - p3.x;
+    float ry = corner.y - p0.y;
+    if (fabsf(rx) <= tolerance || fabsf(ry) <= tolerance)
+    {
+        return false;
+    }
+    float k0 = (p1.y - p0.y) / ry;
+    float k1 = (p2.x - p3.x) / rx;
+    if (!(kMinQuarterEllipseKappa <= k0 && k0 <= kMaxQuarterEllipseKappa &&
+          kMinQuarterEllipseKappa <= k1 && k1 <= kMaxQuarterEllipseKappa))
+    {
+        return false;
+    }
+
+    *cornerIdx = (isBottom << 1) | isRight;
+    *radii = {fabsf(rx), fabsf(ry)};
+    return true;
+}
+
+bool is_line_on_edge(const Vec2D pts[2], const AABB& bounds, float tolerance)
+{
+    auto isOnX = [=](float x) {
+        return fabsf(pts[0].x - x) <= tolerance && fabsf(pts[1].x - x) <= tolerance;
+    };
+    auto isOnY = [=](float y) {
+        return fabsf(pts[0].y - y) <= tolerance && fabsf(pts[1].y - y) <= tolerance;
+    };
+    return isOnX(bounds.left()) || isOnX(bounds.right()) || isOnY(bounds.top()) ||
+           isOnY(bounds.bottom());
+}
+
+// Returns true if the path is a single contour that traces a rounded rectangle (or ellipse) inside
+// 'bounds': one quarter-ellipse cubic in each corner, connected by lines along the edges. All 4
+// corners must have the same radii.
+bool find_rrect_radii(const RawPath& rawPath, const AABB& bounds, float tolerance, Vec2D* radii)
+{
+    int cornerMask = 0;
+    size_t moveCount = 0;
+    for (auto [verb, pts] : rawPath)
+    {
+        switch (verb)
+        {
+            case PathVerb::move:
+                if (++moveCount > 1)
+                {
+                    return false;
+                }
+                break;
+            case PathVerb::line:
+                if (!is_line_on_edge(pts, bounds, tolerance))
+                {
+                    return false;
+                }
+                break;
+            case PathVerb::quad:
+                return false;
+            case PathVerb::cubic:
+            {
+                int cornerIdx;
+                Vec2D cornerRadii;
+                if (!find_rrect_corner(pts, bounds, tolerance, &cornerIdx, &cornerRadii) ||
+                    (cornerMask & (1 << cornerIdx)))
+                {
+                    return false;
+                }
+                if (cornerMask == 0)
+                {
+                    *radii = cornerRadii;
+                }
+                else if (fabsf(cornerRadii.x - radii->x) > tolerance ||
+                         fabsf(cornerRadii.y - radii->y) > tolerance)
+                {
+                    return false;
+                }
+                cornerMask |= 1 << cornerIdx;
+                break;
+            }
+            case PathVerb::close:
+                break;
+        }
+    }
+    Span<const Vec2D> pts = rawPath.points();
+    return cornerMask == 0xf && radii->x * 2 <= bounds.width() + tolerance &&
+           radii->y * 2 <= bounds.height() + tolerance &&
+           fabsf(pts.back().x - pts.front().x) <= tolerance &&
+           fabsf(pts.back().y - pts.front().y) <= tolerance;
+}
+} // namespace
+
+PLSDrawUniquePtr AnalyticShapeDraw::Make(PLSRenderContext* context,
+                                         const Mat2D& matrix,
+                                         const rcp<const PLSPath>& path,
+                                         const PLSPaint* paint)
+{
+    assert(context->frameSupportsAnalyticShapes());
+    if (paint->getType() == pls::PaintType::clipUpdate)
+    {
+        // Clip updates still go through the path pipeline.
+        return nullptr;
+    }
+
+    const RawPath& rawPath = path->getRawPath();
+    if (rawPath.empty())
+    {
+        return nullptr;
+    }
+    AABB bounds;
+    Vec2D radii = {0, 0};
+    bool isRect = PLSRenderer::IsAABB(rawPath, &bounds);
+    if (!isRect)
+    {
+        bounds = rawPath.bounds();
+    }
+    Vec2D halfSize = {bounds.width() * .5f, bounds.height() * .5f};
+    if (!(halfSize.x > 0 && halfSize.y > 0))
+    {
+        return nullptr;
+    }
+    float tolerance = std::max(halfSize.x, halfSize.y) * kAnalyticShapeTolerance;
+    if (!isRect && !find_rrect_radii(rawPath, bounds, tolerance, &radii))
+    {
+        return nullptr;
+    }
+
+    Vec2D outerHalfSize = halfSize;
+    Vec2D outerRadii = radii;
+    Vec2D innerHalfSize = {0, 0};
+    Vec2D innerRadii = {0, 0};
+    if (paint->getIsStroked())
+    {
+        // Open contours have caps.
+        if (rawPath.verbs().back() != PathVerb::close)
+        {
+            return nullptr;
+        }
+        float strokeRadius = paint->getThickness() * .5f;
+        if (isRect)
+        {
+            switch (paint->getJoin())
+            {
+                case StrokeJoin::miter:
+                    // 90-degree corners never exceed the miter limit.
+                    break;
+                case StrokeJoin::round:
+                    outerRadii = {strokeRadius, strokeRadius};
+                    break;
+                case StrokeJoin::bevel:
+                    return nullptr;
+            }
+        }
+        else
+        {
+            // The offset of an elliptical corner isn't another ellipse. Only circular corners can
+            // be stroked analytically. (Their joins are all smooth, so the join type doesn't
+            // matter.)
+            if (fabsf(radii.x - radii.y) > tolerance)
+            {
+                return nullptr;
+            }
+            outerRadii = {radii.x + strokeRadius, radii.y + strokeRadius};
+            innerRadii = {std::max(radii.x - strokeRadius, 0.f),
+                          std::max(radii.y - strokeRadius, 0.f)};
+        }
+        outerHalfSize = {halfSize.x + strokeRadius, halfSize.y + strokeRadius};
+        innerHalfSize = {halfSize.x - strokeRadius, halfSize.y - strokeRadius};
+        if (!(innerHalfSize.x > 0 && innerHalfSize.y > 0))
+        {
+            // The stroke covers the entire interior.
+            innerHalfSize = innerRadii = {0, 0};
+        }
+    }
+
+    // Analytic corners are true ellipses, whereas the path's corners are cubics. Don't let the
+    // difference become visible when a large corner is zoomed in.
+    if (std::max(outerRadii.x, outerRadii.y) * matrix.findMaxScale() * kMaxQuarterEllipseDeviation >
+        kMaxAnalyticCornerDeviationInPixels)
+    {
+        return nullptr;
+    }
+
+    // Normalize the shape so the outer shape spans [-1, +1].
+    Vec2D center = bounds.center();
+    Mat2D shapeMatrix =
+        matrix * Mat2D(outerHalfSize.x, 0, 0, outerHalfSize.y, center.x, center.y);
+    Mat2D inverseShapeMatrix;
+    if (!shapeMatrix.invert(&inverseShapeMatrix))
+    {
+        return nullptr;
+    }
+    ShapeParams params;
+    params.outerRadii = {outerRadii.x / outerHalfSize.x, outerRadii.y / outerHalfSize.y};
+    params.innerRadii = {innerRadii.x / outerHalfSize.x, innerRadii.y / outerHalfSize.y};
+    params.innerHalfSize = {innerHalfSize.x / outerHalfSize.x, innerHalfSize.y / outerHalfSize.y};
+
+    // Outset the quad by 1px for antialiasing. The rows of the inverse matrix are the gradients of
+    // each shape-space coordinate in pixel space, i.e., the size of a pixel in shape space.
+    float outsetX = sqrtf(inverseShapeMatrix[0] * inverseShapeMatrix[0] +
+                          inverseShapeMatrix[2] * inverseShapeMatrix[2]);
+    float outsetY = sqrtf(inverseShapeMatrix[1] * inverseShapeMatrix[1] +
+                          inverseShapeMatrix[3] * inverseShapeMatrix[3]);
+    params.quadBounds = {-1 - outsetX, -1 - outsetY, 1 + outsetX, 1 + outsetY};
+    IAABB pixelBounds = shapeMatrix.mapBoundingBox(params.quadBounds).roundOut();
+
+    return PLSDrawUniquePtr(context->make<AnalyticShapeDraw>(pixelBounds,
+                                                             matrix,
+                                                             shapeMatrix,
+                                                             path,
+                                                             paint,
+                                                             params,
+                                                             context->frameInterlockMode()));
+}
+
+AnalyticShapeDraw::AnalyticShapeDraw(IAABB pixelBounds,
+                                     const Mat2D& matrix,
+                                     const Mat2D& shapeMatrix,
+                                     rcp<const PLSPath> path,
+                                     const PLSPaint* paint,
+                                     const ShapeParams& params,
+                                     pls::InterlockMode frameInterlockMode) :
+    PLSPathDraw(pixelBounds,
+                matrix,
+                std::move(path),
+                FillRule::nonZero, // Coverage never exceeds 1, so the fill rule doesn't matter.
+                paint,
+                Type::analyticShapePath,
+                frameInterlockMode),
+    m_shapeMatrix(shapeMatrix),
+    m_params(params)
+{
+    assert(frameInterlockMode != pls::InterlockMode::depthStencil);
+    m_resourceCounts.pathCount = 1;
+    // Leave room to align the vertices on an AnalyticShapeVertex boundary.
+    m_resourceCounts.maxTriangleVertexCount =
+        kAnalyticShapeVertexCount * kTriangleVerticesPerAnalyticShapeVertex +
+        kTriangleVerticesPerAnalyticShapeVertex - 1;
+}
+
+uint64_t AnalyticShapeDraw::contentHash() const
+{
+    uint64_t hash = PLSPathDraw::contentHash();
+    // The stroke join can change the outer radii of a rect.
+    hash = HashValue(hash, m_params.outerRadii);
+    return hash;
+}
+
+void AnalyticShapeDraw::onPushToRenderContext(PLSRenderContext::LogicalFlush* flush)
+{
+    flush->pushAnalyticShape(this);
+}
+
 ImageRectDraw::ImageRectDraw(PLSRenderContext* context,
                              IAABB pixelBounds,
                              const Mat2D& matrix,
                              BlendMode blendMode,
                              rcp<const PLSTexture> imageTexture,
-                             float opacity) :
+                             float opacity,
+                             const AABB& texCoordRect) :
     PLSDraw(pixelBounds, matrix, blendMode, std::move(imageTexture), Type::imageRect),
-    m_opacity(opacity)
+    m_opacity(opacity),
+    m_texCoordRect(texCoordRect)
 {
     // If we support image paints for paths, the client should draw a rectangular path with an
     // image paint instead of using this draw.
@@ -1561,6 +2166,12 @@ void ImageRectDraw::pushToRenderContext(PLSRenderContext::LogicalFlush* flush)
     flush->pushImageRect(this);
 }
 
+uint64_t ImageRectDraw::contentHash() const
+{
+    uint64_t hash = HashValue(PLSDraw::contentHash(), m_opacity);
+    return HashValue(hash, m_texCoordRect);
+}
+
 ImageMeshDraw::ImageMeshDraw(IAABB pixelBounds,
                              const Mat2D& matrix,
                              BlendMode blendMode,
@@ -1569,13 +2180,15 @@ ImageMeshDraw::ImageMeshDraw(IAABB pixelBounds,
                              rcp<const RenderBuffer> uvBuffer,
                              rcp<const RenderBuffer> indexBuffer,
                              uint32_t indexCount,
-                             float opacity) :
+                             float opacity,
+                             const AABB& texCoordRect) :
     PLSDraw(pixelBounds, matrix, blendMode, std::move(imageTexture), Type::imageMesh),
     m_vertexBufferRef(vertexBuffer.release()),
     m_uvBufferRef(uvBuffer.release()),
     m_indexBufferRef(indexBuffer.release()),
     m_indexCount(indexCount),
-    m_opacity(opacity)
+    m_opacity(opacity),
+    m_texCoordRect(texCoordRect)
 {
     assert(m_vertexBufferRef != nullptr);
     assert(m_uvBufferRef != nullptr);
@@ -4,6 +4,10 @@
 
 #include "rive/pls/pls_image.hpp"
 
+#include "rive/pls/pls_render_context_helper_impl.hpp"
+#include <algorithm>
+#include <string.h>
+
 namespace rive::pls
 {
 PLSTexture::PLSTexture(uint32_t width, uint32_t height) : m_width(width), m_height(height)
@@ -11,4 +15,141 @@ PLSTexture::PLSTexture(uint32_t width, uint32_t height) : m_width(width), m_heig
     static std::atomic_uint32_t textureResourceHashCounter = 0;
     m_textureResourceHash = ++textureResourceHashCounter;
 }
+
+PLSImageAtlasPage::PLSImageAtlasPage(PLSRenderContextHelperImpl* impl) :
+    m_impl(impl), m_texture(m_impl->makeImageAtlasTexture(kSize, kMipLevelCount))
+{}
+
+static uint32_t round_up_to_gutter(uint32_t x)
+{
+    return (x + PLSImageAtlasPage::kGutter - 1) & ~(PLSImageAtlasPage::kGutter - 1);
+}
+
+bool PLSImageAtlasPage::addImage(uint32_t width,
+                                 uint32_t height,
+                                 const uint8_t imageDataRGBA[],
+                                 IAABB* region)
+{
+    assert(std::this_thread::get_id() == m_ownerThreadID);
+    assert(!m_isClosed);
+    assert(width > 0 && height > 0);
+    assert(width <= kMaxImageSize && height <= kMaxImageSize);
+    uint32_t cellWidth = round_up_to_gutter(width) + kGutter * 2;
+    uint32_t cellHeight = round_up_to_gutter(height) + kGutter * 2;
+    if (m_shelfX + cellWidth > kSize)
+    {
+        // Start a new shelf.
+        m_shelfTop += m_shelfHeight;
+        m_shelfHeight = 0;
+        m_shelfX = 0;
+    }
+    if (m_shelfTop + cellHeight > kSize)
+    {
+        return false;
+    }
+    uint32_t cellLeft = m_shelfX;
+    uint32_t cellTop = m_shelfTop;
+    m_shelfX += cellWidth;
+    m_shelfHeight = std::max(m_shelfHeight, cellHeight);
+
+    // Lay out the cell and all its mips back to back in the scratch buffer.
+    size_t mipOffsets[kMipLevelCount];
+    size_t scratchSize = 0;
+    for (uint32_t level = 0; level < kMipLevelCount; ++level)
+    {
+        mipOffsets[level] = scratchSize;
+        scratchSize += ((cellWidth >> level) * (cellHeight >> level)) * 4;
+    }
+    if (m_cellPixelsRGBA.size() < scratchSize)
+    {
+        m_cellPixelsRGBA.resize(scratchSize);
+    }
+
+    // Copy the image and replicate its edge pixels into the rest of the cell, so filtering at the
+    // edges behaves as if it were a standalone texture sampled with clamp-to-edge.
+    uint8_t* cellPixels = m_cellPixelsRGBA.data();
+    int32_t gutter = kGutter;
+    for (uint32_t y = 0; y < cellHeight; ++y)
+    {
+        int32_t srcY =
+            std::clamp(static_cast<int32_t>(y) - gutter, 0, static_cast<int32_t>(height) - 1);
+        const uint8_t* srcRow = imageDataRGBA + srcY * width * 4;
+        uint8_t* dstRow = cellPixels + y * cellWidth * 4;
+        for (uint32_t i = 0; i < kGutter; ++i)
+        {
+            memcpy(dstRow + i * 4, srcRow, 4);
+        }
+        memcpy(dstRow + kGutter * 4, srcRow, width * 4);
+        for (uint32_t x = kGutter + width; x < cellWidth; ++x)
+        {
+            memcpy(dstRow + x * 4, srcRow + (width - 1) * 4, 4);
+        }
+    }
+
+    // Box filter the mips on the CPU. The cell's bounds are multiples of kGutter, so every texel
+    // of these levels lies entirely within the cell and nothing outside of it needs to change.
+    for (uint32_t level = 1; level < kMipLevelCount; ++level)
+    {
+        uint32_t w = cellWidth >> level, h = cellHeight >> level;
+        const uint8_t* src = cellPixels + mipOffsets[level - 1];
+        uint8_t* dst = cellPixels + mipOffsets[level];
+        uint32_t srcRowBytes = w * 2 * 4;
+        for (uint32_t y = 0; y < h; ++y)
+        {
+            for (uint32_t x = 0; x < w; ++x)
+            {
+                const uint8_t* s = src + y * 2 * srcRowBytes + x * 2 * 4;
+                for (uint32_t c = 0; c < 4; ++c)
+                {
+                    uint32_t sum = s[c] + s[4 + c] + s[srcRowBytes + c] + s[srcRowBytes + 4 + c];
+                    dst[(y * w + x) * 4 + c] = static_cast<uint8_t>((sum + 2) >> 2);
+                }
+            }
+        }
+    }
+
+    if (m_texture != nullptr)
+    {
+        for (uint32_t level = 0; level < kMipLevelCount; ++level)
+        {
+            IAABB mipRegion = {static_cast<int32_t>(cellLeft >> level),
+                               static_cast<int32_t>(cellTop >> level),
+                               static_cast<int32_t>((cellLeft + cellWidth) >> level),
+                               static_cast<int32_t>((cellTop + cellHeight) >> level)};
+            m_impl->updateImageAtlasTexture(m_texture.get(),
+                                            level,
+                                            mipRegion,
+                                            cellPixels + mipOffsets[level]);
+        }
+    }
+
+    uint32_t left = cellLeft + kGutter;
+    uint32_t top = cellTop + kGutter;
+    *region = {static_cast<int32_t>(left),
+               static_cast<int32_t>(top),
+               static_cast<int32_t>(left + width),
+               static_cast<int32_t>(top + height)};
+    return true;
+}
+
+void PLSImageAtlasPage::close()
+{
+    assert(std::this_thread::get_id() == m_ownerThreadID);
+    m_isClosed = true;
+    m_cellPixelsRGBA = {};
+}
+
+PLSImage::PLSImage(rcp<PLSImageAtlasPage> atlasPage,
+                   const IAABB& atlasRegion,
+                   rcp<RenderPath> texCoordRectPath) :
+    PLSImage(atlasRegion.width(), atlasRegion.height())
+{
+    constexpr static float kInvSize = 1.f / PLSImageAtlasPage::kSize;
+    m_atlasPage = std::move(atlasPage);
+    m_texCoordRect = {atlasRegion.left * kInvSize,
+                      atlasRegion.top * kInvSize,
+                      atlasRegion.right * kInvSize,
+                      atlasRegion.bottom * kInvSize};
+    m_texCoordRectPath = std::move(texCoordRectPath);
+}
 } // namespace rive::pls
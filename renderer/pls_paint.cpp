@@ -114,6 +114,15 @@ bool PLSGradient::isOpaque() const
     return m_isOpaque == pls::TriState::yes;
 }
 
+uint64_t PLSGradient::hashContents(uint64_t hash) const
+{
+    hash = pls::HashValue(hash, m_paintType);
+    hash = pls::HashBytes(hash, m_coeffs.data(), sizeof(float) * m_coeffs.size());
+    hash = pls::HashBytes(hash, m_colors.get(), sizeof(ColorInt) * m_count);
+    hash = pls::HashBytes(hash, m_stops.get(), sizeof(float) * m_count);
+    return hash;
+}
+
 void PLSPaint::color(ColorInt color)
 {
     m_paintType = PaintType::solidColor;
@@ -140,12 +149,26 @@ void PLSPaint::image(rcp<const PLSTexture> imageTexture, float opacity)
     m_imageTexture = std::move(imageTexture);
 }
 
-void PLSPaint::clipUpdate(uint32_t outerClipID)
+void PLSPaint::copyFrom(const PLSPaint& other)
+{
+    m_paintType = other.m_paintType;
+    m_simpleValue = other.m_simpleValue;
+    m_gradient = other.m_gradient;
+    m_imageTexture = other.m_imageTexture;
+    m_thickness = other.m_thickness;
+    m_join = other.m_join;
+    m_cap = other.m_cap;
+    m_blendMode = other.m_blendMode;
+    m_tessellationQuality = other.m_tessellationQuality;
+    m_stroked = other.m_stroked;
+}
+
+void PLSPaint::clipUpdate(uint32_t outerClipID, rcp<const PLSTexture> clipMask)
 {
     m_paintType = PaintType::clipUpdate;
     m_simpleValue.outerClipID = outerClipID;
     m_gradient.reset();
-    m_imageTexture.reset();
+    m_imageTexture = std::move(clipMask);
 }
 
 bool PLSPaint::getIsOpaque() const
@@ -81,6 +81,10 @@ public:
     int count() const { return m_count; }
     bool isOpaque() const;
 
+    // Folds the gradient's type, coefficients, colors, and stops into a pls::HashBytes()
+    // fingerprint.
+    uint64_t hashContents(uint64_t hash) const;
+
 private:
     PLSGradient(PaintType paintType,
                 PLSGradDataArray<ColorInt>&& colors, // [count]
@@ -121,7 +125,13 @@ public:
     void blendMode(BlendMode mode) override { m_blendMode = mode; }
     void shader(rcp<RenderShader> shader) override;
     void image(rcp<const PLSTexture>, float opacity);
-    void clipUpdate(uint32_t outerClipID);
+    // If a clipMask is given, the clip coverage is also multiplied by the mask's alpha, which is
+    // mapped onto the path's local [0, 0, 1, 1] square the same way as an image paint.
+    void clipUpdate(uint32_t outerClipID, rcp<const PLSTexture> clipMask = nullptr);
+    void copyFrom(const PLSPaint&); // Used to snapshot paints whose draws are deferred.
+    // Per-draw hint that scales the frame's tessellation quality. (Set by the tessellationQuality
+    // overload of PLSRenderer::drawPath(), on a copy of the client's paint.)
+    void tessellationQuality(float quality) { m_tessellationQuality = quality; }
     void invalidateStroke() override {}
 
     PaintType getType() const { return m_paintType; }
@@ -135,6 +145,7 @@ public:
     StrokeJoin getJoin() const { return m_join; }
     StrokeCap getCap() const { return m_cap; }
     BlendMode getBlendMode() const { return m_blendMode; }
+    float getTessellationQuality() const { return m_tessellationQuality; }
     pls::SimplePaintValue getSimpleValue() const { return m_simpleValue; }
     bool getIsOpaque() const;
 
@@ -147,6 +158,7 @@ private:
     StrokeJoin m_join = StrokeJoin::miter;
     StrokeCap m_cap = StrokeCap::butt;
     BlendMode m_blendMode = BlendMode::srcOver;
+    float m_tessellationQuality = 1;
     bool m_stroked = false;
 };
 } // namespace rive::pls
@@ -5,12 +5,13 @@
 #include "pls_path.hpp"
 
 #include "eval_cubic.hpp"
+#include "path_utils.hpp"
 #include "rive/math/simd.hpp"
 #include "rive/math/wangs_formula.hpp"
 
 namespace rive::pls
 {
-PLSPath::PLSPath(FillRule fillRule, RawPath& rawPath)
+PLSPath::PLSPath(FillRule fillRule, RawPath& rawPath) : m_fillRule(fillRule)
 {
     m_rawPath.swap(rawPath);
     m_rawPath.pruneEmptySegments();
@@ -94,30 +95,40 @@ const AABB& PLSPath::getBounds() const
     return m_bounds;
 }
 
-float PLSPath::getCoarseArea() const
+const PathCostMetrics& PLSPath::getCoarseMetrics() const
 {
-    if (m_dirt & kPathCoarseAreaDirt)
+    if (m_dirt & kPathCoarseMetricsDirt)
     {
-        float a = 0;
+        // Fan each contour's linearized points from its first point. The signed triangle areas add
+        // up to the contour's area, and their unsigned areas add up to how much a fan shades.
+        PathCostMetrics metrics;
+        float a = 0, fanArea = 0;
         Vec2D contourP0 = {0, 0}, lastPt = {0, 0};
+        auto addPoint = [&](Vec2D p) {
+            float triangleArea = Vec2D::cross(lastPt - contourP0, p - contourP0);
+            a += triangleArea;
+            fanArea += fabsf(triangleArea);
+            lastPt = p;
+        };
         for (auto [verb, pts] : m_rawPath)
         {
             switch (verb)
             {
                 case PathVerb::move:
-                    a += Vec2D::cross(lastPt, contourP0);
+                    ++metrics.contourCount;
                     contourP0 = lastPt = pts[0];
                     break;
                 case PathVerb::close:
                     break;
                 case PathVerb::line:
-                    a += Vec2D::cross(lastPt, pts[1]);
-                    lastPt = pts[1];
+                    ++metrics.verbCount;
+                    addPoint(pts[1]);
                     break;
                 case PathVerb::quad:
                     RIVE_UNREACHABLE();
                 case PathVerb::cubic:
                 {
+                    ++metrics.verbCount;
                     // Linearize the cubic in artboard space, then add up the area for each segment.
                     float n = ceilf(wangs_formula::cubic(pts, 1.f / kCoarseAreaTolerance));
                     if (n > 1)
@@ -129,28 +140,25 @@ float PLSPath::getCoarseArea() const
                         for (; t.x < 1; t += dt)
                         {
                             float4 p = evalCubic.at(t);
-                            Vec2D lo = {p.x, p.y};
-                            a += Vec2D::cross(lastPt, lo);
-                            lastPt = lo;
+                            addPoint({p.x, p.y});
                             if (t.y < 1)
                             {
-                                Vec2D hi = {p.z, p.w};
-                                a += Vec2D::cross(lastPt, hi);
-                                lastPt = hi;
+                                addPoint({p.z, p.w});
                             }
                         }
                     }
-                    a += Vec2D::cross(lastPt, pts[3]);
-                    lastPt = pts[3];
+                    addPoint(pts[3]);
                     break;
                 }
             }
         }
-        a += Vec2D::cross(lastPt, contourP0);
-        m_coarseArea = a * .5f;
-        m_dirt &= ~kPathCoarseAreaDirt;
+        // The closing edge of each contour ends at its fan's apex, so it doesn't add a triangle.
+        metrics.coarseArea = a * .5f;
+        metrics.coarseFanArea = fanArea * .5f;
+        m_coarseMetrics = metrics;
+        m_dirt &= ~kPathCoarseMetricsDirt;
     }
-    return m_coarseArea;
+    return m_coarseMetrics;
 }
 
 uint64_t PLSPath::getRawPathMutationID() const
@@ -163,4 +171,34 @@ uint64_t PLSPath::getRawPathMutationID() const
     }
     return m_rawPathMutationID;
 }
+
+rcp<const PLSPath> PLSPath::getPreChoppedPath(FillRule fillRule,
+                                              const Mat2D& matrix,
+                                              const AABB& viewport,
+                                              float parametricPrecision,
+                                              float maxParametricSegments,
+                                              RawPath* scratchPath) const
+{
+    if ((m_dirt & kPreChoppedPathDirt) || fillRule != m_preChopFillRule ||
+        matrix != m_preChopMatrix || !(viewport == m_preChopViewport) ||
+        parametricPrecision != m_preChopParametricPrecision ||
+        maxParametricSegments != m_preChopMaxParametricSegments)
+    {
+        pathutils::PreChopPathCurves(m_rawPath,
+                                     matrix,
+                                     viewport,
+                                     parametricPrecision,
+                                     maxParametricSegments,
+                                     scratchPath);
+        // Don't modify the previous copy in place; draws from earlier frames may still hold it.
+        m_preChoppedPath = make_rcp<PLSPath>(fillRule, *scratchPath);
+        m_preChopFillRule = fillRule;
+        m_preChopMatrix = matrix;
+        m_preChopViewport = viewport;
+        m_preChopParametricPrecision = parametricPrecision;
+        m_preChopMaxParametricSegments = maxParametricSegments;
+        m_dirt &= ~kPreChoppedPathDirt;
+    }
+    return m_preChoppedPath;
+}
 } // namespace rive::pls
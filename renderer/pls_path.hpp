@@ -6,6 +6,7 @@
 
 #include "rive/math/raw_path.hpp"
 #include "rive/renderer.hpp"
+#include "rive/pls/pls.hpp"
 
 namespace rive::pls
 {
@@ -34,9 +35,23 @@ public:
     // Approximates the area of the path by linearizing it with a coarse tolerance of 8px in
     // artboard space.
     constexpr static float kCoarseAreaTolerance = 8; // Linearize within 8px of the true curve.
-    float getCoarseArea() const;
+    float getCoarseArea() const { return getCoarseMetrics().coarseArea; }
+    // The coarse area along with the other measurements that drive pls::TriangulationCostModel,
+    // all found in the same pass over the path.
+    const PathCostMetrics& getCoarseMetrics() const;
     uint64_t getRawPathMutationID() const;
 
+    // Returns a copy of this path whose curves are pre-chopped against a device-space viewport.
+    // (See pathutils::PreChopPathCurves().) The copy is memoized until this path mutates or the
+    // arguments change, so content that stays put under a deep zoom doesn't rebuild it every frame.
+    // 'scratchPath' is only used when the copy has to be rebuilt.
+    rcp<const PLSPath> getPreChoppedPath(FillRule,
+                                         const Mat2D&,
+                                         const AABB& viewport,
+                                         float parametricPrecision,
+                                         float maxParametricSegments,
+                                         RawPath* scratchPath) const;
+
 #ifdef DEBUG
     // Allows ref holders to guarantee the rawPath doesn't mutate during a specific time.
     void lockRawPathMutations() const { ++m_rawPathMutationLockCount; }
@@ -51,14 +66,23 @@ private:
     FillRule m_fillRule = FillRule::nonZero;
     RawPath m_rawPath;
     mutable AABB m_bounds;
-    mutable float m_coarseArea;
+    mutable PathCostMetrics m_coarseMetrics;
     mutable uint64_t m_rawPathMutationID;
 
+    // Memoized result of getPreChoppedPath(), along with the arguments it was built for.
+    mutable rcp<const PLSPath> m_preChoppedPath;
+    mutable FillRule m_preChopFillRule;
+    mutable Mat2D m_preChopMatrix;
+    mutable AABB m_preChopViewport;
+    mutable float m_preChopParametricPrecision;
+    mutable float m_preChopMaxParametricSegments;
+
     enum Dirt
     {
         kPathBoundsDirt = 1 << 0,
         kRawPathMutationIDDirt = 1 << 1,
-        kPathCoarseAreaDirt = 1 << 2,
+        kPathCoarseMetricsDirt = 1 << 2,
+        kPreChoppedPathDirt = 1 << 3,
         kAllDirt = ~0,
     };
 
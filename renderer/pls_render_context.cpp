@@ -7,6 +7,7 @@
 #include "gr_inner_fan_triangulator.hpp"
 #include "intersection_board.hpp"
 #include "pls_paint.hpp"
+#include "pls_path.hpp"
 #include "rive/pls/pls_draw.hpp"
 #include "rive/pls/pls_image.hpp"
 #include "rive/pls/pls_render_context_impl.hpp"
@@ -18,6 +19,7 @@ namespace rive::pls
 {
 constexpr size_t kDefaultSimpleGradientCapacity = 512;
 constexpr size_t kDefaultComplexGradientCapacity = 1024;
+constexpr size_t kDefaultPaintCapacity = 256;
 constexpr size_t kDefaultDrawCapacity = 2048;
 
 constexpr size_t kMaxTextureHeight = 2048; // TODO: Move this variable to PlatformFeatures.
@@ -81,11 +83,22 @@ size_t DeepHashGradient::operator()(const GradientContentKey& key) const
     return x ^ y;
 }
 
+bool PaintRecordKey::operator==(const PaintRecordKey& other) const
+{
+    return !memcmp(this, &other, sizeof(PaintRecordKey));
+}
+
+size_t HashPaintRecord::operator()(const PaintRecordKey& key) const
+{
+    return pls::HashBytes(pls::kFNVOffsetBasis, &key, sizeof(PaintRecordKey));
+}
+
 PLSRenderContext::PLSRenderContext(std::unique_ptr<PLSRenderContextImpl> impl) :
     m_impl(std::move(impl)),
     // -1 from m_maxPathID so we reserve a path record for the clearColor paint (for atomic mode).
     // This also allows us to index the storage buffers directly by pathID.
-    m_maxPathID(MaxPathID(m_impl->platformFeatures().pathIDGranularity) - 1)
+    m_maxPathID(MaxPathID(m_impl->platformFeatures().pathIDGranularity) - 1),
+    m_resourceAllocationPolicy(std::make_unique<DefaultResourceAllocationPolicy>())
 {
     setResourceSizes(ResourceAllocationCounts(), /*forceRealloc =*/true);
     releaseResources();
@@ -104,6 +117,13 @@ const pls::PlatformFeatures& PLSRenderContext::platformFeatures() const
     return m_impl->platformFeatures();
 }
 
+pls::PlatformFeatures PLSRenderContext::framePlatformFeatures() const
+{
+    pls::PlatformFeatures features = platformFeatures();
+    features.compactTessVertexSpans = frameUsesCompactTessVertexSpans();
+    return features;
+}
+
 rcp<RenderBuffer> PLSRenderContext::makeRenderBuffer(RenderBufferType type,
                                                      RenderBufferFlags flags,
                                                      size_t sizeInBytes)
@@ -113,17 +133,52 @@ rcp<RenderBuffer> PLSRenderContext::makeRenderBuffer(RenderBufferType type,
 
 rcp<RenderImage> PLSRenderContext::decodeImage(Span<const uint8_t> encodedBytes)
 {
-    rcp<PLSTexture> texture = m_impl->decodeImageTexture(encodedBytes);
-    return texture != nullptr ? make_rcp<PLSImage>(std::move(texture)) : nullptr;
+    return m_impl->decodeImage(encodedBytes);
 }
 
 void PLSRenderContext::releaseResources()
 {
     assert(!m_didBeginFrame);
     resetContainers();
+    m_perFrameAllocator.releaseRetainedBlocks();
+    m_numChopsAllocator.releaseRetainedBlocks();
+    m_chopVerticesAllocator.releaseRetainedBlocks();
+    m_tangentPairsAllocator.releaseRetainedBlocks();
+    m_polarSegmentCountsAllocator.releaseRetainedBlocks();
+    m_parametricSegmentCountsAllocator.releaseRetainedBlocks();
     setResourceSizes(ResourceAllocationCounts());
-    m_maxRecentResourceRequirements = ResourceAllocationCounts();
-    m_lastResourceTrimTimeInSeconds = m_impl->secondsNow();
+    m_peakResourceRequirements = ResourceAllocationCounts();
+    m_lastContainerResetTimeInSeconds = m_impl->secondsNow();
+    m_resourceAllocationPolicy->reset(m_lastContainerResetTimeInSeconds);
+    m_lastFrameWasRetained = false;
+    m_lastFrameRenderTarget = nullptr;
+}
+
+PLSRenderContext::AllocatorStats PLSRenderContext::allocatorStats() const
+{
+    return {
+        .perFrame = m_perFrameAllocator.stats(),
+        .numChops = m_numChopsAllocator.stats(),
+        .chopVertices = m_chopVerticesAllocator.stats(),
+        .tangentPairs = m_tangentPairsAllocator.stats(),
+        .polarSegmentCounts = m_polarSegmentCountsAllocator.stats(),
+        .parametricSegmentCounts = m_parametricSegmentCountsAllocator.stats(),
+    };
+}
+
+void PLSRenderContext::setResourceAllocationPolicy(std::unique_ptr<ResourceAllocationPolicy> policy)
+{
+    assert(!m_didBeginFrame);
+    assert(policy != nullptr);
+    m_resourceAllocationPolicy = std::move(policy);
+    m_resourceAllocationPolicy->reset(m_impl->secondsNow());
+}
+
+void PLSRenderContext::reserve(const ResourceAllocationCounts& counts)
+{
+    assert(!m_didBeginFrame);
+    m_resourceAllocationPolicy->reserve(counts);
+    setResourceSizes(simd::max(counts.toVec(), m_currentResourceAllocations.toVec()));
 }
 
 void PLSRenderContext::resetContainers()
@@ -140,6 +195,10 @@ void PLSRenderContext::resetContainers()
     m_indirectDrawList.clear();
     m_indirectDrawList.shrink_to_fit();
 
+    m_lastFrameDrawFingerprints.shrink_to_fit();
+    m_currentFrameDrawFingerprints.clear();
+    m_currentFrameDrawFingerprints.shrink_to_fit();
+
     m_intersectionBoard = nullptr;
 }
 
@@ -152,12 +211,15 @@ void PLSRenderContext::LogicalFlush::rewind()
     m_pendingSimpleGradientWrites.clear();
     m_complexGradients.clear();
     m_pendingComplexColorRampDraws.clear();
+    m_paintIDs.clear();
     m_clips.clear();
     m_plsDraws.clear();
     m_combinedDrawBounds = {std::numeric_limits<int32_t>::max(),
                             std::numeric_limits<int32_t>::max(),
                             std::numeric_limits<int32_t>::min(),
                             std::numeric_limits<int32_t>::min()};
+    m_redrawsDamageRegionOnly = false;
+    m_offscreenRenderTarget = nullptr;
 
     m_pathPaddingCount = 0;
     m_paintPaddingCount = 0;
@@ -175,6 +237,7 @@ void PLSRenderContext::LogicalFlush::rewind()
 
     m_currentPathIsStroked = false;
     m_currentPathContourDirections = pls::ContourDirections::none;
+    m_currentPathParametricPrecisionBits = 0;
     m_currentPathID = 0;
     m_currentContourID = 0;
     m_currentContourPaddingVertexCount = 0;
@@ -210,6 +273,9 @@ void PLSRenderContext::LogicalFlush::resetContainers()
     m_pendingComplexColorRampDraws.clear();
     m_pendingComplexColorRampDraws.shrink_to_fit();
     m_pendingComplexColorRampDraws.reserve(kDefaultComplexGradientCapacity);
+
+    m_paintIDs.rehash(0);
+    m_paintIDs.reserve(kDefaultPaintCapacity);
 }
 
 void PLSRenderContext::beginFrame(const FrameDescriptor& frameDescriptor)
@@ -218,6 +284,7 @@ void PLSRenderContext::beginFrame(const FrameDescriptor& frameDescriptor)
     assert(frameDescriptor.renderTargetWidth > 0);
     assert(frameDescriptor.renderTargetHeight > 0);
     m_frameDescriptor = frameDescriptor;
+    ++m_frameNumber;
     if (m_frameDescriptor.msaaSampleCount > 0 || !platformFeatures().supportsPixelLocalStorage)
     {
         m_frameInterlockMode = pls::InterlockMode::depthStencil;
@@ -245,6 +312,10 @@ bool PLSRenderContext::isOutsideCurrentFrame(const IAABB& pixelBounds)
     int4 bounds = simd::load4i(&pixelBounds);
     auto renderTargetSize = simd::cast<int32_t>(
         uint2{m_frameDescriptor.renderTargetWidth, m_frameDescriptor.renderTargetHeight});
+    if (const PLSRenderTarget* offscreenTarget = m_logicalFlushes.back()->offscreenRenderTarget())
+    {
+        renderTargetSize = simd::cast<int32_t>(offscreenTarget->size());
+    }
     return simd::any(bounds.xy >= renderTargetSize || bounds.zw <= 0 || bounds.xy >= bounds.zw);
 }
 
@@ -262,6 +333,13 @@ bool PLSRenderContext::frameSupportsImagePaintForPaths() const
            platformFeatures().supportsBindlessTextures;
 }
 
+bool PLSRenderContext::frameSupportsAnalyticShapes() const
+{
+    assert(m_didBeginFrame);
+    return m_frameInterlockMode != pls::InterlockMode::depthStencil &&
+           platformFeatures().supportsAnalyticShapes;
+}
+
 uint32_t PLSRenderContext::generateClipID(const IAABB& contentBounds)
 {
     assert(m_didBeginFrame);
@@ -296,6 +374,24 @@ void PLSRenderContext::LogicalFlush::addClipReadBounds(uint32_t clipID, const IA
     clipInfo.readBounds = clipInfo.readBounds.join(bounds);
 }
 
+bool PLSRenderContext::LogicalFlush::isClipContentIntact(uint32_t clipID) const
+{
+    assert(clipID > 0);
+    if (clipID > m_clips.size())
+    {
+        return false;
+    }
+    const IAABB& contentBounds = m_clips[clipID - 1].contentBounds;
+    for (size_t i = clipID; i < m_clips.size(); ++i)
+    {
+        if (!contentBounds.intersect(m_clips[i].contentBounds).empty())
+        {
+            return false; // A subsequent clip update may have overwritten this clip's coverage.
+        }
+    }
+    return true;
+}
+
 bool PLSRenderContext::pushDrawBatch(PLSDrawUniquePtr draws[], size_t drawCount)
 {
     assert(m_didBeginFrame);
@@ -431,12 +527,91 @@ void PLSRenderContext::logicalFlush()
     // Reset clipping state after every logical flush because the clip buffer is not preserved
     // between render passes.
     m_clipContentID = 0;
+    m_logicalFlushID = ++m_lastLogicalFlushID;
 
     // Don't issue any GPU commands between logical flushes. Instead, build up a list of flushes
     // that we will submit all at once at the end of the frame.
     m_logicalFlushes.emplace_back(new LogicalFlush(this));
 }
 
+void PLSRenderContext::precompileShaders(const std::vector<pls::ShaderVariant>& variants)
+{
+    assert(!m_didBeginFrame);
+    std::vector<pls::ShaderVariant> supportedVariants;
+    supportedVariants.reserve(variants.size());
+    for (pls::ShaderVariant variant : variants)
+    {
+        switch (variant.interlockMode)
+        {
+            case pls::InterlockMode::rasterOrdering:
+                if (!platformFeatures().supportsRasterOrdering)
+                {
+                    continue;
+                }
+                break;
+            case pls::InterlockMode::atomics:
+                if (!platformFeatures().supportsPixelLocalStorage)
+                {
+                    continue;
+                }
+                break;
+            case pls::InterlockMode::depthStencil:
+                break;
+        }
+        if (variant.drawType == pls::DrawType::analyticShapes &&
+            !platformFeatures().supportsAnalyticShapes)
+        {
+            continue;
+        }
+        variant.shaderFeatures &=
+            pls::ShaderFeaturesMaskFor(variant.drawType, variant.interlockMode);
+        supportedVariants.push_back(variant);
+    }
+    if (!supportedVariants.empty())
+    {
+        m_impl->precompileShaders(supportedVariants);
+    }
+}
+
+bool PLSRenderContext::makeOffscreenTarget(uint32_t width,
+                                           uint32_t height,
+                                           OffscreenTarget* target)
+{
+    assert(width > 0 && height > 0);
+    *target = OffscreenTarget();
+    if (!m_impl->makeOffscreenTarget(width, height, target))
+    {
+        return false;
+    }
+    assert(target->texture->hasPremultipliedAlpha());
+    return true;
+}
+
+void PLSRenderContext::beginOffscreenLogicalFlush(rcp<PLSRenderTarget> renderTarget)
+{
+    assert(m_didBeginFrame);
+    assert(renderTarget != nullptr);
+    assert(m_logicalFlushes.back()->offscreenRenderTarget() == nullptr); // No nesting.
+    m_suspendedClipContentID = m_clipContentID;
+    m_suspendedLogicalFlushID = m_logicalFlushID;
+    logicalFlush();
+    m_logicalFlushes.back()->setOffscreenRenderTarget(std::move(renderTarget));
+}
+
+void PLSRenderContext::endOffscreenLogicalFlush()
+{
+    assert(m_didBeginFrame);
+    size_t n = m_logicalFlushes.size();
+    assert(n >= 2);
+    assert(m_logicalFlushes[n - 1]->offscreenRenderTarget() != nullptr);
+    assert(m_logicalFlushes[n - 2]->offscreenRenderTarget() == nullptr);
+    // Move the offscreen flush in front of the suspended one. Its texture may be sampled by draws
+    // in the suspended flush, and this way the main render target's pass stays in one piece.
+    std::swap(m_logicalFlushes[n - 1], m_logicalFlushes[n - 2]);
+    m_clipContentID = m_suspendedClipContentID;
+    m_logicalFlushID = m_suspendedLogicalFlushID;
+}
+
 void PLSRenderContext::flush(const FlushResources& flushResources)
 {
     assert(m_didBeginFrame);
@@ -444,17 +619,39 @@ void PLSRenderContext::flush(const FlushResources& flushResources)
     assert(flushResources.renderTarget->height() == m_frameDescriptor.renderTargetHeight);
 
     m_clipContentID = 0;
+    m_logicalFlushID = ++m_lastLogicalFlushID;
+
+    if (m_frameDescriptor.retainedFrame)
+    {
+        applyDamageTracking(flushResources);
+    }
+    else
+    {
+        m_lastFrameWasRetained = false;
+    }
+
+    for (const auto& logicalFlush : m_logicalFlushes)
+    {
+        logicalFlush->cullOccludedDraws();
+    }
 
     // Layout this frame's resource buffers and textures.
     LogicalFlush::ResourceCounters totalFrameResourceCounts;
     LogicalFlush::LayoutCounters layoutCounts;
+    bool didLayoutMainRenderTargetFlush = false;
+    assert(m_logicalFlushes.back()->offscreenRenderTarget() == nullptr);
     for (size_t i = 0; i < m_logicalFlushes.size(); ++i)
     {
         m_logicalFlushes[i]->layoutResources(flushResources,
                                              i,
+                                             !didLayoutMainRenderTargetFlush,
                                              i == m_logicalFlushes.size() - 1,
                                              &totalFrameResourceCounts,
                                              &layoutCounts);
+        if (m_logicalFlushes[i]->offscreenRenderTarget() == nullptr)
+        {
+            didLayoutMainRenderTargetFlush = true;
+        }
     }
     assert(layoutCounts.maxGradTextureHeight <= kMaxTextureHeight);
     assert(layoutCounts.maxTessTextureHeight <= kMaxTextureHeight);
@@ -479,33 +676,20 @@ void PLSRenderContext::flush(const FlushResources& flushResources)
     allocs.gradTextureHeight = layoutCounts.maxGradTextureHeight;
     allocs.tessTextureHeight = layoutCounts.maxTessTextureHeight;
 
-    // Track m_maxRecentResourceRequirements so we can trim GPU allocations when steady-state usage
-    // goes down.
-    m_maxRecentResourceRequirements =
-        simd::max(allocs.toVec(), m_maxRecentResourceRequirements.toVec());
-
-    // Grow resources enough to handle this flush.
-    // If "allocs" already fits in our current allocations, then don't change them.
-    // If they don't fit, overallocate by 25% in order to create some slack for growth.
-    allocs = simd::if_then_else(allocs.toVec() <= m_currentResourceAllocations.toVec(),
-                                m_currentResourceAllocations.toVec(),
-                                allocs.toVec() * size_t(5) / size_t(4));
+    m_peakResourceRequirements = simd::max(allocs.toVec(), m_peakResourceRequirements.toVec());
 
-    // Additionally, every 5 seconds, trim resources down to the most recent steady-state usage.
+    // Let the policy decide how much to actually allocate.
     double flushTime = m_impl->secondsNow();
-    bool needsResourceTrim = flushTime - m_lastResourceTrimTimeInSeconds >= 5;
-    if (needsResourceTrim)
-    {
-        // Trim GPU resource allocations to 125% of their maximum recent usage, and only if the
-        // recent usage is 2/3 or less of the current allocation.
-        allocs = simd::if_then_else(m_maxRecentResourceRequirements.toVec() <=
-                                        allocs.toVec() * size_t(2) / size_t(3),
-                                    m_maxRecentResourceRequirements.toVec() * size_t(5) / size_t(4),
-                                    allocs.toVec());
+    allocs = m_resourceAllocationPolicy->computeAllocations(allocs,
+                                                            m_currentResourceAllocations,
+                                                            framePlatformFeatures(),
+                                                            flushTime);
 
-        // Zero out m_maxRecentResourceRequirements for the next interval.
-        m_maxRecentResourceRequirements = ResourceAllocationCounts();
-        m_lastResourceTrimTimeInSeconds = flushTime;
+    // Every 5 seconds, also reset the CPU-side containers so they don't have unbounded growth.
+    bool needsContainerReset = flushTime - m_lastContainerResetTimeInSeconds >= 5;
+    if (needsContainerReset)
+    {
+        m_lastContainerResetTimeInSeconds = flushTime;
     }
 
     setResourceSizes(allocs);
@@ -530,7 +714,9 @@ void PLSRenderContext::flush(const FlushResources& flushResources)
            totalFrameResourceCounts.contourCount + layoutCounts.contourPaddingCount);
     assert(m_simpleColorRampsData.elementsWritten() == layoutCounts.simpleGradCount);
     assert(m_gradSpanData.elementsWritten() == totalFrameResourceCounts.complexGradientSpanCount);
-    assert(m_tessSpanData.elementsWritten() <= totalFrameResourceCounts.maxTessellatedSegmentCount);
+    assert(m_tessSpanData.bytesWritten() + m_tessSpanCompactData.bytesWritten() <=
+           totalFrameResourceCounts.maxTessellatedSegmentCount *
+               pls::TessVertexSpanSizeInBytes(framePlatformFeatures()));
     assert(m_triangleVertexData.elementsWritten() <=
            totalFrameResourceCounts.maxTriangleVertexCount);
 
@@ -548,7 +734,8 @@ void PLSRenderContext::flush(const FlushResources& flushResources)
         m_logicalFlushes.front()->rewind();
     }
 
-    // Drop all memory that was allocated for this frame using TrivialBlockAllocator.
+    // Drop all memory that was allocated for this frame using TrivialBlockAllocator. (The blocks
+    // themselves are retained for future frames, subject to each allocator's retention policy.)
     m_perFrameAllocator.reset();
     m_numChopsAllocator.reset();
     m_chopVerticesAllocator.reset();
@@ -557,18 +744,363 @@ void PLSRenderContext::flush(const FlushResources& flushResources)
     m_parametricSegmentCountsAllocator.reset();
 
     m_frameDescriptor = FrameDescriptor();
+    m_frameNeedsFullTessVertexSpans = false;
 
     RIVE_DEBUG_CODE(m_didBeginFrame = false;)
 
     // Wait to reset CPU-side containers until after the flush has finished.
-    if (needsResourceTrim)
+    if (needsContainerReset)
     {
         resetContainers();
     }
 }
 
+void PLSRenderContext::applyDamageTracking(const FlushResources& flushResources)
+{
+    // Only fingerprint draws to the renderTarget. Offscreen flushes reach the renderTarget via
+    // draws that hash their texture, and offscreen textures are never re-rendered, so any change
+    // in offscreen contents already shows up as a changed draw to the renderTarget.
+    m_currentFrameDrawFingerprints.clear();
+    bool isFrameHashable = true;
+    LogicalFlush* mainRenderTargetFlush = nullptr;
+    size_t mainRenderTargetFlushCount = 0;
+    for (const auto& flush : m_logicalFlushes)
+    {
+        if (flush->offscreenRenderTarget() != nullptr)
+        {
+            continue;
+        }
+        mainRenderTargetFlush = flush.get();
+        ++mainRenderTargetFlushCount;
+        isFrameHashable &= flush->appendDrawFingerprints(&m_currentFrameDrawFingerprints);
+    }
+    if (!isFrameHashable)
+    {
+        // We can't tell whether an unhashable draw changed, so neither this frame nor the next
+        // can be compared against the one before it.
+        m_lastFrameWasRetained = false;
+        m_lastFrameDrawFingerprints.clear();
+        return;
+    }
+
+    // We can only redraw a partial region if the previous frame left the same contents behind in
+    // the same renderTarget, and if the draw lists line up one-to-one.
+    bool canRedrawDamageRegionOnly =
+        m_lastFrameWasRetained && mainRenderTargetFlushCount == 1 &&
+        m_frameDescriptor.loadAction == pls::LoadAction::clear &&
+        colorAlpha(m_frameDescriptor.clearColor) == 255 &&
+        m_frameDescriptor.clearColor == m_lastFrameClearColor &&
+        flushResources.renderTarget == m_lastFrameRenderTarget &&
+        m_frameInterlockMode == m_lastFrameInterlockMode && frameSupportsClipRects() &&
+        m_currentFrameDrawFingerprints.size() == m_lastFrameDrawFingerprints.size();
+
+    if (canRedrawDamageRegionOnly)
+    {
+        // The damage region is the union of old and new bounds from every draw that changed.
+        IAABB damageBounds = {std::numeric_limits<int32_t>::max(),
+                              std::numeric_limits<int32_t>::max(),
+                              std::numeric_limits<int32_t>::min(),
+                              std::numeric_limits<int32_t>::min()};
+        for (size_t i = 0; i < m_currentFrameDrawFingerprints.size(); ++i)
+        {
+            const DrawFingerprint& current = m_currentFrameDrawFingerprints[i];
+            const DrawFingerprint& last = m_lastFrameDrawFingerprints[i];
+            if (current.contentHash != last.contentHash ||
+                simd::any(simd::load4i(&current.pixelBounds) != simd::load4i(&last.pixelBounds)))
+            {
+                damageBounds = damageBounds.join(current.pixelBounds).join(last.pixelBounds);
+            }
+        }
+        IAABB renderTargetBounds = flushResources.renderTarget->bounds();
+        damageBounds = renderTargetBounds.intersect(damageBounds);
+        if (damageBounds.empty())
+        {
+            damageBounds = {0, 0, 0, 0};
+        }
+        if (simd::any(simd::load4i(&damageBounds) != simd::load4i(&renderTargetBounds)))
+        {
+            // If this fails, it just means we render the entire frame.
+            RIVE_MAYBE_UNUSED bool success =
+                mainRenderTargetFlush->redrawDamageRegionOnly(damageBounds,
+                                                              m_frameDescriptor.clearColor);
+        }
+    }
+
+    std::swap(m_lastFrameDrawFingerprints, m_currentFrameDrawFingerprints);
+    m_lastFrameWasRetained = true;
+    m_lastFrameRenderTarget = flushResources.renderTarget;
+    m_lastFrameClearColor = m_frameDescriptor.clearColor;
+    m_lastFrameInterlockMode = m_frameInterlockMode;
+}
+
+bool PLSRenderContext::LogicalFlush::appendDrawFingerprints(
+    std::vector<DrawFingerprint>* fingerprints) const
+{
+    bool isHashable = true;
+    for (const PLSDrawUniquePtr& draw : m_plsDraws)
+    {
+        if (!draw->isContentHashable())
+        {
+            isHashable = false;
+            continue;
+        }
+        fingerprints->push_back({draw->pixelBounds(), draw->contentHash()});
+    }
+    return isHashable;
+}
+
+// Intersects "rect" with the pixel-space region of the given clipRect.
+// Returns false if the clipRect is not axis-aligned in pixel space.
+static bool intersect_with_clip_rect(AABB* rect, const pls::ClipRectInverseMatrix& clipRect)
+{
+    const Mat2D& m = clipRect.inverseMatrix();
+    if (m.xy() != 0 || m.yx() != 0)
+    {
+        return false;
+    }
+    if (m.xx() == 0 || m.yy() == 0)
+    {
+        // Singular clipRects use tx and ty as fixed coverage values. (See WideOpen() and Empty().)
+        if (m.tx() == 0 || m.ty() == 0)
+        {
+            *rect = AABB{0, 0, 0, 0};
+        }
+        return true;
+    }
+    // "m" maps from pixel space to a space where the clipRect is [-1, -1, +1, +1].
+    Mat2D clipRectToPixels;
+    if (!m.invert(&clipRectToPixels))
+    {
+        return false;
+    }
+    float4 a = simd::load4f(rect);
+    AABB pixelClipRect = clipRectToPixels.mapBoundingBox(AABB{-1, -1, 1, 1});
+    float4 b = simd::load4f(&pixelClipRect);
+    simd::store(rect, simd::join(simd::max(a.xy, b.xy), simd::min(a.zw, b.zw)));
+    return true;
+}
+
+void PLSRenderContext::LogicalFlush::cullOccludedDraws()
+{
+    assert(!m_hasDoneLayout);
+
+    // Walk the draws from front to back, remembering the largest few occluders seen so far.
+    // Anything that lands entirely inside an occluder drawn after it is invisible.
+    constexpr static size_t kMaxOccluders = 4;
+    std::array<IAABB, kMaxOccluders> occluders;
+    size_t occluderCount = 0;
+    auto area = [](const IAABB& r) { return int64_t(r.width()) * int64_t(r.height()); };
+    auto contains = [](const IAABB& outer, const IAABB& inner) {
+        return outer.left <= inner.left && outer.top <= inner.top && inner.right <= outer.right &&
+               inner.bottom <= outer.bottom;
+    };
+
+    bool didCull = false;
+    for (size_t i = m_plsDraws.size(); i-- > 0;)
+    {
+        PLSDrawUniquePtr& draw = m_plsDraws[i];
+        bool isClipUpdate = (draw->drawContents() & pls::DrawContents::clipUpdate) ||
+                            draw->type() == PLSDraw::Type::stencilClipReset;
+        if (!isClipUpdate)
+        {
+            const IAABB& pixelBounds = draw->pixelBounds();
+            bool isOccluded = false;
+            for (size_t j = 0; j < occluderCount && !isOccluded; ++j)
+            {
+                isOccluded = contains(occluders[j], pixelBounds);
+            }
+            if (isOccluded)
+            {
+                draw.reset();
+                didCull = true;
+                continue;
+            }
+        }
+
+        const IAABB& coverage = draw->opaqueCoverageBounds();
+        if (coverage.empty() || draw->clipID() != 0 || draw->hasClipRect())
+        {
+            continue;
+        }
+        if (occluderCount < kMaxOccluders)
+        {
+            occluders[occluderCount++] = coverage;
+        }
+        else
+        {
+            // Replace the smallest occluder if this one is bigger.
+            auto smallest = std::min_element(occluders.begin(),
+                                             occluders.end(),
+                                             [&](const IAABB& a, const IAABB& b) {
+                                                 return area(a) < area(b);
+                                             });
+            if (area(coverage) > area(*smallest))
+            {
+                *smallest = coverage;
+            }
+        }
+    }
+
+    if (!didCull)
+    {
+        return;
+    }
+
+    // Compact the draw list and recount the resources of the draws that remain. (Gradients were
+    // already allocated, so their counts stay the same.)
+    auto countsVector = ResourceCounters().toVec();
+    size_t n = 0;
+    for (size_t i = 0; i < m_plsDraws.size(); ++i)
+    {
+        if (m_plsDraws[i] == nullptr)
+        {
+            continue;
+        }
+        countsVector += m_plsDraws[i]->resourceCounts().toVec();
+        if (n != i)
+        {
+            m_plsDraws[n] = std::move(m_plsDraws[i]);
+        }
+        ++n;
+    }
+    m_plsDraws.resize(n);
+
+    ResourceCounters counts = countsVector;
+    counts.complexGradientSpanCount = m_resourceCounts.complexGradientSpanCount;
+    m_resourceCounts = counts;
+}
+
+bool PLSRenderContext::LogicalFlush::redrawDamageRegionOnly(const IAABB& damageBounds,
+                                                            ColorInt clearColor)
+{
+    assert(!m_hasDoneLayout);
+    assert(m_ctx->frameSupportsClipRects());
+    assert(colorAlpha(clearColor) == 255);
+
+    // Draws that write color inside the damage region get clipped to it. (Clip updates and stencil
+    // resets don't write color, so their effects outside the damage region are never observed.)
+    auto writesColor = [](const PLSDraw* draw) {
+        return !(draw->drawContents() & pls::DrawContents::clipUpdate);
+    };
+
+    // Make sure every draw can be clipped to the damage region before we modify anything.
+    AABB damageRect(damageBounds);
+    auto countsVector = ResourceCounters().toVec();
+    size_t keptDrawCount = 0;
+    for (const PLSDrawUniquePtr& draw : m_plsDraws)
+    {
+        if (draw->pixelBounds().intersect(damageBounds).empty())
+        {
+            continue;
+        }
+        AABB unusedRect = damageRect;
+        if (writesColor(draw.get()) && draw->hasClipRect() &&
+            !intersect_with_clip_rect(&unusedRect, *draw->clipRectInverseMatrix()))
+        {
+            return false;
+        }
+        countsVector += draw->resourceCounts().toVec();
+        ++keptDrawCount;
+    }
+
+    // Since we aren't clearing the renderTarget anymore, clear the damage region with an opaque
+    // rectangle instead.
+    PLSDrawUniquePtr clearDraw;
+    if (!damageBounds.empty())
+    {
+        auto clearPath = make_rcp<PLSPath>();
+        clearPath->moveTo(damageRect.left(), damageRect.top());
+        clearPath->lineTo(damageRect.right(), damageRect.top());
+        clearPath->lineTo(damageRect.right(), damageRect.bottom());
+        clearPath->lineTo(damageRect.left(), damageRect.bottom());
+        PLSPaint clearPaint;
+        clearPaint.color(clearColor);
+        RawPath scratchPath;
+        clearDraw = PLSPathDraw::Make(m_ctx,
+                                      Mat2D(),
+                                      std::move(clearPath),
+                                      FillRule::nonZero,
+                                      &clearPaint,
+                                      &scratchPath);
+        countsVector += clearDraw->resourceCounts().toVec();
+        ++keptDrawCount;
+    }
+
+    ResourceCounters counts = countsVector;
+    counts.complexGradientSpanCount = m_resourceCounts.complexGradientSpanCount;
+    if (counts.pathCount > m_ctx->m_maxPathID || counts.contourCount > kMaxContourID ||
+        counts.midpointFanTessVertexCount + counts.outerCubicTessVertexCount >
+            kMaxTessellationVertexCountBeforePadding ||
+        (m_flushDesc.interlockMode == pls::InterlockMode::atomics &&
+         keptDrawCount > kMaxReorderedDrawCount))
+    {
+        return false;
+    }
+
+    // Now drop and clip.
+    const pls::ClipRectInverseMatrix* damageClipRect =
+        m_ctx->make<pls::ClipRectInverseMatrix>(Mat2D(), damageRect);
+    const pls::ClipRectInverseMatrix* lastOriginalClipRect = nullptr;
+    const pls::ClipRectInverseMatrix* lastIntersectedClipRect = nullptr;
+    m_combinedDrawBounds = {std::numeric_limits<int32_t>::max(),
+                            std::numeric_limits<int32_t>::max(),
+                            std::numeric_limits<int32_t>::min(),
+                            std::numeric_limits<int32_t>::min()};
+    size_t n = 0;
+    for (size_t i = 0; i < m_plsDraws.size(); ++i)
+    {
+        PLSDraw* draw = m_plsDraws[i].get();
+        IAABB clippedBounds = draw->pixelBounds().intersect(damageBounds);
+        if (clippedBounds.empty())
+        {
+            continue;
+        }
+        if (writesColor(draw))
+        {
+            if (!draw->hasClipRect())
+            {
+                draw->setClipRect(damageClipRect);
+            }
+            else
+            {
+                // Draws under the same clip tend to share the same ClipRectInverseMatrix.
+                if (draw->clipRectInverseMatrix() != lastOriginalClipRect)
+                {
+                    lastOriginalClipRect = draw->clipRectInverseMatrix();
+                    AABB intersectedRect = damageRect;
+                    RIVE_MAYBE_UNUSED bool success =
+                        intersect_with_clip_rect(&intersectedRect, *lastOriginalClipRect);
+                    assert(success);
+                    lastIntersectedClipRect =
+                        m_ctx->make<pls::ClipRectInverseMatrix>(Mat2D(), intersectedRect);
+                }
+                draw->setClipRect(lastIntersectedClipRect);
+            }
+        }
+        m_combinedDrawBounds = m_combinedDrawBounds.join(clippedBounds);
+        if (n != i)
+        {
+            m_plsDraws[n] = std::move(m_plsDraws[i]);
+        }
+        ++n;
+    }
+    m_plsDraws.resize(n);
+
+    if (clearDraw != nullptr)
+    {
+        clearDraw->setClipRect(damageClipRect);
+        m_combinedDrawBounds = m_combinedDrawBounds.join(damageBounds);
+        m_plsDraws.insert(m_plsDraws.begin(), std::move(clearDraw));
+    }
+
+    m_resourceCounts = counts;
+    m_redrawsDamageRegionOnly = true;
+    return true;
+}
+
 void PLSRenderContext::LogicalFlush::layoutResources(const FlushResources& flushResources,
                                                      size_t logicalFlushIdx,
+                                                     bool isFirstFlushToMainRenderTarget,
                                                      bool isFinalFlushOfFrame,
                                                      ResourceCounters* runningFrameResourceCounts,
                                                      LayoutCounters* runningFrameLayoutCounts)
@@ -631,7 +1163,8 @@ void PLSRenderContext::LogicalFlush::layoutResources(const FlushResources& flush
         m_resourceCounts.maxTessellatedSegmentCount += maxSpanBreakCount + kPaddingSpanCount;
     }
 
-    m_flushDesc.renderTarget = flushResources.renderTarget;
+    m_flushDesc.renderTarget = m_offscreenRenderTarget != nullptr ? m_offscreenRenderTarget.get()
+                                                                  : flushResources.renderTarget;
     m_flushDesc.interlockMode = m_ctx->frameInterlockMode();
     m_flushDesc.msaaSampleCount = frameDescriptor.msaaSampleCount;
 
@@ -639,11 +1172,21 @@ void PLSRenderContext::LogicalFlush::layoutResources(const FlushResources& flush
     // into the atomic "resolve" operation instead.
     bool doClearDuringAtomicResolve = false;
 
-    if (logicalFlushIdx != 0)
+    if (m_offscreenRenderTarget != nullptr)
+    {
+        // Offscreen targets always begin transparent.
+        m_flushDesc.colorLoadAction = pls::LoadAction::clear;
+    }
+    else if (!isFirstFlushToMainRenderTarget)
     {
         // We always have to preserve the renderTarget between logical flushes.
         m_flushDesc.colorLoadAction = pls::LoadAction::preserveRenderTarget;
     }
+    else if (m_redrawsDamageRegionOnly)
+    {
+        // Everything outside the damage region is still valid from the previous frame.
+        m_flushDesc.colorLoadAction = pls::LoadAction::preserveRenderTarget;
+    }
     else if (frameDescriptor.loadAction == pls::LoadAction::clear)
     {
         // In atomic mode, we can clear during the resolve operation if the clearColor is opaque
@@ -657,7 +1200,7 @@ void PLSRenderContext::LogicalFlush::layoutResources(const FlushResources& flush
     {
         m_flushDesc.colorLoadAction = frameDescriptor.loadAction;
     }
-    m_flushDesc.clearColor = frameDescriptor.clearColor;
+    m_flushDesc.clearColor = m_offscreenRenderTarget != nullptr ? 0 : frameDescriptor.clearColor;
 
     if (doClearDuringAtomicResolve)
     {
@@ -755,7 +1298,8 @@ void PLSRenderContext::LogicalFlush::writeResources()
     m_gradTextureLayout.complexOffsetY = m_flushDesc.complexGradRowsTop;
 
     // Exact tessSpan/triangleVertex counts aren't known until after their data is written out.
-    m_flushDesc.firstTessVertexSpan = m_ctx->m_tessSpanData.elementsWritten();
+    m_flushDesc.firstTessVertexSpan = m_ctx->tessSpanElementsWritten();
+    m_flushDesc.compactTessVertexSpans = m_ctx->frameUsesCompactTessVertexSpans();
     size_t initialTriangleVertexDataSize = m_ctx->m_triangleVertexData.bytesWritten();
 
     m_ctx->m_flushUniformData.emplace_back(m_flushDesc, platformFeatures);
@@ -809,6 +1353,7 @@ void PLSRenderContext::LogicalFlush::writeResources()
     m_ctx->m_paintData.set_back(FillRule::nonZero,
                                 PaintType::solidColor,
                                 clearColorValue,
+                                /*imageTexture =*/nullptr,
                                 GradTextureLayout(),
                                 /*clipID =*/0,
                                 /*hasClipRect =*/false,
@@ -996,10 +1541,17 @@ void PLSRenderContext::LogicalFlush::writeResources()
         }
     }
 
+    // Paint records were deduplicated, so they may not have filled their entire reservation.
+    m_flushDesc.paintCount = m_ctx->m_paintData.elementsWritten() - m_flushDesc.firstPaint;
+    assert(m_flushDesc.paintCount <= m_flushDesc.pathCount);
+    assert(m_ctx->m_paintAuxData.elementsWritten() - m_flushDesc.firstPaintAux ==
+           m_flushDesc.paintCount);
+    size_t unusedPaintCount = m_flushDesc.pathCount - m_flushDesc.paintCount;
+
     // Pad our storage buffers to 256-byte alignment.
     m_ctx->m_pathData.push_back_n(nullptr, m_pathPaddingCount);
-    m_ctx->m_paintData.push_back_n(nullptr, m_paintPaddingCount);
-    m_ctx->m_paintAuxData.push_back_n(nullptr, m_paintAuxPaddingCount);
+    m_ctx->m_paintData.push_back_n(nullptr, unusedPaintCount + m_paintPaddingCount);
+    m_ctx->m_paintAuxData.push_back_n(nullptr, unusedPaintCount + m_paintAuxPaddingCount);
     m_ctx->m_contourData.push_back_n(nullptr, m_contourPaddingCount);
 
     assert(m_pathTessLocation == m_expectedPathTessLocationAtEndOfPath);
@@ -1009,7 +1561,7 @@ void PLSRenderContext::LogicalFlush::writeResources()
 
     // Update the flush descriptor's data counts that aren't known until it's written out.
     m_flushDesc.tessVertexSpanCount =
-        m_ctx->m_tessSpanData.elementsWritten() - m_flushDesc.firstTessVertexSpan;
+        m_ctx->tessSpanElementsWritten() - m_flushDesc.firstTessVertexSpan;
     m_flushDesc.hasTriangleVertices =
         m_ctx->m_triangleVertexData.bytesWritten() != initialTriangleVertexDataSize;
 
@@ -1134,12 +1686,13 @@ void PLSRenderContext::setResourceSizes(ResourceAllocationCounts allocs, bool fo
         m_impl->resizeGradSpanBuffer(allocs.complexGradSpanBufferCount * sizeof(pls::GradientSpan));
     }
 
-    LOG_BUFFER_RING_SIZE(tessSpanBufferCount, sizeof(pls::TessVertexSpan));
+    size_t tessSpanSizeInBytes = pls::TessVertexSpanSizeInBytes(framePlatformFeatures());
+    LOG_BUFFER_RING_SIZE(tessSpanBufferCount, tessSpanSizeInBytes);
     if (allocs.tessSpanBufferCount != m_currentResourceAllocations.tessSpanBufferCount ||
-        forceRealloc)
+        tessSpanSizeInBytes != m_currentTessSpanSizeInBytes || forceRealloc)
     {
-        m_impl->resizeTessVertexSpanBuffer(allocs.tessSpanBufferCount *
-                                           sizeof(pls::TessVertexSpan));
+        m_impl->resizeTessVertexSpanBuffer(allocs.tessSpanBufferCount * tessSpanSizeInBytes);
+        m_currentTessSpanSizeInBytes = tessSpanSizeInBytes;
     }
 
     LOG_BUFFER_RING_SIZE(triangleVertexBufferCount, sizeof(pls::TriangleVertex));
@@ -1238,11 +1791,22 @@ void PLSRenderContext::mapResourceBuffers(const ResourceAllocationCounts& mapCou
 
     if (mapCounts.tessSpanBufferCount > 0)
     {
-        m_tessSpanData.mapElements(m_impl.get(),
-                                   &PLSRenderContextImpl::mapTessVertexSpanBuffer,
-                                   mapCounts.tessSpanBufferCount);
+        if (frameUsesCompactTessVertexSpans())
+        {
+            // tessSpanBufferCount is already in units of compact spans.
+            m_tessSpanCompactData.mapElements(m_impl.get(),
+                                              &PLSRenderContextImpl::mapTessVertexSpanBuffer,
+                                              mapCounts.tessSpanBufferCount);
+        }
+        else
+        {
+            m_tessSpanData.mapElements(m_impl.get(),
+                                       &PLSRenderContextImpl::mapTessVertexSpanBuffer,
+                                       mapCounts.tessSpanBufferCount);
+        }
     }
-    assert(m_tessSpanData.hasRoomFor(mapCounts.tessSpanBufferCount));
+    assert(m_tessSpanData.hasRoomFor(mapCounts.tessSpanBufferCount) ||
+           m_tessSpanCompactData.hasRoomFor(mapCounts.tessSpanBufferCount));
 
     if (mapCounts.triangleVertexBufferCount > 0)
     {
@@ -1267,46 +1831,86 @@ void PLSRenderContext::unmapResourceBuffers()
     }
     if (m_pathData)
     {
-        m_impl->unmapPathBuffer();
+        m_impl->unmapPathBuffer(m_pathData.bytesWritten());
         m_pathData.reset();
     }
     if (m_paintData)
     {
-        m_impl->unmapPaintBuffer();
+        m_impl->unmapPaintBuffer(m_paintData.bytesWritten());
         m_paintData.reset();
     }
     if (m_paintAuxData)
     {
-        m_impl->unmapPaintAuxBuffer();
+        m_impl->unmapPaintAuxBuffer(m_paintAuxData.bytesWritten());
         m_paintAuxData.reset();
     }
     if (m_contourData)
     {
-        m_impl->unmapContourBuffer();
+        m_impl->unmapContourBuffer(m_contourData.bytesWritten());
         m_contourData.reset();
     }
     if (m_simpleColorRampsData)
     {
-        m_impl->unmapSimpleColorRampsBuffer();
+        m_impl->unmapSimpleColorRampsBuffer(m_simpleColorRampsData.bytesWritten());
         m_simpleColorRampsData.reset();
     }
     if (m_gradSpanData)
     {
-        m_impl->unmapGradSpanBuffer();
+        m_impl->unmapGradSpanBuffer(m_gradSpanData.bytesWritten());
         m_gradSpanData.reset();
     }
-    if (m_tessSpanData)
+    if (m_tessSpanData || m_tessSpanCompactData)
     {
-        m_impl->unmapTessVertexSpanBuffer();
+        // Only one of the two span encodings gets mapped per frame.
+        m_impl->unmapTessVertexSpanBuffer(m_tessSpanData.bytesWritten() +
+                                          m_tessSpanCompactData.bytesWritten());
         m_tessSpanData.reset();
+        m_tessSpanCompactData.reset();
     }
     if (m_triangleVertexData)
     {
-        m_impl->unmapTriangleVertexBuffer();
+        m_impl->unmapTriangleVertexBuffer(m_triangleVertexData.bytesWritten());
         m_triangleVertexData.reset();
     }
 }
 
+uint32_t PLSRenderContext::LogicalFlush::pushPaint(const PLSPathDraw* draw)
+{
+    assert(m_hasDoneLayout);
+
+    PaintRecordKey record{}; // Zero-initialize the fields that a paint type doesn't use.
+    record.paintData.set(draw->fillRule(),
+                         draw->paintType(),
+                         draw->simplePaintValue(),
+                         draw->imageTexture(),
+                         m_gradTextureLayout,
+                         draw->clipID(),
+                         draw->hasClipRect(),
+                         draw->blendMode());
+    record.paintAuxData.set(draw->matrix(),
+                            draw->paintType(),
+                            draw->simplePaintValue(),
+                            draw->gradient(),
+                            draw->imageTexture(),
+                            draw->clipRectInverseMatrix(),
+                            m_flushDesc.renderTarget,
+                            m_ctx->platformFeatures());
+
+    uint32_t paintID = m_ctx->m_paintData.elementsWritten() - m_flushDesc.firstPaint;
+    if (m_flushDesc.interlockMode != pls::InterlockMode::atomics)
+    {
+        auto [iter, isNew] = m_paintIDs.try_emplace(record, paintID);
+        if (!isNew)
+        {
+            return iter->second;
+        }
+    }
+    m_ctx->m_paintData.push_back_n(&record.paintData, 1);
+    m_ctx->m_paintAuxData.push_back_n(&record.paintAuxData, 1);
+    assert(m_flushDesc.firstPaintAux + paintID == m_ctx->m_paintAuxData.elementsWritten() - 1);
+    return paintID;
+}
+
 void PLSRenderContext::LogicalFlush::pushPaddingVertices(uint32_t tessLocation, uint32_t count)
 {
     assert(m_hasDoneLayout);
@@ -1319,7 +1923,22 @@ void PLSRenderContext::LogicalFlush::pushPaddingVertices(uint32_t tessLocation,
     m_pathTessLocation = tessLocation;
     RIVE_DEBUG_CODE(m_expectedPathTessLocationAtEndOfPath = m_pathTessLocation + count;)
     assert(m_expectedPathTessLocationAtEndOfPath <= kMaxTessellationVertexCount);
-    pushTessellationSpans(kEmptyCubic, {0, 0}, count, 0, 0, 1, kInvalidContourID);
+    if (m_flushDesc.compactTessVertexSpans)
+    {
+        pushCompactTessellationSpans(kEmptyCubic,
+                                     {0, 0},
+                                     {0, 0},
+                                     count,
+                                     0,
+                                     0,
+                                     1,
+                                     kInvalidContourID,
+                                     /*mirrored=*/false);
+    }
+    else
+    {
+        pushTessellationSpans(kEmptyCubic, {0, 0}, count, 0, 0, 1, kInvalidContourID);
+    }
     assert(m_pathTessLocation == m_expectedPathTessLocationAtEndOfPath);
 }
 
@@ -1333,29 +1952,21 @@ void PLSRenderContext::LogicalFlush::pushPath(PLSPathDraw* draw,
 
     m_currentPathIsStroked = draw->strokeRadius() != 0;
     m_currentPathContourDirections = draw->contourDirections();
-    m_ctx->m_pathData.set_back(draw->matrix(), draw->strokeRadius(), m_currentZIndex);
-    m_ctx->m_paintData.set_back(draw->fillRule(),
-                                draw->paintType(),
-                                draw->simplePaintValue(),
-                                m_gradTextureLayout,
-                                draw->clipID(),
-                                draw->hasClipRect(),
-                                draw->blendMode());
-    m_ctx->m_paintAuxData.set_back(draw->matrix(),
-                                   draw->paintType(),
-                                   draw->simplePaintValue(),
-                                   draw->gradient(),
-                                   draw->imageTexture(),
-                                   draw->clipRectInverseMatrix(),
-                                   m_flushDesc.renderTarget,
-                                   m_ctx->platformFeatures());
+    // Round the precision up so the tessellation shader never culls segments the CPU counted on.
+    uint32_t parametricPrecisionFixed = static_cast<uint32_t>(
+        ceilf(draw->parametricPrecision() * PARAMETRIC_PRECISION_FIXED_POINT_FACTOR));
+    assert(parametricPrecisionFixed > 0);
+    assert(parametricPrecisionFixed <= PARAMETRIC_PRECISION_CONTOUR_DATA_MASK);
+    m_currentPathParametricPrecisionBits = parametricPrecisionFixed
+                                           << PARAMETRIC_PRECISION_CONTOUR_DATA_SHIFT;
+    uint32_t paintID = pushPaint(draw);
+    m_ctx->m_pathData.set_back(draw->matrix(), draw->strokeRadius(), m_currentZIndex, paintID);
 
     ++m_currentPathID;
     assert(0 < m_currentPathID && m_currentPathID <= m_ctx->m_maxPathID);
     assert(m_flushDesc.firstPath + m_currentPathID == m_ctx->m_pathData.elementsWritten() - 1);
-    assert(m_flushDesc.firstPaint + m_currentPathID == m_ctx->m_paintData.elementsWritten() - 1);
-    assert(m_flushDesc.firstPaintAux + m_currentPathID ==
-           m_ctx->m_paintAuxData.elementsWritten() - 1);
+    // Atomic mode looks paints up by pathID.
+    assert(m_flushDesc.interlockMode != pls::InterlockMode::atomics || paintID == m_currentPathID);
 
     pls::DrawType drawType;
     size_t tessLocation;
@@ -1409,15 +2020,17 @@ void PLSRenderContext::LogicalFlush::pushContour(Vec2D midpoint,
     assert(m_currentPathIsStroked || closed);
     assert(m_currentPathID != 0); // pathID can't be zero.
 
-    if (m_currentPathIsStroked)
+    uint32_t pathIDBits = m_currentPathID | m_currentPathParametricPrecisionBits;
+    if (m_currentPathIsStroked && closed)
     {
-        midpoint.x = closed ? 1 : 0;
+        pathIDBits |= CLOSED_STROKE_CONTOUR_DATA_FLAG;
     }
     // If the contour is closed, the shader needs a vertex to wrap back around to at the end of it.
     uint32_t vertexIndex0 = m_currentPathContourDirections & pls::ContourDirections::forward
                                 ? m_pathTessLocation
                                 : m_pathMirroredTessLocation - 1;
-    m_ctx->m_contourData.emplace_back(midpoint, m_currentPathID, vertexIndex0);
+    m_ctx->m_contourData.emplace_back(midpoint, pathIDBits, vertexIndex0);
+    m_currentContourMidpoint = midpoint;
     ++m_currentContourID;
     assert(0 < m_currentContourID && m_currentContourID <= pls::kMaxContourID);
     assert(m_flushDesc.firstContour + m_currentContourID == m_ctx->m_contourData.elementsWritten());
@@ -1441,6 +2054,40 @@ void PLSRenderContext::LogicalFlush::pushCubic(const Vec2D pts[4],
     assert(joinSegmentCount > 0);
     assert(m_currentContourID != 0); // contourID can't be zero.
 
+    if (m_flushDesc.compactTessVertexSpans)
+    {
+        uint32_t contourIDWithFlags = m_currentContourID | additionalContourFlags;
+        // Mirrored spans go first, to match pushMirroredAndForwardTessellationSpans().
+        if (m_currentPathContourDirections & pls::ContourDirections::reverse)
+        {
+            pushCompactTessellationSpans(pts,
+                                         m_currentContourMidpoint,
+                                         joinTangent,
+                                         m_currentContourPaddingVertexCount,
+                                         parametricSegmentCount,
+                                         polarSegmentCount,
+                                         joinSegmentCount,
+                                         contourIDWithFlags,
+                                         /*mirrored=*/true);
+        }
+        if (m_currentPathContourDirections & pls::ContourDirections::forward)
+        {
+            pushCompactTessellationSpans(pts,
+                                         m_currentContourMidpoint,
+                                         joinTangent,
+                                         m_currentContourPaddingVertexCount,
+                                         parametricSegmentCount,
+                                         polarSegmentCount,
+                                         joinSegmentCount,
+                                         contourIDWithFlags,
+                                         /*mirrored=*/false);
+        }
+        // Only the first curve of a contour gets padding vertices.
+        m_currentContourPaddingVertexCount = 0;
+        RIVE_DEBUG_CODE(++m_pathCurveCount;)
+        return;
+    }
+
     // Polar and parametric segments share the same beginning and ending vertices, so the merged
     // *vertex* count is equal to the sum of polar and parametric *segment* counts.
     uint32_t curveMergedVertexCount = parametricSegmentCount + polarSegmentCount;
@@ -1626,10 +2273,76 @@ RIVE_ALWAYS_INLINE void PLSRenderContext::LogicalFlush::pushMirroredAndForwardTe
     assert(m_pathMirroredTessLocation >= m_expectedPathMirroredTessLocationAtEndOfPath);
 }
 
+RIVE_ALWAYS_INLINE void PLSRenderContext::LogicalFlush::pushCompactTessellationSpans(
+    const Vec2D pts[4],
+    Vec2D origin,
+    Vec2D joinTangent,
+    uint32_t paddingVertexCount,
+    uint32_t parametricSegmentCount,
+    uint32_t polarSegmentCount,
+    uint32_t joinSegmentCount,
+    uint32_t contourIDWithFlags,
+    bool mirrored)
+{
+    assert(m_hasDoneLayout);
+
+    // -1 because the curve and join share an ending/beginning vertex.
+    uint32_t totalVertexCount =
+        paddingVertexCount + parametricSegmentCount + polarSegmentCount + joinSegmentCount - 1;
+    // The shader reconstructs x0, x1, and y from the span's first vertex (or last vertex, if
+    // mirrored) and its wrap index.
+    uint32_t tessLocation;
+    int32_t overflow;
+    if (!mirrored)
+    {
+        tessLocation = m_pathTessLocation;
+        overflow = static_cast<int32_t>(tessLocation % kTessTextureWidth + totalVertexCount) -
+                   static_cast<int32_t>(kTessTextureWidth);
+        m_pathTessLocation += totalVertexCount;
+        assert(m_pathTessLocation <= m_expectedPathTessLocationAtEndOfPath);
+    }
+    else
+    {
+        tessLocation = m_pathMirroredTessLocation - 1;
+        overflow = static_cast<int32_t>(totalVertexCount) -
+                   static_cast<int32_t>(tessLocation % kTessTextureWidth + 1);
+        m_pathMirroredTessLocation -= totalVertexCount;
+        assert(m_pathMirroredTessLocation >= m_expectedPathMirroredTessLocationAtEndOfPath);
+    }
+    for (uint32_t wrapIdx = 0;; ++wrapIdx)
+    {
+        m_ctx->m_tessSpanCompactData.set_back(pts,
+                                              origin,
+                                              joinTangent,
+                                              tessLocation,
+                                              wrapIdx,
+                                              mirrored,
+                                              paddingVertexCount,
+                                              parametricSegmentCount,
+                                              polarSegmentCount,
+                                              joinSegmentCount,
+                                              contourIDWithFlags);
+        if (overflow > 0)
+        {
+            // The span was too long to fit on the current line. Draw it again on the next line,
+            // shifted by the width of the texture so we capture what got clipped off last time.
+            overflow -= kTessTextureWidth;
+            continue;
+        }
+        break;
+    }
+}
+
 void PLSRenderContext::LogicalFlush::pushInteriorTriangulation(InteriorTriangulationDraw* draw)
 {
     assert(m_hasDoneLayout);
 
+    // The draw's outer curves were pushed immediately before its interior.
+    assert(!m_drawList.empty());
+    const DrawBatch& outerCurvesBatch = m_drawList.tail();
+    assert(outerCurvesBatch.drawType == DrawType::outerCurvePatches);
+    assert(outerCurvesBatch.internalDrawList == draw);
+
     assert(m_ctx->m_triangleVertexData.hasRoomFor(draw->triangulator()->maxVertexCount()));
     uint32_t baseVertex = m_ctx->m_triangleVertexData.elementsWritten();
     size_t actualVertexCount =
@@ -1640,6 +2353,59 @@ void PLSRenderContext::LogicalFlush::pushInteriorTriangulation(InteriorTriangula
     // Interior triangulations are allowed to disable raster ordering since they are guaranteed to
     // not overlap.
     batch.needsBarrier = true;
+
+    if (m_flushDesc.interlockMode == pls::InterlockMode::depthStencil)
+    {
+        // The interior and outer curves have both been stencilled. Draw the outer curves again to
+        // cover the regions that the interior triangles couldn't fill on their own.
+        DrawBatch& coverBatch = pushPathDraw(draw,
+                                             DrawType::outerCurvePatches,
+                                             outerCurvesBatch.elementCount,
+                                             outerCurvesBatch.baseElement);
+        coverBatch.isStencilCover = true;
+        // Don't let the next draw's outer curves get stencilled in this batch.
+        coverBatch.needsBarrier = true;
+    }
+}
+
+void PLSRenderContext::LogicalFlush::pushAnalyticShape(AnalyticShapeDraw* draw)
+{
+    assert(m_hasDoneLayout);
+    assert(m_flushDesc.interlockMode != pls::InterlockMode::depthStencil);
+
+    // The path matrix maps the shape's normalized coordinates to pixels. (Paints still use the
+    // draw's original matrix.)
+    uint32_t paintID = pushPaint(draw);
+    m_ctx->m_pathData.set_back(draw->shapeMatrix(), draw->strokeRadius(), m_currentZIndex, paintID);
+
+    ++m_currentPathID;
+    assert(0 < m_currentPathID && m_currentPathID <= m_ctx->m_maxPathID);
+    assert(m_flushDesc.firstPath + m_currentPathID == m_ctx->m_pathData.elementsWritten() - 1);
+    // Atomic mode looks paints up by pathID.
+    assert(m_flushDesc.interlockMode != pls::InterlockMode::atomics || paintID == m_currentPathID);
+
+    // Each AnalyticShapeVertex takes the place of 3 TriangleVertex records. Align them so the
+    // backend can address them directly.
+    while (m_ctx->m_triangleVertexData.elementsWritten() % kTriangleVerticesPerAnalyticShapeVertex)
+    {
+        m_ctx->m_triangleVertexData.skip_back();
+    }
+    assert(m_ctx->m_triangleVertexData.hasRoomFor(kAnalyticShapeVertexCount *
+                                                  kTriangleVerticesPerAnalyticShapeVertex));
+    uint32_t baseVertex =
+        m_ctx->m_triangleVertexData.elementsWritten() / kTriangleVerticesPerAnalyticShapeVertex;
+    auto [L, T, R, B] = draw->quadBounds();
+    const Vec2D quad[kAnalyticShapeVertexCount] = {{L, T}, {R, T}, {L, B}, {L, B}, {R, T}, {R, B}};
+    auto pathID = static_cast<uint16_t>(m_currentPathID);
+    for (Vec2D shapeCoord : quad)
+    {
+        m_ctx->m_triangleVertexData.emplace_back_as<AnalyticShapeVertex>(shapeCoord,
+                                                                         pathID,
+                                                                         draw->outerRadii(),
+                                                                         draw->innerRadii(),
+                                                                         draw->innerHalfSize());
+    }
+    pushPathDraw(draw, DrawType::analyticShapes, kAnalyticShapeVertexCount, baseVertex);
 }
 
 void PLSRenderContext::LogicalFlush::pushImageRect(ImageRectDraw* draw)
@@ -1653,10 +2419,12 @@ void PLSRenderContext::LogicalFlush::pushImageRect(ImageRectDraw* draw)
     size_t imageDrawDataOffset = m_ctx->m_imageDrawUniformData.bytesWritten();
     m_ctx->m_imageDrawUniformData.emplace_back(draw->matrix(),
                                                draw->opacity(),
+                                               draw->imageTexture(),
                                                draw->clipRectInverseMatrix(),
                                                draw->clipID(),
                                                draw->blendMode(),
-                                               m_currentZIndex);
+                                               m_currentZIndex,
+                                               draw->texCoordRect());
 
     DrawBatch& batch = pushDraw(draw, DrawType::imageRect, PaintType::image, 1, 0);
     batch.imageDrawDataOffset = imageDrawDataOffset;
@@ -1670,10 +2438,12 @@ void PLSRenderContext::LogicalFlush::pushImageMesh(ImageMeshDraw* draw)
     size_t imageDrawDataOffset = m_ctx->m_imageDrawUniformData.bytesWritten();
     m_ctx->m_imageDrawUniformData.emplace_back(draw->matrix(),
                                                draw->opacity(),
+                                               draw->imageTexture(),
                                                draw->clipRectInverseMatrix(),
                                                draw->clipID(),
                                                draw->blendMode(),
-                                               m_currentZIndex);
+                                               m_currentZIndex,
+                                               draw->texCoordRect());
 
     DrawBatch& batch = pushDraw(draw, DrawType::imageMesh, PaintType::image, draw->indexCount(), 0);
     batch.vertexBuffer = draw->vertexBuffer();
@@ -1763,6 +2533,7 @@ pls::DrawBatch& PLSRenderContext::LogicalFlush::pushDraw(PLSDraw* draw,
     {
         case DrawType::midpointFanPatches:
         case DrawType::outerCurvePatches:
+        case DrawType::analyticShapes:
         case DrawType::plsAtomicInitialize:
         case DrawType::plsAtomicResolve:
         case DrawType::stencilClipReset:
@@ -1806,9 +2577,10 @@ pls::DrawBatch& PLSRenderContext::LogicalFlush::pushDraw(PLSDraw* draw,
         batch.elementCount += elementCount;
     }
 
-    if (paintType == PaintType::image)
+    // Image paints and clip mask updates both sample the draw's texture.
+    assert(paintType != PaintType::image || draw->imageTexture() != nullptr);
+    if (draw->imageTexture() != nullptr)
     {
-        assert(draw->imageTexture() != nullptr);
         if (batch.imageTexture == nullptr)
         {
             batch.imageTexture = draw->imageTexture();
@@ -4,8 +4,11 @@
 
 #include "rive/pls/pls_render_context_helper_impl.hpp"
 
+#include "compressed_image.hpp"
+#include "pls_path.hpp"
 #include "rive/pls/pls_image.hpp"
 #include "shaders/constants.glsl"
+#include <vector>
 
 #ifdef RIVE_DECODERS
 #include "rive/decoders/bitmap_decoder.hpp"
@@ -13,17 +16,51 @@
 
 namespace rive::pls
 {
+#ifdef RIVE_DECODERS
+static std::unique_ptr<Bitmap> decode_rgba_bitmap(Span<const uint8_t> encodedBytes)
+{
+    auto bitmap = Bitmap::decode(encodedBytes.data(), encodedBytes.size());
+    // For now, PLSRenderContextImpl::makeImageTexture() only accepts RGBA.
+    if (bitmap && bitmap->pixelFormat() != Bitmap::PixelFormat::RGBA)
+    {
+        bitmap->pixelFormat(Bitmap::PixelFormat::RGBA);
+    }
+    return bitmap;
+}
+#endif
+
+rcp<PLSTexture> PLSRenderContextHelperImpl::decodeKTX2Texture(Span<const uint8_t> encodedBytes)
+{
+    CompressedImage image;
+    if (!ParseKTX2(encodedBytes, &image))
+    {
+        return nullptr;
+    }
+    if (rcp<PLSTexture> texture = makeCompressedImageTexture(image))
+    {
+        return texture;
+    }
+    // The backend can't sample this format. Transcode it on the CPU and let the GPU regenerate
+    // mipmaps.
+    std::vector<uint8_t> imageDataRGBA(static_cast<size_t>(image.width) * image.height * 4);
+    if (!DecodeCompressedImageRGBA(image, imageDataRGBA.data()))
+    {
+        return nullptr;
+    }
+    uint32_t mipLevelCount = math::msb(image.height | image.width);
+    return makeImageTexture(image.width, image.height, mipLevelCount, imageDataRGBA.data());
+}
+
 rcp<PLSTexture> PLSRenderContextHelperImpl::decodeImageTexture(Span<const uint8_t> encodedBytes)
 {
+    if (IsKTX2(encodedBytes))
+    {
+        return decodeKTX2Texture(encodedBytes);
+    }
 #ifdef RIVE_DECODERS
-    auto bitmap = Bitmap::decode(encodedBytes.data(), encodedBytes.size());
+    auto bitmap = decode_rgba_bitmap(encodedBytes);
     if (bitmap)
     {
-        // For now, PLSRenderContextImpl::makeImageTexture() only accepts RGBA.
-        if (bitmap->pixelFormat() != Bitmap::PixelFormat::RGBA)
-        {
-            bitmap->pixelFormat(Bitmap::PixelFormat::RGBA);
-        }
         uint32_t width = bitmap->width();
         uint32_t height = bitmap->height();
         uint32_t mipLevelCount = math::msb(height | width);
@@ -33,6 +70,55 @@ rcp<PLSTexture> PLSRenderContextHelperImpl::decodeImageTexture(Span<const uint8_
     return nullptr;
 }
 
+rcp<PLSImage> PLSRenderContextHelperImpl::decodeImage(Span<const uint8_t> encodedBytes)
+{
+    if (IsKTX2(encodedBytes))
+    {
+        // Compressed images keep their own texture and mip chain; they don't go in the atlas.
+        rcp<PLSTexture> texture = decodeKTX2Texture(encodedBytes);
+        return texture != nullptr ? make_rcp<PLSImage>(std::move(texture)) : nullptr;
+    }
+#ifdef RIVE_DECODERS
+    auto bitmap = decode_rgba_bitmap(encodedBytes);
+    if (!bitmap)
+    {
+        return nullptr;
+    }
+    uint32_t width = bitmap->width();
+    uint32_t height = bitmap->height();
+    if (m_imageAtlasEnabled && width <= PLSImageAtlasPage::kMaxImageSize &&
+        height <= PLSImageAtlasPage::kMaxImageSize)
+    {
+        IAABB region;
+        if (m_imageAtlasPage == nullptr ||
+            !m_imageAtlasPage->addImage(width, height, bitmap->bytes(), &region))
+        {
+            if (m_imageAtlasPage != nullptr)
+            {
+                m_imageAtlasPage->close();
+            }
+            m_imageAtlasPage = make_rcp<PLSImageAtlasPage>(this);
+            RIVE_MAYBE_UNUSED bool success =
+                m_imageAtlasPage->addImage(width, height, bitmap->bytes(), &region);
+            assert(success);
+        }
+        constexpr static float kInvSize = 1.f / PLSImageAtlasPage::kSize;
+        auto texCoordRectPath = make_rcp<PLSPath>();
+        texCoordRectPath->moveTo(region.left * kInvSize, region.top * kInvSize);
+        texCoordRectPath->lineTo(region.right * kInvSize, region.top * kInvSize);
+        texCoordRectPath->lineTo(region.right * kInvSize, region.bottom * kInvSize);
+        texCoordRectPath->lineTo(region.left * kInvSize, region.bottom * kInvSize);
+        texCoordRectPath->close();
+        return make_rcp<PLSImage>(m_imageAtlasPage, region, std::move(texCoordRectPath));
+    }
+    uint32_t mipLevelCount = math::msb(height | width);
+    rcp<PLSTexture> texture = makeImageTexture(width, height, mipLevelCount, bitmap->bytes());
+    return texture != nullptr ? make_rcp<PLSImage>(std::move(texture)) : nullptr;
+#else
+    return nullptr;
+#endif
+}
+
 void PLSRenderContextHelperImpl::resizeFlushUniformBuffer(size_t sizeInBytes)
 {
     m_flushUniformBuffer = makeUniformBufferRing(sizeInBytes);
@@ -147,28 +233,43 @@ void PLSRenderContextHelperImpl::unmapImageDrawUniformBuffer()
     m_imageDrawUniformBuffer->unmapAndSubmitBuffer();
 }
 
-void PLSRenderContextHelperImpl::unmapPathBuffer() { m_pathBuffer->unmapAndSubmitBuffer(); }
+void PLSRenderContextHelperImpl::unmapPathBuffer(size_t bytesWritten)
+{
+    m_pathBuffer->unmapAndSubmitBuffer(bytesWritten);
+}
 
-void PLSRenderContextHelperImpl::unmapPaintBuffer() { m_paintBuffer->unmapAndSubmitBuffer(); }
+void PLSRenderContextHelperImpl::unmapPaintBuffer(size_t bytesWritten)
+{
+    m_paintBuffer->unmapAndSubmitBuffer(bytesWritten);
+}
 
-void PLSRenderContextHelperImpl::unmapPaintAuxBuffer() { m_paintAuxBuffer->unmapAndSubmitBuffer(); }
+void PLSRenderContextHelperImpl::unmapPaintAuxBuffer(size_t bytesWritten)
+{
+    m_paintAuxBuffer->unmapAndSubmitBuffer(bytesWritten);
+}
 
-void PLSRenderContextHelperImpl::unmapContourBuffer() { m_contourBuffer->unmapAndSubmitBuffer(); }
+void PLSRenderContextHelperImpl::unmapContourBuffer(size_t bytesWritten)
+{
+    m_contourBuffer->unmapAndSubmitBuffer(bytesWritten);
+}
 
-void PLSRenderContextHelperImpl::unmapSimpleColorRampsBuffer()
+void PLSRenderContextHelperImpl::unmapSimpleColorRampsBuffer(size_t bytesWritten)
 {
-    m_simpleColorRampsBuffer->unmapAndSubmitBuffer();
+    m_simpleColorRampsBuffer->unmapAndSubmitBuffer(bytesWritten);
 }
 
-void PLSRenderContextHelperImpl::unmapGradSpanBuffer() { m_gradSpanBuffer->unmapAndSubmitBuffer(); }
+void PLSRenderContextHelperImpl::unmapGradSpanBuffer(size_t bytesWritten)
+{
+    m_gradSpanBuffer->unmapAndSubmitBuffer(bytesWritten);
+}
 
-void PLSRenderContextHelperImpl::unmapTessVertexSpanBuffer()
+void PLSRenderContextHelperImpl::unmapTessVertexSpanBuffer(size_t bytesWritten)
 {
-    m_tessSpanBuffer->unmapAndSubmitBuffer();
+    m_tessSpanBuffer->unmapAndSubmitBuffer(bytesWritten);
 }
 
-void PLSRenderContextHelperImpl::unmapTriangleVertexBuffer()
+void PLSRenderContextHelperImpl::unmapTriangleVertexBuffer(size_t bytesWritten)
 {
-    m_triangleBuffer->unmapAndSubmitBuffer();
+    m_triangleBuffer->unmapAndSubmitBuffer(bytesWritten);
 }
 } // namespace rive::pls
@@ -10,6 +10,7 @@
 #include "rive/math/simd.hpp"
 #include "rive/pls/pls_image.hpp"
 #include "shaders/constants.glsl"
+#include <algorithm>
 
 namespace rive::pls
 {
@@ -66,6 +67,7 @@ void PLSRenderer::ClipElement::reset(const Mat2D& matrix_, const PLSPath* path_,
     path = ref_rcp(path_);
     fillRule = fillRule_;
     clipID = 0; // This gets initialized lazily.
+    clipMaskFrameNumber = 0;
 }
 
 bool PLSRenderer::ClipElement::isEquivalent(const Mat2D& matrix_, const PLSPath* path_) const
@@ -84,12 +86,26 @@ void PLSRenderer::save()
     // reference.
     RenderState copy = m_stack.back();
     m_stack.push_back(copy);
+    if (m_automaticGroupsEnabled)
+    {
+        beginAutomaticGroupCandidate();
+    }
 }
 
 void PLSRenderer::restore()
 {
     assert(m_stack.size() > 1);
     assert(m_stack.back().clipStackHeight >= m_stack[m_stack.size() - 2].clipStackHeight);
+    if (!m_automaticGroupCandidates.empty() &&
+        m_automaticGroupCandidates.back().stackHeight == m_stack.size())
+    {
+        endAutomaticGroupCandidate();
+    }
+    if (m_isRecordingCacheableGroup && m_stack.size() == m_cacheableGroupStackHeight)
+    {
+        // The group is restoring past the state it began with, which may change the clip.
+        abandonCacheableGroup();
+    }
     m_stack.pop_back();
 }
 
@@ -102,7 +118,32 @@ void PLSRenderer::drawPath(RenderPath* renderPath, RenderPaint* renderPaint)
 {
     LITE_RTTI_CAST_OR_RETURN(path, PLSPath*, renderPath);
     LITE_RTTI_CAST_OR_RETURN(paint, PLSPaint*, renderPaint);
+    drawPathImpl(path, paint, -1);
+}
+
+void PLSRenderer::drawPath(RenderPath* renderPath, RenderPaint* renderPaint, float pixelSizeHint)
+{
+    LITE_RTTI_CAST_OR_RETURN(path, PLSPath*, renderPath);
+    LITE_RTTI_CAST_OR_RETURN(paint, PLSPaint*, renderPaint);
+    drawPathImpl(path, paint, std::max(pixelSizeHint, 0.f));
+}
+
+void PLSRenderer::drawPath(RenderPath* renderPath,
+                           RenderPaint* renderPaint,
+                           float pixelSizeHint,
+                           float tessellationQuality)
+{
+    LITE_RTTI_CAST_OR_RETURN(path, PLSPath*, renderPath);
+    LITE_RTTI_CAST_OR_RETURN(paint, PLSPaint*, renderPaint);
+    // Draw with a copy of the paint so the quality doesn't stick to the client's paint.
+    PLSPaint qualityPaint;
+    qualityPaint.copyFrom(*paint);
+    qualityPaint.tessellationQuality(tessellationQuality);
+    drawPathImpl(path, &qualityPaint, pixelSizeHint < 0 ? -1 : pixelSizeHint);
+}
 
+void PLSRenderer::drawPathImpl(PLSPath* path, PLSPaint* paint, float pixelSizeHint)
+{
     bool stroked = paint->getIsStroked();
 
     if (stroked && m_context->frameDescriptor().strokesDisabled)
@@ -119,6 +160,21 @@ void PLSRenderer::drawPath(RenderPath* renderPath, RenderPaint* renderPaint)
         return;
     }
 
+    if (!m_automaticGroupCandidates.empty())
+    {
+        fingerprintAutomaticGroupCandidates(path, paint);
+    }
+
+    if (m_isRecordingCacheableGroup && recordCacheableGroupDraw(path, paint))
+    {
+        return;
+    }
+
+    if (isBelowLODThreshold(path, paint, pixelSizeHint))
+    {
+        return;
+    }
+
     clipAndPushDraw(PLSPathDraw::Make(m_context,
                                       m_stack.back().matrix,
                                       ref_rcp(path),
@@ -127,10 +183,40 @@ void PLSRenderer::drawPath(RenderPath* renderPath, RenderPaint* renderPaint)
                                       &m_scratchPath));
 }
 
+bool PLSRenderer::isBelowLODThreshold(const PLSPath* path,
+                                      const PLSPaint* paint,
+                                      float pixelSizeHint) const
+{
+    float lodMinPixelSize = m_context->frameDescriptor().lodMinPixelSize;
+    if (!(lodMinPixelSize > 0))
+    {
+        return false;
+    }
+    if (pixelSizeHint < 0)
+    {
+        // No hint. Map the path's bounding box, which is much cheaper than any path processing.
+        const Mat2D& matrix = m_stack.back().matrix;
+        AABB bounds = matrix.mapBoundingBox(path->getBounds());
+        pixelSizeHint = std::max(bounds.width(), bounds.height());
+        if (paint->getIsStroked())
+        {
+            pixelSizeHint += paint->getThickness() * matrix.findMaxScale();
+        }
+    }
+    return pixelSizeHint < lodMinPixelSize;
+}
+
 void PLSRenderer::clipPath(RenderPath* renderPath)
 {
     LITE_RTTI_CAST_OR_RETURN(path, PLSPath*, renderPath);
 
+    if (m_isRecordingCacheableGroup)
+    {
+        // The offscreen texture can't capture clips that are internal to a group.
+        abandonCacheableGroup();
+    }
+    invalidateAutomaticGroupCandidates();
+
     // First try to handle axis-aligned rectangles using the "ENABLE_CLIP_RECT" shader feature.
     // Multiple axis-aligned rectangles can be intersected into a single rectangle if their matrices
     // are compatible.
@@ -247,6 +333,11 @@ void PLSRenderer::drawImage(const RenderImage* renderImage, BlendMode blendMode,
     {
         // Fall back on ImageRectDraw if the current frame doesn't support drawing paths with image
         // paints.
+        if (m_isRecordingCacheableGroup)
+        {
+            abandonCacheableGroup();
+        }
+        invalidateAutomaticGroupCandidates();
         const Mat2D& m = m_stack.back().matrix;
         auto plsImage = static_cast<const PLSImage*>(renderImage);
         clipAndPushDraw(PLSDrawUniquePtr(
@@ -255,23 +346,29 @@ void PLSRenderer::drawImage(const RenderImage* renderImage, BlendMode blendMode,
                                            m,
                                            blendMode,
                                            plsImage->refTexture(),
-                                           opacity)));
+                                           opacity,
+                                           plsImage->texCoordRect())));
     }
     else
     {
         // Implement drawImage() as drawPath() with a rectangular path and an image paint.
-        if (m_unitRectPath == nullptr)
-        {
-            m_unitRectPath = make_rcp<PLSPath>();
-            m_unitRectPath->line({1, 0});
-            m_unitRectPath->line({1, 1});
-            m_unitRectPath->line({0, 1});
-        }
-
         PLSPaint paint;
         paint.image(image->refTexture(), opacity);
         paint.blendMode(blendMode);
-        drawPath(m_unitRectPath.get(), &paint);
+        if (RenderPath* texCoordRectPath = image->texCoordRectPath())
+        {
+            // The image lives in an atlas. Image paints sample the texture at the path's local
+            // coordinates, so draw the image's subregion of the atlas (in normalized texture
+            // coordinates), transformed back onto [0, 0, 1, 1].
+            const AABB& texCoordRect = image->texCoordRect();
+            scale(1 / texCoordRect.width(), 1 / texCoordRect.height());
+            translate(-texCoordRect.left(), -texCoordRect.top());
+            drawPath(texCoordRectPath, &paint);
+        }
+        else
+        {
+            drawPath(unitRectPath(), &paint);
+        }
     }
 
     restore();
@@ -293,6 +390,12 @@ void PLSRenderer::drawImageMesh(const RenderImage* renderImage,
     assert(uvCoords_f32);
     assert(indices_u16);
 
+    if (m_isRecordingCacheableGroup)
+    {
+        abandonCacheableGroup();
+    }
+    invalidateAutomaticGroupCandidates();
+
     clipAndPushDraw(PLSDrawUniquePtr(m_context->make<ImageMeshDraw>(PLSDraw::kFullscreenPixelBounds,
                                                                     m_stack.back().matrix,
                                                                     blendMode,
@@ -301,7 +404,20 @@ void PLSRenderer::drawImageMesh(const RenderImage* renderImage,
                                                                     std::move(uvCoords_f32),
                                                                     std::move(indices_u16),
                                                                     indexCount,
-                                                                    opacity)));
+                                                                    opacity,
+                                                                    image->texCoordRect())));
+}
+
+PLSPath* PLSRenderer::unitRectPath()
+{
+    if (m_unitRectPath == nullptr)
+    {
+        m_unitRectPath = make_rcp<PLSPath>();
+        m_unitRectPath->line({1, 0});
+        m_unitRectPath->line({1, 1});
+        m_unitRectPath->line({0, 1});
+    }
+    return m_unitRectPath.get();
 }
 
 void PLSRenderer::clipAndPushDraw(PLSDrawUniquePtr draw)
@@ -311,6 +427,8 @@ void PLSRenderer::clipAndPushDraw(PLSDrawUniquePtr draw)
         return;
     }
 
+    updateClipMask();
+
     // Make two attempts to issue the draw: once on the context as-is and once with a clean flush.
     for (int i = 0; i < 2; ++i)
     {
@@ -411,16 +529,47 @@ bool PLSRenderer::applyClip(PLSDraw* draw)
         ClipElement& clip = m_clipStack[i];
         assert(clip.pathBounds == clip.path->getBounds());
 
+        if (lastClipID == 0 && findCachedClip(&clip))
+        {
+            // This clip's coverage is still in the clip buffer from earlier in the flush.
+            lastClipID = clip.clipID;
+            continue;
+        }
+
         IAABB clipDrawBounds;
         {
             PLSPaint clipUpdatePaint;
-            clipUpdatePaint.clipUpdate(/*clip THIS clipDraw against:*/ lastClipID);
-            auto clipDraw = PLSPathDraw::Make(m_context,
-                                              clip.matrix,
-                                              clip.path,
-                                              clip.fillRule,
-                                              &clipUpdatePaint,
-                                              &m_scratchPath);
+            PLSDrawUniquePtr clipDraw;
+            const ClipMask* clipMask = lastClipID == 0 ? findClipMask(clip) : nullptr;
+            if (clipMask != nullptr)
+            {
+                // Update the clip buffer from the retained mask with a single rect, mapping the
+                // unit rect onto the mask's pixel bounds (flipped if the texture is bottom-up).
+                float l = static_cast<float>(clipMask->pixelBounds.left);
+                float t = static_cast<float>(clipMask->pixelBounds.top);
+                float w = static_cast<float>(clipMask->pixelBounds.width());
+                float h = static_cast<float>(clipMask->pixelBounds.height());
+                Mat2D maskMatrix = clipMask->target.textureIsBottomUp
+                                       ? Mat2D(w, 0, 0, -h, l, t + h)
+                                       : Mat2D(w, 0, 0, h, l, t);
+                clipUpdatePaint.clipUpdate(0, clipMask->target.texture);
+                clipDraw = PLSPathDraw::Make(m_context,
+                                             maskMatrix,
+                                             ref_rcp(unitRectPath()),
+                                             FillRule::nonZero,
+                                             &clipUpdatePaint,
+                                             &m_scratchPath);
+            }
+            else
+            {
+                clipUpdatePaint.clipUpdate(/*clip THIS clipDraw against:*/ lastClipID);
+                clipDraw = PLSPathDraw::Make(m_context,
+                                             clip.matrix,
+                                             clip.path,
+                                             clip.fillRule,
+                                             &clipUpdatePaint,
+                                             &m_scratchPath);
+            }
             clipDrawBounds = clipDraw->pixelBounds();
             // Generate a new clipID every time we (re-)render an element to the clip buffer.
             // (Each embodiment of the element needs its own separate readBounds.)
@@ -437,6 +586,11 @@ bool PLSRenderer::applyClip(PLSDraw* draw)
             }
         }
 
+        if (lastClipID == 0)
+        {
+            cacheClip(clip);
+        }
+
         if (lastClipID != 0)
         {
             m_context->addClipReadBounds(lastClipID, clipDrawBounds);
@@ -464,4 +618,651 @@ bool PLSRenderer::applyClip(PLSDraw* draw)
     m_context->setClipContentID(lastClipID);
     return true;
 }
+
+bool PLSRenderer::findCachedClip(ClipElement* clip)
+{
+    if (!m_clipCacheEnabled ||
+        m_context->frameInterlockMode() != pls::InterlockMode::rasterOrdering)
+    {
+        return false;
+    }
+    if (m_cachedClipsLogicalFlushID != m_context->logicalFlushID())
+    {
+        // Clip IDs don't survive a logical flush.
+        m_cachedClips.clear();
+        m_cachedClipsLogicalFlushID = m_context->logicalFlushID();
+        return false;
+    }
+    for (const ClipElement& cachedClip : m_cachedClips)
+    {
+        if (cachedClip.isEquivalent(clip->matrix, clip->path.get()) &&
+            cachedClip.fillRule == clip->fillRule &&
+            m_context->isClipContentIntact(cachedClip.clipID))
+        {
+            clip->clipID = cachedClip.clipID;
+            return true;
+        }
+    }
+    return false;
+}
+
+void PLSRenderer::cacheClip(const ClipElement& clip)
+{
+    if (!m_clipCacheEnabled ||
+        m_context->frameInterlockMode() != pls::InterlockMode::rasterOrdering)
+    {
+        return;
+    }
+    if (m_cachedClipsLogicalFlushID != m_context->logicalFlushID())
+    {
+        m_cachedClips.clear();
+        m_cachedClipsLogicalFlushID = m_context->logicalFlushID();
+    }
+    // Drop any entries that this clip just made stale.
+    for (size_t i = 0; i < m_cachedClips.size();)
+    {
+        if (!m_context->isClipContentIntact(m_cachedClips[i].clipID))
+        {
+            m_cachedClips.erase(m_cachedClips.begin() + i);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+    if (m_cachedClips.size() == kMaxCachedClips)
+    {
+        m_cachedClips.erase(m_cachedClips.begin());
+    }
+    m_cachedClips.push_back(clip);
+}
+
+bool PLSRenderer::frameSupportsClipMasks() const
+{
+    return m_clipCacheEnabled && !m_clipMasksUnsupported &&
+           m_context->frameInterlockMode() != pls::InterlockMode::depthStencil &&
+           m_context->frameSupportsImagePaintForPaths();
+}
+
+void PLSRenderer::updateClipMask()
+{
+    if (m_stack.back().clipStackHeight == 0 || !frameSupportsClipMasks())
+    {
+        return;
+    }
+    ClipElement& clip = m_clipStack[0];
+    const uint64_t frameNumber = m_context->frameNumber();
+    if (clip.clipMaskFrameNumber == frameNumber)
+    {
+        return; // We already accounted for this clip element during the current frame.
+    }
+    clip.clipMaskFrameNumber = frameNumber;
+
+    if (m_clipMasksFrameNumber != frameNumber)
+    {
+        // Evict masks that haven't been used recently.
+        m_clipMasks.erase(std::remove_if(m_clipMasks.begin(),
+                                         m_clipMasks.end(),
+                                         [frameNumber](const ClipMask& mask) {
+                                             return mask.lastFrameNumber + kClipMaskMaxIdleFrames <
+                                                    frameNumber;
+                                         }),
+                          m_clipMasks.end());
+        m_clipMasksFrameNumber = frameNumber;
+    }
+
+    // Outset by a pixel for antialiasing and bilinear filtering.
+    const PLSRenderContext::FrameDescriptor& frameDesc = m_context->frameDescriptor();
+    IAABB renderTargetBounds = {0,
+                                0,
+                                static_cast<int32_t>(frameDesc.renderTargetWidth),
+                                static_cast<int32_t>(frameDesc.renderTargetHeight)};
+    IAABB pixelBounds = renderTargetBounds.intersect(
+        clip.matrix.mapBoundingBox(clip.pathBounds).inset(-1, -1).roundOut());
+    if (pixelBounds.empty())
+    {
+        return;
+    }
+
+    // A path mutation or matrix change makes the clip element inequivalent to its old mask, which
+    // then ages out.
+    auto mask = std::find_if(m_clipMasks.begin(),
+                             m_clipMasks.end(),
+                             [&clip, &pixelBounds](const ClipMask& candidate) {
+                                 return candidate.clip.isEquivalent(clip.matrix, clip.path.get()) &&
+                                        candidate.clip.fillRule == clip.fillRule &&
+                                        simd::all(simd::load4i(&candidate.pixelBounds) ==
+                                                  simd::load4i(&pixelBounds));
+                             });
+    if (mask == m_clipMasks.end())
+    {
+        if (m_clipMasks.size() == kMaxClipMasks)
+        {
+            // Evict the least recently used mask.
+            m_clipMasks.erase(std::min_element(m_clipMasks.begin(),
+                                               m_clipMasks.end(),
+                                               [](const ClipMask& a, const ClipMask& b) {
+                                                   return a.lastFrameNumber < b.lastFrameNumber;
+                                               }));
+        }
+        ClipMask newMask;
+        newMask.clip = clip;
+        newMask.pixelBounds = pixelBounds;
+        newMask.lastFrameNumber = frameNumber;
+        newMask.consecutiveFrameCount = 1;
+        m_clipMasks.push_back(std::move(newMask));
+        return;
+    }
+
+    if (mask->lastFrameNumber != frameNumber)
+    {
+        mask->consecutiveFrameCount =
+            mask->lastFrameNumber + 1 == frameNumber ? mask->consecutiveFrameCount + 1 : 1;
+        mask->lastFrameNumber = frameNumber;
+    }
+    if (mask->target.texture == nullptr &&
+        mask->consecutiveFrameCount >= kClipMaskStableFrameCount && !renderClipMask(&*mask))
+    {
+        mask->target = PLSRenderContext::OffscreenTarget();
+        mask->consecutiveFrameCount = 0;
+    }
+}
+
+bool PLSRenderer::renderClipMask(ClipMask* mask)
+{
+    const IAABB& pixelBounds = mask->pixelBounds;
+    if (pixelBounds.width() > kClipMaskMaxDimension || pixelBounds.height() > kClipMaskMaxDimension)
+    {
+        return false;
+    }
+    if (!m_context->makeOffscreenTarget(pixelBounds.width(), pixelBounds.height(), &mask->target))
+    {
+        m_clipMasksUnsupported = true;
+        return false;
+    }
+
+    m_context->beginOffscreenLogicalFlush(mask->target.renderTarget);
+    // Fill the clip path with opaque white, so the mask's alpha channel holds its coverage.
+    PLSPaint maskPaint;
+    maskPaint.color(0xffffffff);
+    PLSDrawUniquePtr maskDraw =
+        PLSPathDraw::Make(m_context,
+                          Mat2D::fromTranslate(-pixelBounds.left, -pixelBounds.top) *
+                              mask->clip.matrix,
+                          mask->clip.path,
+                          mask->clip.fillRule,
+                          &maskPaint,
+                          &m_scratchPath);
+    bool success = m_context->isOutsideCurrentFrame(maskDraw->pixelBounds()) ||
+                   m_context->pushDrawBatch(&maskDraw, 1);
+    m_context->endOffscreenLogicalFlush(); // Resume drawing to the main render target.
+    return success;
+}
+
+const PLSRenderer::ClipMask* PLSRenderer::findClipMask(const ClipElement& clip) const
+{
+    if (!frameSupportsClipMasks())
+    {
+        return nullptr;
+    }
+    const uint64_t frameNumber = m_context->frameNumber();
+    for (const ClipMask& mask : m_clipMasks)
+    {
+        // updateClipMask() has already checked this frame's pixel bounds for masks it touched.
+        if (mask.target.texture != nullptr && mask.lastFrameNumber == frameNumber &&
+            mask.clip.isEquivalent(clip.matrix, clip.path.get()) &&
+            mask.clip.fillRule == clip.fillRule)
+        {
+            return &mask;
+        }
+    }
+    return nullptr;
+}
+
+// Folds a matrix into a fingerprint, quantized so that floating point noise (e.g., from inverting
+// a translating group matrix every frame) doesn't change the fingerprint.
+static uint64_t hash_matrix_quantized(uint64_t hash, const Mat2D& m)
+{
+    for (float value : {m.xx(), m.xy(), m.yx(), m.yy(), m.tx(), m.ty()})
+    {
+        // "+ 0" turns -0 into +0.
+        hash = pls::HashValue(hash, roundf(value * 4096) + 0.f);
+    }
+    return hash;
+}
+
+static uint64_t hash_paint(uint64_t hash, const PLSPaint* paint)
+{
+    hash = pls::HashValue(hash, paint->getType());
+    hash = pls::HashValue(hash, paint->getBlendMode());
+    hash = pls::HashValue(hash, paint->getIsStroked());
+    hash = pls::HashValue(hash, paint->getTessellationQuality());
+    if (paint->getIsStroked())
+    {
+        hash = pls::HashValue(hash, paint->getThickness());
+        hash = pls::HashValue(hash, paint->getJoin());
+        hash = pls::HashValue(hash, paint->getCap());
+    }
+    switch (paint->getType())
+    {
+        case pls::PaintType::solidColor:
+            hash = pls::HashValue(hash, paint->getColor());
+            break;
+        case pls::PaintType::linearGradient:
+        case pls::PaintType::radialGradient:
+            hash = paint->getGradient()->hashContents(hash);
+            break;
+        case pls::PaintType::image:
+            hash = pls::HashValue(hash, paint->getImageTexture()->textureResourceHash());
+            hash = pls::HashValue(hash, paint->getImageOpacity());
+            break;
+        case pls::PaintType::clipUpdate:
+            RIVE_UNREACHABLE();
+    }
+    return hash;
+}
+
+// Returns true if 'b' only differs from 'a' by a translation (within tolerance).
+static bool differs_only_by_translation(const Mat2D& a, const Mat2D& b, float tolerance)
+{
+    Mat2D aInverse;
+    if (!a.invert(&aInverse))
+    {
+        return false;
+    }
+    Mat2D r = b * aInverse;
+    return fabsf(r.xx() - 1) <= tolerance && fabsf(r.yy() - 1) <= tolerance &&
+           fabsf(r.xy()) <= tolerance && fabsf(r.yx()) <= tolerance;
+}
+
+void PLSRenderer::beginAutomaticGroupCandidate()
+{
+    const uint64_t frameNumber = m_context->frameNumber();
+    if (m_automaticGroupFrameNumber != frameNumber)
+    {
+        // Forget blocks that haven't been drawn recently.
+        for (auto iter = m_automaticGroupHistory.begin(); iter != m_automaticGroupHistory.end();)
+        {
+            if (iter->second.lastFrameNumber + kAutomaticGroupMaxIdleFrames < frameNumber)
+            {
+                iter = m_automaticGroupHistory.erase(iter);
+            }
+            else
+            {
+                ++iter;
+            }
+        }
+        m_automaticGroupFrameNumber = frameNumber;
+        m_automaticGroupRootChildCount = 0;
+    }
+
+    // Key the block by its parent's key and its index among its siblings.
+    AutomaticGroupCandidate candidate;
+    if (m_automaticGroupCandidates.empty())
+    {
+        candidate.key = pls::HashValue(pls::kFNVOffsetBasis, m_automaticGroupRootChildCount++);
+    }
+    else
+    {
+        AutomaticGroupCandidate& parent = m_automaticGroupCandidates.back();
+        candidate.key = pls::HashValue(parent.key, parent.childCount++);
+    }
+    candidate.stackHeight = m_stack.size();
+    candidate.matrix = m_stack.back().matrix;
+    candidate.isCacheable = candidate.matrix.invert(&candidate.inverseMatrix);
+
+    auto history = m_automaticGroupHistory.find(candidate.key);
+    if (candidate.isCacheable && history != m_automaticGroupHistory.end() &&
+        history->second.consecutiveFrameCount >= kAutomaticGroupStableFrameCount)
+    {
+        // This block has been drawing the same thing. Record it so the raster cache can take over.
+        beginCacheableGroup();
+        candidate.isRecording = true;
+    }
+    m_automaticGroupCandidates.push_back(candidate);
+}
+
+void PLSRenderer::endAutomaticGroupCandidate()
+{
+    const AutomaticGroupCandidate& candidate = m_automaticGroupCandidates.back();
+    if (candidate.isRecording)
+    {
+        endCacheableGroup();
+    }
+    if (candidate.isCacheable && candidate.drawCount >= 2)
+    {
+        const uint64_t frameNumber = m_context->frameNumber();
+        auto [iter, isNew] = m_automaticGroupHistory.try_emplace(candidate.key);
+        AutomaticGroupHistory& history = iter->second;
+        bool isStable = !isNew && history.fingerprint == candidate.fingerprint &&
+                        history.lastFrameNumber + 1 == frameNumber &&
+                        differs_only_by_translation(history.matrix,
+                                                    candidate.matrix,
+                                                    kRasterCacheScaleTolerance);
+        history.consecutiveFrameCount = isStable ? history.consecutiveFrameCount + 1 : 1;
+        history.fingerprint = candidate.fingerprint;
+        history.matrix = candidate.matrix;
+        history.lastFrameNumber = frameNumber;
+    }
+    else
+    {
+        // The block can't be cached, or it's a single draw (no cheaper to draw as an image).
+        m_automaticGroupHistory.erase(candidate.key);
+    }
+    m_automaticGroupCandidates.pop_back();
+}
+
+void PLSRenderer::fingerprintAutomaticGroupCandidates(const PLSPath* path, const PLSPaint* paint)
+{
+    if (paint->getBlendMode() != BlendMode::srcOver)
+    {
+        invalidateAutomaticGroupCandidates();
+        return;
+    }
+    uint64_t drawHash = pls::HashValue(pls::kFNVOffsetBasis, path->getRawPathMutationID());
+    drawHash = pls::HashValue(drawHash, path->getFillRule());
+    drawHash = hash_paint(drawHash, paint);
+    const Mat2D& matrix = m_stack.back().matrix;
+    for (AutomaticGroupCandidate& candidate : m_automaticGroupCandidates)
+    {
+        if (!candidate.isCacheable)
+        {
+            continue;
+        }
+        // Relative to the block's matrix, like recordCacheableGroupDraw().
+        uint64_t hash = pls::HashValue(candidate.fingerprint, drawHash);
+        candidate.fingerprint = hash_matrix_quantized(hash, candidate.inverseMatrix * matrix);
+        ++candidate.drawCount;
+    }
+}
+
+void PLSRenderer::invalidateAutomaticGroupCandidates()
+{
+    for (AutomaticGroupCandidate& candidate : m_automaticGroupCandidates)
+    {
+        candidate.isCacheable = false;
+    }
+}
+
+void PLSRenderer::beginCacheableGroup()
+{
+    if (m_cacheableGroupDepth++ != 0 || m_rasterCacheUnsupported)
+    {
+        return; // Only the outermost group gets cached.
+    }
+    const Mat2D& matrix = m_stack.back().matrix;
+    if (!matrix.invert(&m_cacheableGroupInverseMatrix))
+    {
+        return;
+    }
+    assert(m_cacheableGroupDraws.empty());
+    m_isRecordingCacheableGroup = true;
+    m_cacheableGroupStackHeight = m_stack.size();
+    m_cacheableGroupMatrix = matrix;
+    m_cacheableGroupFingerprint = pls::kFNVOffsetBasis;
+    m_cacheableGroupBounds = {std::numeric_limits<float>::infinity(),
+                              std::numeric_limits<float>::infinity(),
+                              -std::numeric_limits<float>::infinity(),
+                              -std::numeric_limits<float>::infinity()};
+}
+
+bool PLSRenderer::recordCacheableGroupDraw(const PLSPath* path, const PLSPaint* paint)
+{
+    assert(m_isRecordingCacheableGroup);
+    if (paint->getBlendMode() != BlendMode::srcOver)
+    {
+        // Other blend modes depend on the content underneath the group, which isn't available
+        // offscreen.
+        abandonCacheableGroup();
+        return false;
+    }
+
+    const Mat2D& matrix = m_stack.back().matrix;
+    size_t drawIdx = m_cacheableGroupDraws.size();
+    if (drawIdx == m_cacheableGroupPaints.size())
+    {
+        m_cacheableGroupPaints.push_back(make_rcp<PLSPaint>());
+    }
+    m_cacheableGroupPaints[drawIdx]->copyFrom(*paint);
+    m_cacheableGroupDraws.push_back(
+        {ref_rcp(path), path->getFillRule(), matrix, m_cacheableGroupPaints[drawIdx]});
+
+    // Fingerprint the draw relative to the group matrix, so the fingerprint survives translations
+    // of the entire group.
+    uint64_t hash = m_cacheableGroupFingerprint;
+    hash = pls::HashValue(hash, path->getRawPathMutationID());
+    hash = pls::HashValue(hash, path->getFillRule());
+    hash = hash_matrix_quantized(hash, m_cacheableGroupInverseMatrix * matrix);
+    hash = hash_paint(hash, paint);
+    m_cacheableGroupFingerprint = hash;
+
+    AABB bounds = matrix.mapBoundingBox(path->getBounds());
+    if (paint->getIsStroked())
+    {
+        // Same conservative stroke outset as PLSPathDraw::Make().
+        float strokeOutset = paint->getThickness() * .5f;
+        if (paint->getJoin() == StrokeJoin::miter)
+        {
+            strokeOutset *= 4;
+        }
+        else if (paint->getCap() == StrokeCap::square)
+        {
+            strokeOutset *= math::SQRT2;
+        }
+        AABB strokePixelOutset = matrix.mapBoundingBox({0, 0, strokeOutset, strokeOutset});
+        bounds = bounds.inset(-strokePixelOutset.width(), -strokePixelOutset.height());
+    }
+    float4 a = simd::load4f(&m_cacheableGroupBounds);
+    float4 b = simd::load4f(&bounds);
+    simd::store(&m_cacheableGroupBounds, simd::join(simd::min(a.xy, b.xy), simd::max(a.zw, b.zw)));
+    return true;
+}
+
+void PLSRenderer::abandonCacheableGroup()
+{
+    assert(m_isRecordingCacheableGroup);
+    m_isRecordingCacheableGroup = false;
+    drawCacheableGroupDirectly();
+}
+
+void PLSRenderer::drawCacheableGroupDirectly()
+{
+    for (const CacheableGroupDraw& draw : m_cacheableGroupDraws)
+    {
+        clipAndPushDraw(PLSPathDraw::Make(m_context,
+                                          draw.matrix,
+                                          draw.path,
+                                          draw.fillRule,
+                                          draw.paint.get(),
+                                          &m_scratchPath));
+    }
+    for (const CacheableGroupDraw& draw : m_cacheableGroupDraws)
+    {
+        draw.paint->shader(nullptr); // Release the snapshot's refs.
+    }
+    m_cacheableGroupDraws.clear();
+}
+
+void PLSRenderer::endCacheableGroup()
+{
+    assert(m_cacheableGroupDepth > 0);
+    if (--m_cacheableGroupDepth != 0 || !m_isRecordingCacheableGroup)
+    {
+        return;
+    }
+    m_isRecordingCacheableGroup = false;
+
+    const uint64_t frameNumber = m_context->frameNumber();
+    if (m_rasterCacheFrameNumber != frameNumber)
+    {
+        // Evict entries that haven't been drawn recently.
+        m_rasterCache.erase(std::remove_if(m_rasterCache.begin(),
+                                           m_rasterCache.end(),
+                                           [frameNumber](const RasterCacheEntry& entry) {
+                                               return entry.lastFrameNumber +
+                                                          kRasterCacheMaxIdleFrames <
+                                                      frameNumber;
+                                           }),
+                            m_rasterCache.end());
+        m_rasterCacheFrameNumber = frameNumber;
+    }
+
+    if (m_cacheableGroupDraws.size() < 2)
+    {
+        // A single draw is no cheaper to draw as an image.
+        drawCacheableGroupDirectly();
+        return;
+    }
+
+    auto entry = std::find_if(m_rasterCache.begin(),
+                              m_rasterCache.end(),
+                              [this](const RasterCacheEntry& entry) {
+                                  return entry.fingerprint == m_cacheableGroupFingerprint;
+                              });
+    if (entry == m_rasterCache.end())
+    {
+        if (m_rasterCache.size() == kRasterCacheMaxEntries)
+        {
+            // Evict the least recently drawn entry.
+            m_rasterCache.erase(std::min_element(
+                m_rasterCache.begin(),
+                m_rasterCache.end(),
+                [](const RasterCacheEntry& a, const RasterCacheEntry& b) {
+                    return a.lastFrameNumber < b.lastFrameNumber;
+                }));
+        }
+        RasterCacheEntry newEntry;
+        newEntry.fingerprint = m_cacheableGroupFingerprint;
+        newEntry.lastFrameNumber = frameNumber;
+        newEntry.consecutiveFrameCount = 1;
+        newEntry.lastGroupMatrix = m_cacheableGroupMatrix;
+        m_rasterCache.push_back(std::move(newEntry));
+        drawCacheableGroupDirectly();
+        return;
+    }
+
+    if (entry->lastFrameNumber != frameNumber)
+    {
+        bool isStable = entry->lastFrameNumber + 1 == frameNumber &&
+                        differs_only_by_translation(entry->lastGroupMatrix,
+                                                    m_cacheableGroupMatrix,
+                                                    kRasterCacheScaleTolerance);
+        entry->consecutiveFrameCount = isStable ? entry->consecutiveFrameCount + 1 : 1;
+        entry->lastFrameNumber = frameNumber;
+    }
+    entry->lastGroupMatrix = m_cacheableGroupMatrix;
+
+    if (entry->target.texture != nullptr &&
+        !differs_only_by_translation(entry->groupMatrix,
+                                     m_cacheableGroupMatrix,
+                                     kRasterCacheScaleTolerance))
+    {
+        // The group has scaled, rotated, or skewed since it was rendered. Wait for it to stabilize
+        // again before re-rendering.
+        entry->target = PLSRenderContext::OffscreenTarget();
+    }
+    if (entry->target.texture == nullptr &&
+        entry->consecutiveFrameCount >= kRasterCacheStableFrameCount &&
+        !renderRasterCacheEntry(&*entry))
+    {
+        entry->target = PLSRenderContext::OffscreenTarget();
+        entry->consecutiveFrameCount = 0;
+    }
+
+    if (entry->target.texture != nullptr)
+    {
+        drawRasterCacheEntry(*entry);
+        for (const CacheableGroupDraw& draw : m_cacheableGroupDraws)
+        {
+            draw.paint->shader(nullptr); // Release the snapshot's refs.
+        }
+        m_cacheableGroupDraws.clear();
+    }
+    else
+    {
+        drawCacheableGroupDirectly();
+    }
+}
+
+bool PLSRenderer::renderRasterCacheEntry(RasterCacheEntry* entry)
+{
+    // Outset by a pixel for antialiasing and bilinear filtering.
+    IAABB pixelBounds = m_cacheableGroupBounds.inset(-1, -1).roundOut();
+    if (pixelBounds.empty() || pixelBounds.width() > kRasterCacheMaxDimension ||
+        pixelBounds.height() > kRasterCacheMaxDimension)
+    {
+        return false;
+    }
+    if (!m_context->makeOffscreenTarget(pixelBounds.width(), pixelBounds.height(), &entry->target))
+    {
+        m_rasterCacheUnsupported = true;
+        return false;
+    }
+    entry->groupMatrix = m_cacheableGroupMatrix;
+    entry->groupInverseMatrix = m_cacheableGroupInverseMatrix;
+    entry->pixelBounds = pixelBounds;
+
+    m_context->beginOffscreenLogicalFlush(entry->target.renderTarget);
+    Mat2D offset = Mat2D::fromTranslate(-pixelBounds.left, -pixelBounds.top);
+    bool success = true;
+    for (const CacheableGroupDraw& draw : m_cacheableGroupDraws)
+    {
+        // Offscreen draws are unclipped. (Clips get applied when the texture is drawn.)
+        PLSDrawUniquePtr plsDraw = PLSPathDraw::Make(m_context,
+                                                     offset * draw.matrix,
+                                                     draw.path,
+                                                     draw.fillRule,
+                                                     draw.paint.get(),
+                                                     &m_scratchPath);
+        if (m_context->isOutsideCurrentFrame(plsDraw->pixelBounds()))
+        {
+            continue;
+        }
+        if (!m_context->pushDrawBatch(&plsDraw, 1))
+        {
+            // The group doesn't fit in a single flush. Draw it directly instead.
+            success = false;
+            break;
+        }
+    }
+    m_context->endOffscreenLogicalFlush(); // Resume drawing to the main render target.
+    return success;
+}
+
+void PLSRenderer::drawRasterCacheEntry(const RasterCacheEntry& entry)
+{
+    assert(entry.target.texture != nullptr);
+
+    // Map the unit rect onto the entry's pixel bounds, flipping vertically if the texture is
+    // bottom-up. Then apply any translation the group has undergone since it was rendered.
+    float l = static_cast<float>(entry.pixelBounds.left);
+    float t = static_cast<float>(entry.pixelBounds.top);
+    float w = static_cast<float>(entry.pixelBounds.width());
+    float h = static_cast<float>(entry.pixelBounds.height());
+    Mat2D imageMatrix = entry.target.textureIsBottomUp ? Mat2D(w, 0, 0, -h, l, t + h)
+                                                       : Mat2D(w, 0, 0, h, l, t);
+
+    save();
+    m_stack.back().matrix = m_cacheableGroupMatrix * entry.groupInverseMatrix * imageMatrix;
+    // The target's texture reports hasPremultipliedAlpha(), so the image shaders unmultiply it.
+    assert(entry.target.texture->hasPremultipliedAlpha());
+    if (!m_context->frameSupportsImagePaintForPaths())
+    {
+        const Mat2D& m = m_stack.back().matrix;
+        clipAndPushDraw(PLSDrawUniquePtr(
+            m_context->make<ImageRectDraw>(m_context,
+                                           m.mapBoundingBox(AABB{0, 0, 1, 1}).roundOut(),
+                                           m,
+                                           BlendMode::srcOver,
+                                           entry.target.texture,
+                                           1.f)));
+    }
+    else
+    {
+        PLSPaint paint;
+        paint.image(entry.target.texture, 1.f);
+        drawPath(unitRectPath(), &paint);
+    }
+    restore();
+}
 } // namespace rive::pls
@@ -0,0 +1,193 @@
+/*
+ * Copyright 2024 Rive
+ */
+
+#include "rive/pls/resource_allocation_policy.hpp"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+
+namespace rive::pls
+{
+ResourceAllocationCounts::VecType ResourceAllocationCounts::UnitSizesInBytes(
+    const PlatformFeatures& platformFeatures)
+{
+    ResourceAllocationCounts unitSizes;
+    unitSizes.flushUniformBufferCount = sizeof(FlushUniforms) * kBufferRingSize;
+    unitSizes.imageDrawUniformBufferCount = sizeof(ImageDrawUniforms) * kBufferRingSize;
+    unitSizes.pathBufferCount = sizeof(PathData) * kBufferRingSize;
+    unitSizes.paintBufferCount = sizeof(PaintData) * kBufferRingSize;
+    unitSizes.paintAuxBufferCount = sizeof(PaintAuxData) * kBufferRingSize;
+    unitSizes.contourBufferCount = sizeof(ContourData) * kBufferRingSize;
+    unitSizes.simpleGradientBufferCount = sizeof(TwoTexelRamp) * kBufferRingSize;
+    unitSizes.complexGradSpanBufferCount = sizeof(GradientSpan) * kBufferRingSize;
+    unitSizes.tessSpanBufferCount = TessVertexSpanSizeInBytes(platformFeatures) * kBufferRingSize;
+    unitSizes.triangleVertexBufferCount = sizeof(TriangleVertex) * kBufferRingSize;
+    unitSizes.gradTextureHeight = kGradTextureWidth * 4;     // RGBA8
+    unitSizes.tessTextureHeight = kTessTextureWidth * 4 * 4; // RGBA32UI
+    return unitSizes.toVec();
+}
+
+size_t ResourceAllocationCounts::totalSizeInBytes(const PlatformFeatures& platformFeatures) const
+{
+    return simd::reduce_add(toVec() * UnitSizesInBytes(platformFeatures));
+}
+
+constexpr static char kResourceCountsHeader[] = "rive_pls_resource_counts 1";
+
+// In the same order as the fields of ResourceAllocationCounts.
+constexpr static const char* kResourceCountNames[ResourceAllocationCounts::kCount] = {
+    "flushUniformBufferCount",
+    "imageDrawUniformBufferCount",
+    "pathBufferCount",
+    "paintBufferCount",
+    "paintAuxBufferCount",
+    "contourBufferCount",
+    "simpleGradientBufferCount",
+    "complexGradSpanBufferCount",
+    "tessSpanBufferCount",
+    "triangleVertexBufferCount",
+    "gradTextureHeight",
+    "tessTextureHeight",
+};
+
+std::string WriteResourceAllocationCounts(const ResourceAllocationCounts& counts)
+{
+    std::string text = kResourceCountsHeader;
+    text.push_back('\n');
+    ResourceAllocationCounts::VecType countsVec = counts.toVec();
+    for (size_t i = 0; i < ResourceAllocationCounts::kCount; ++i)
+    {
+        char line[64];
+        snprintf(line,
+                 sizeof(line),
+                 "%s %llu\n",
+                 kResourceCountNames[i],
+                 static_cast<unsigned long long>(countsVec[i]));
+        text.append(line);
+    }
+    return text;
+}
+
+bool ParseResourceAllocationCounts(const char* text, ResourceAllocationCounts* counts)
+{
+    size_t headerLength = strlen(kResourceCountsHeader);
+    if (strncmp(text, kResourceCountsHeader, headerLength) != 0)
+    {
+        return false;
+    }
+    ResourceAllocationCounts::VecType countsVec = ResourceAllocationCounts().toVec();
+    const char* cursor = text + headerLength;
+    for (;;)
+    {
+        while (isspace(*cursor))
+        {
+            ++cursor;
+        }
+        if (*cursor == '\0')
+        {
+            *counts = countsVec;
+            return true;
+        }
+        char name[64];
+        unsigned long long value;
+        int charsRead = 0;
+        if (sscanf(cursor, "%63s %llu%n", name, &value, &charsRead) != 2)
+        {
+            return false;
+        }
+        size_t i = 0;
+        while (i < ResourceAllocationCounts::kCount && strcmp(name, kResourceCountNames[i]) != 0)
+        {
+            ++i;
+        }
+        if (i == ResourceAllocationCounts::kCount)
+        {
+            return false;
+        }
+        countsVec[i] = value;
+        cursor += charsRead;
+    }
+}
+
+static ResourceAllocationCounts::VecType scale(const ResourceAllocationCounts::VecType& counts,
+                                               double factor)
+{
+    return simd::cast<size_t>(simd::cast<double>(counts) * factor);
+}
+
+ResourceAllocationCounts DefaultResourceAllocationPolicy::computeAllocations(
+    const ResourceAllocationCounts& required,
+    const ResourceAllocationCounts& current,
+    const PlatformFeatures& platformFeatures,
+    double secondsNow)
+{
+    // Track m_maxRecentResourceRequirements so we can trim GPU allocations when steady-state usage
+    // goes down.
+    m_maxRecentResourceRequirements =
+        simd::max(required.toVec(), m_maxRecentResourceRequirements.toVec());
+
+    // Grow resources enough to handle this flush.
+    // If "required" already fits in our current allocations, then don't change them.
+    // If it doesn't fit, overallocate in order to create some slack for growth.
+    ResourceAllocationCounts::VecType allocs =
+        simd::if_then_else(required.toVec() <= current.toVec(),
+                           current.toVec(),
+                           scale(required.toVec(), m_options.growthFactor));
+
+    // Additionally, trim resources down to the most recent steady-state usage at regular intervals.
+    if (secondsNow - m_lastResourceTrimTimeInSeconds >= m_options.trimIntervalInSeconds)
+    {
+        if (!m_options.neverShrink)
+        {
+            // Trim GPU resource allocations to 'growthFactor' of their maximum recent usage, and
+            // only if the recent usage is at or below 'trimUtilizationThreshold'.
+            ResourceAllocationCounts::VecType recent = m_maxRecentResourceRequirements.toVec();
+            allocs = simd::if_then_else(recent <= scale(allocs, m_options.trimUtilizationThreshold),
+                                        scale(recent, m_options.growthFactor),
+                                        allocs);
+        }
+
+        // Zero out m_maxRecentResourceRequirements for the next interval.
+        m_maxRecentResourceRequirements = ResourceAllocationCounts();
+        m_lastResourceTrimTimeInSeconds = secondsNow;
+    }
+
+    allocs = simd::max(allocs, m_options.minimumAllocations.toVec());
+    allocs = simd::max(allocs, m_reservedCounts.toVec());
+
+    if (m_options.memoryBudgetInBytes != 0)
+    {
+        // Scale back the slack above this frame's requirements until we fit in the budget.
+        size_t allocatedBytes =
+            ResourceAllocationCounts(allocs).totalSizeInBytes(platformFeatures);
+        size_t requiredBytes = required.totalSizeInBytes(platformFeatures);
+        if (allocatedBytes > m_options.memoryBudgetInBytes)
+        {
+            ResourceAllocationCounts::VecType slack = allocs - required.toVec();
+            double slackFraction =
+                requiredBytes < m_options.memoryBudgetInBytes
+                    ? static_cast<double>(m_options.memoryBudgetInBytes - requiredBytes) /
+                          static_cast<double>(allocatedBytes - requiredBytes)
+                    : 0;
+            allocs = required.toVec() + scale(slack, slackFraction);
+        }
+    }
+
+    assert(simd::all(allocs >= required.toVec()));
+    return allocs;
+}
+
+void DefaultResourceAllocationPolicy::reserve(const ResourceAllocationCounts& counts)
+{
+    m_reservedCounts = simd::max(m_reservedCounts.toVec(), counts.toVec());
+}
+
+void DefaultResourceAllocationPolicy::reset(double secondsNow)
+{
+    m_reservedCounts = ResourceAllocationCounts();
+    m_maxRecentResourceRequirements = ResourceAllocationCounts();
+    m_lastResourceTrimTimeInSeconds = secondsNow;
+}
+} // namespace rive::pls
@@ -54,11 +54,21 @@ VERTEX_MAIN(@drawVertexMain, Attrs, attrs, _vertexID, _instanceID)
 #ifdef @VERTEX
 ATTR_BLOCK_BEGIN(Attrs)
 ATTR(0, packed_float3, @a_triangleVertex);
+#ifdef @DRAW_ANALYTIC_SHAPES
+ATTR(1, float4, @a_analyticShapeRadii); // [outerRadii, innerRadii]
+ATTR(2, float2, @a_analyticShapeInnerHalfSize);
+#endif
 ATTR_BLOCK_END
 #endif
 
 VARYING_BLOCK_BEGIN
+#ifdef @DRAW_ANALYTIC_SHAPES
+NO_PERSPECTIVE VARYING(0, float2, v_shapeCoord);
+@OPTIONALLY_FLAT VARYING(2, float4, v_shapeRadii);
+@OPTIONALLY_FLAT VARYING(3, float2, v_shapeInnerHalfSize);
+#else
 @OPTIONALLY_FLAT VARYING(0, half, v_windingWeight);
+#endif
 @OPTIONALLY_FLAT VARYING(1, ushort, v_pathID);
 VARYING_BLOCK_END
 
@@ -66,16 +76,38 @@ VARYING_BLOCK_END
 VERTEX_MAIN(@drawVertexMain, Attrs, attrs, _vertexID, _instanceID)
 {
     ATTR_UNPACK(_vertexID, attrs, @a_triangleVertex, float3);
+#ifdef @DRAW_ANALYTIC_SHAPES
+    ATTR_UNPACK(_vertexID, attrs, @a_analyticShapeRadii, float4);
+    ATTR_UNPACK(_vertexID, attrs, @a_analyticShapeInnerHalfSize, float2);
 
+    VARYING_INIT(v_shapeCoord, float2);
+    VARYING_INIT(v_shapeRadii, float4);
+    VARYING_INIT(v_shapeInnerHalfSize, float2);
+#else
     VARYING_INIT(v_windingWeight, half);
+#endif
     VARYING_INIT(v_pathID, ushort);
 
+#ifdef @DRAW_ANALYTIC_SHAPES
+    float2 vertexPosition = unpack_analytic_shape_vertex(@a_triangleVertex,
+                                                         v_pathID,
+                                                         v_shapeCoord VERTEX_CONTEXT_UNPACK);
+    v_shapeRadii = @a_analyticShapeRadii;
+    v_shapeInnerHalfSize = @a_analyticShapeInnerHalfSize;
+#else
     float2 vertexPosition = unpack_interior_triangle_vertex(@a_triangleVertex,
                                                             v_pathID,
                                                             v_windingWeight VERTEX_CONTEXT_UNPACK);
+#endif
     float4 pos = RENDER_TARGET_COORD_TO_CLIP_COORD(vertexPosition);
 
+#ifdef @DRAW_ANALYTIC_SHAPES
+    VARYING_PACK(v_shapeCoord);
+    VARYING_PACK(v_shapeRadii);
+    VARYING_PACK(v_shapeInnerHalfSize);
+#else
     VARYING_PACK(v_windingWeight);
+#endif
     VARYING_PACK(v_pathID);
     EMIT_VERTEX(pos);
 }
@@ -147,7 +179,8 @@ IMAGE_RECT_VERTEX_MAIN(@drawVertexMain, Attrs, attrs, _vertexID, _instanceID)
         }
     }
 
-    v_texCoord = vertexPosition;
+    v_texCoord = vertexPosition * imageDrawUniforms.texCoordTransform.xy +
+                 imageDrawUniforms.texCoordTransform.zw;
     vertexPosition = MUL(M, vertexPosition) + imageDrawUniforms.translate;
 
     if (isOuterVertex)
@@ -207,7 +240,8 @@ IMAGE_MESH_VERTEX_MAIN(@drawVertexMain, PositionAttr, position, UVAttr, uv, _ver
 
     float2x2 M = make_float2x2(imageDrawUniforms.viewMatrix);
     float2 vertexPosition = MUL(M, @a_position) + imageDrawUniforms.translate;
-    v_texCoord = @a_texCoord;
+    v_texCoord = @a_texCoord * imageDrawUniforms.texCoordTransform.xy +
+                 imageDrawUniforms.texCoordTransform.zw;
 
 #ifdef @ENABLE_CLIP_RECT
     v_clipRect =
@@ -353,7 +387,9 @@ half4 resolve_path_color(half coverageCount,
                                             M[0],
                                             M[1]);
                 float opacity = uintBitsToFloat(paintData.y);
-                color.a *= opacity;
+                color = apply_image_opacity(color,
+                                            opacity,
+                                            (paintData.x & PAINT_FLAG_PREMULTIPLIED_IMAGE) != 0u);
             }
             else
 #endif // ENABLE_BINDLESS_TEXTURES
@@ -369,6 +405,21 @@ half4 resolve_path_color(half coverageCount,
         }
 #ifdef @ENABLE_CLIPPING
         case CLIP_UPDATE_PAINT_TYPE:
+#ifdef @ENABLE_BINDLESS_TEXTURES
+            if ((paintData.x & PAINT_FLAG_CLIP_MASK) != 0u)
+            {
+                // Copy coverage from a retained clip mask. The mask maps 1:1 onto pixels and only
+                // has one mip level, so sample it without derivatives.
+                float2x2 M = make_float2x2(STORAGE_BUFFER_LOAD4(@paintAuxBuffer, pathID * 4u));
+                float4 translate = STORAGE_BUFFER_LOAD4(@paintAuxBuffer, pathID * 4u + 1u);
+                float2 maskCoord = MUL(M, _fragCoord) + translate.xy;
+                coverage *= make_half(TEXTURE_SAMPLE_LOD(sampler2D(floatBitsToUint(translate.zw)),
+                                                         imageSampler,
+                                                         maskCoord,
+                                                         .0)
+                                          .a);
+            }
+#endif // ENABLE_BINDLESS_TEXTURES
             PLS_STOREUI(clipBuffer, paintData.y | packHalf2x16(make_half2(coverage, 0)));
             break;
 #endif // ENABLE_CLIPPING
@@ -503,7 +554,13 @@ ATOMIC_PLS_MAIN(@drawFragmentMain)
 #ifdef @DRAW_INTERIOR_TRIANGLES
 ATOMIC_PLS_MAIN(@drawFragmentMain)
 {
+#ifdef @DRAW_ANALYTIC_SHAPES
+    VARYING_UNPACK(v_shapeCoord, float2);
+    VARYING_UNPACK(v_shapeRadii, float4);
+    VARYING_UNPACK(v_shapeInnerHalfSize, float2);
+#else
     VARYING_UNPACK(v_windingWeight, half);
+#endif
     VARYING_UNPACK(v_pathID, ushort);
 
     PLS_PRESERVE_VALUE(clipBuffer);
@@ -514,7 +571,15 @@ ATOMIC_PLS_MAIN(@drawFragmentMain)
     _fragColor = make_half4(0, 0, 0, 0);
 #endif
 
+#ifdef @DRAW_ANALYTIC_SHAPES
+    half coverage = analytic_shape_coverage(v_shapeCoord,
+                                            v_shapeRadii,
+                                            v_shapeInnerHalfSize,
+                                            dFdx(v_shapeCoord),
+                                            dFdy(v_shapeCoord));
+#else
     half coverage = v_windingWeight;
+#endif
 
     uint lastCoverageData = PLS_LOADUI_ATOMIC(coverageCountBuffer);
     ushort lastPathID = make_ushort(lastCoverageData >> 16);
@@ -602,7 +667,11 @@ ATOMIC_PLS_MAIN_WITH_IMAGE_UNIFORMS(@drawFragmentMain)
         meshCoverage = min(meshCoverage, clipCoverage);
     }
 #endif // ENABLE_CLIPPING
-    imageColor.a *= meshCoverage * imageDrawUniforms.opacity;
+    imageColor =
+        apply_image_opacity(imageColor,
+                            imageDrawUniforms.opacity,
+                            (imageDrawUniforms.flags & IMAGE_DRAW_FLAG_PREMULTIPLIED) != 0u);
+    imageColor.a *= meshCoverage;
 
 #ifdef @ENABLE_ADVANCED_BLEND
     if (lastColor.a != .0 || imageColor.a != 0)
@@ -44,6 +44,16 @@ INLINE half4 unmultiply(half4 color)
     return color;
 }
 
+// Returns the unpremultiplied texel, with the image's opacity applied. 'isPremultiplied' is set for
+// textures whose texels already have premultiplied alpha (e.g., offscreen render targets).
+INLINE half4 apply_image_opacity(half4 color, float opacity, bool isPremultiplied)
+{
+    if (isPremultiplied)
+        color = unmultiply(color);
+    color.a *= make_half(opacity);
+    return color;
+}
+
 INLINE float2x2 make_float2x2(float4 f) { return float2x2(f.xy, f.zw); }
 
 INLINE half min_value(half4 min4)
@@ -140,7 +150,7 @@ UNIFORM_BLOCK_BEGIN(IMAGE_DRAW_UNIFORM_BUFFER_IDX, @ImageDrawUniforms)
 float4 viewMatrix;
 float2 translate;
 float opacity;
-float padding;
+uint flags;
 // clipRectInverseMatrix transforms from pixel coordinates to a space where the clipRect is the
 // normalized rectangle: [-1, -1, 1, 1].
 float4 clipRectInverseMatrix;
@@ -148,5 +158,7 @@ float2 clipRectInverseTranslate;
 uint clipID;
 uint blendMode;
 uint zIndex;
+// Maps [0, 0, 1, 1] to the image's subregion of its texture: xy = scale, zw = translate.
+float4 texCoordTransform;
 UNIFORM_BLOCK_END(imageDrawUniforms)
 #endif
@@ -47,6 +47,17 @@
 #define RIGHT_JOIN_CONTOUR_FLAG (1u << 22u)
 #define CONTOUR_ID_MASK 0xffffu
 
+// Set in the pathID word of a stroke's ContourData if the contour is explicitly closed. (Contour
+// midpoints are always preserved, since compact tessellation spans are stored relative to them.)
+#define CLOSED_STROKE_CONTOUR_DATA_FLAG (1u << 31u)
+
+// Bits 16..30 of the pathID word of ContourData hold the path's parametric tessellation precision,
+// in fixed point, rounded up. The tessellation shader needs it to re-run Wang's formula when
+// culling excess segments.
+#define PARAMETRIC_PRECISION_CONTOUR_DATA_SHIFT 16u
+#define PARAMETRIC_PRECISION_CONTOUR_DATA_MASK 0x7fffu
+#define PARAMETRIC_PRECISION_FIXED_POINT_FACTOR float(16)
+
 // Says which part of the patch a vertex belongs to.
 #define STROKE_VERTEX 0
 #define FAN_VERTEX 1
@@ -67,6 +78,11 @@
 // Paint flags, found in the x-component value of @paintBuffer.
 #define PAINT_FLAG_EVEN_ODD 0x100u
 #define PAINT_FLAG_HAS_CLIP_RECT 0x200u
+#define PAINT_FLAG_PREMULTIPLIED_IMAGE 0x400u
+#define PAINT_FLAG_CLIP_MASK 0x800u // Clip updates that multiply coverage by the image texture.
+
+// Flags found in @ImageDrawUniforms::flags.
+#define IMAGE_DRAW_FLAG_PREMULTIPLIED 0x1u
 
 // Index of each pixel local storage plane.
 #define FRAMEBUFFER_PLANE_IDX 0
@@ -41,7 +41,8 @@ IMAGE_MESH_VERTEX_MAIN(@drawVertexMain, PositionAttr, position, UVAttr, uv, _ver
 
     float2 vertexPosition =
         MUL(make_float2x2(imageDrawUniforms.viewMatrix), @a_position) + imageDrawUniforms.translate;
-    v_texCoord = @a_texCoord;
+    v_texCoord = @a_texCoord * imageDrawUniforms.texCoordTransform.xy +
+                 imageDrawUniforms.texCoordTransform.zw;
 #ifdef @ENABLE_CLIPPING
     v_clipID = id_bits_to_f16(imageDrawUniforms.clipID, uniforms.pathIDGranularity);
 #endif
@@ -128,7 +129,10 @@ PLS_MAIN_WITH_IMAGE_UNIFORMS(@drawFragmentMain)
 #endif
 
     // Blend with the framebuffer color.
-    color.a *= imageDrawUniforms.opacity * coverage;
+    color = apply_image_opacity(color,
+                                imageDrawUniforms.opacity,
+                                (imageDrawUniforms.flags & IMAGE_DRAW_FLAG_PREMULTIPLIED) != 0u);
+    color.a *= coverage;
     half4 dstColor = PLS_LOAD4F(framebuffer);
 #ifdef @ENABLE_ADVANCED_BLEND
     if (imageDrawUniforms.blendMode != 0u /*!srcOver*/)
@@ -165,7 +169,9 @@ FRAG_DATA_MAIN(half4, @drawFragmentMain)
     VARYING_UNPACK(v_texCoord, float2);
 
     half4 color = TEXTURE_SAMPLE(@imageTexture, imageSampler, v_texCoord);
-    color.a *= imageDrawUniforms.opacity;
+    color = apply_image_opacity(color,
+                                imageDrawUniforms.opacity,
+                                (imageDrawUniforms.flags & IMAGE_DRAW_FLAG_PREMULTIPLIED) != 0u);
 
 #ifdef @ENABLE_ADVANCED_BLEND
     half4 dstColor = TEXEL_FETCH(@dstColorTexture, int2(floor(_fragCoord.xy)));
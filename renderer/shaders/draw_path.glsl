@@ -6,6 +6,10 @@
 ATTR_BLOCK_BEGIN(Attrs)
 #ifdef @DRAW_INTERIOR_TRIANGLES
 ATTR(0, packed_float3, @a_triangleVertex);
+#ifdef @DRAW_ANALYTIC_SHAPES
+ATTR(1, float4, @a_analyticShapeRadii); // [outerRadii, innerRadii]
+ATTR(2, float2, @a_analyticShapeInnerHalfSize);
+#endif
 #else
 ATTR(0, float4, @a_patchVertexData); // [localVertexID, outset, fillCoverage, vertexType]
 ATTR(1, float4, @a_mirroredVertexData);
@@ -17,7 +21,13 @@ VARYING_BLOCK_BEGIN
 NO_PERSPECTIVE VARYING(0, float4, v_paint);
 #ifndef @USING_DEPTH_STENCIL
 #ifdef @DRAW_INTERIOR_TRIANGLES
+#ifdef @DRAW_ANALYTIC_SHAPES
+NO_PERSPECTIVE VARYING(1, float2, v_shapeCoord);
+@OPTIONALLY_FLAT VARYING(7, float4, v_shapeRadii);
+@OPTIONALLY_FLAT VARYING(8, float2, v_shapeInnerHalfSize);
+#else
 @OPTIONALLY_FLAT VARYING(1, half, v_windingWeight);
+#endif
 #else
 NO_PERSPECTIVE VARYING(2, half2, v_edgeDistance);
 #endif
@@ -39,6 +49,10 @@ VERTEX_MAIN(@drawVertexMain, Attrs, attrs, _vertexID, _instanceID)
 {
 #ifdef @DRAW_INTERIOR_TRIANGLES
     ATTR_UNPACK(_vertexID, attrs, @a_triangleVertex, float3);
+#ifdef @DRAW_ANALYTIC_SHAPES
+    ATTR_UNPACK(_vertexID, attrs, @a_analyticShapeRadii, float4);
+    ATTR_UNPACK(_vertexID, attrs, @a_analyticShapeInnerHalfSize, float2);
+#endif
 #else
     ATTR_UNPACK(_vertexID, attrs, @a_patchVertexData, float4);
     ATTR_UNPACK(_vertexID, attrs, @a_mirroredVertexData, float4);
@@ -47,7 +61,13 @@ VERTEX_MAIN(@drawVertexMain, Attrs, attrs, _vertexID, _instanceID)
     VARYING_INIT(v_paint, float4);
 #ifndef USING_DEPTH_STENCIL
 #ifdef @DRAW_INTERIOR_TRIANGLES
+#ifdef @DRAW_ANALYTIC_SHAPES
+    VARYING_INIT(v_shapeCoord, float2);
+    VARYING_INIT(v_shapeRadii, float4);
+    VARYING_INIT(v_shapeInnerHalfSize, float2);
+#else
     VARYING_INIT(v_windingWeight, half);
+#endif
 #else
     VARYING_INIT(v_edgeDistance, half2);
 #endif
@@ -71,9 +91,24 @@ VERTEX_MAIN(@drawVertexMain, Attrs, attrs, _vertexID, _instanceID)
 #endif
 
 #ifdef @DRAW_INTERIOR_TRIANGLES
+#ifdef @DRAW_ANALYTIC_SHAPES
+    vertexPosition = unpack_analytic_shape_vertex(@a_triangleVertex,
+                                                  pathID,
+                                                  v_shapeCoord VERTEX_CONTEXT_UNPACK);
+    v_shapeRadii = @a_analyticShapeRadii;
+    v_shapeInnerHalfSize = @a_analyticShapeInnerHalfSize;
+#else
     vertexPosition = unpack_interior_triangle_vertex(@a_triangleVertex,
-                                                     pathID,
-                                                     v_windingWeight VERTEX_CONTEXT_UNPACK);
+                                                     pathID
+#ifndef @USING_DEPTH_STENCIL
+                                                     ,
+                                                     v_windingWeight
+#else
+                                                     ,
+                                                     pathZIndex
+#endif
+                                                         VERTEX_CONTEXT_UNPACK);
+#endif
 #else
     shouldDiscardVertex = !unpack_tessellated_path_vertex(@a_patchVertexData,
                                                           @a_mirroredVertexData,
@@ -90,7 +125,9 @@ VERTEX_MAIN(@drawVertexMain, Attrs, attrs, _vertexID, _instanceID)
                                                               VERTEX_CONTEXT_UNPACK);
 #endif // !DRAW_INTERIOR_TRIANGLES
 
-    uint2 paintData = STORAGE_BUFFER_LOAD2(@paintBuffer, pathID);
+    // Paint records can be shared by multiple paths. Look up this path's paintID.
+    uint paintID = STORAGE_BUFFER_LOAD4(@pathBuffer, pathID * 2u + 1u).w >> 16;
+    uint2 paintData = STORAGE_BUFFER_LOAD2(@paintBuffer, paintID);
 
 #ifndef @USING_DEPTH_STENCIL
     // Encode the integral pathID as a "half" that we know the hardware will see as a unique value
@@ -124,8 +161,8 @@ VERTEX_MAIN(@drawVertexMain, Attrs, attrs, _vertexID, _instanceID)
     // clipRectInverseMatrix transforms from pixel coordinates to a space where the clipRect is the
     // normalized rectangle: [-1, -1, 1, 1].
     float2x2 clipRectInverseMatrix =
-        make_float2x2(STORAGE_BUFFER_LOAD4(@paintAuxBuffer, pathID * 4u + 2u));
-    float4 clipRectInverseTranslate = STORAGE_BUFFER_LOAD4(@paintAuxBuffer, pathID * 4u + 3u);
+        make_float2x2(STORAGE_BUFFER_LOAD4(@paintAuxBuffer, paintID * 4u + 2u));
+    float4 clipRectInverseTranslate = STORAGE_BUFFER_LOAD4(@paintAuxBuffer, paintID * 4u + 3u);
 #ifndef @USING_DEPTH_STENCIL
     v_clipRect = find_clip_rect_coverage_distances(clipRectInverseMatrix,
                                                    clipRectInverseTranslate.xy,
@@ -146,12 +183,22 @@ VERTEX_MAIN(@drawVertexMain, Attrs, attrs, _vertexID, _instanceID)
     {
         half outerClipID = id_bits_to_f16(paintData.x >> 16, uniforms.pathIDGranularity);
         v_paint = float4(outerClipID, 0, 0, 0);
+        if ((paintData.x & PAINT_FLAG_CLIP_MASK) != 0u)
+        {
+            // v_paint.a == 1 signals that coverage gets multiplied by the clip mask's alpha.
+            // v_paint.gb is the normalized clip mask texture coordinate.
+            float2x2 paintMatrix =
+                make_float2x2(STORAGE_BUFFER_LOAD4(@paintAuxBuffer, paintID * 4u));
+            float4 paintTranslate = STORAGE_BUFFER_LOAD4(@paintAuxBuffer, paintID * 4u + 1u);
+            v_paint.gb = MUL(paintMatrix, fragCoord) + paintTranslate.xy;
+            v_paint.a = 1.;
+        }
     }
 #endif
     else
     {
-        float2x2 paintMatrix = make_float2x2(STORAGE_BUFFER_LOAD4(@paintAuxBuffer, pathID * 4u));
-        float4 paintTranslate = STORAGE_BUFFER_LOAD4(@paintAuxBuffer, pathID * 4u + 1u);
+        float2x2 paintMatrix = make_float2x2(STORAGE_BUFFER_LOAD4(@paintAuxBuffer, paintID * 4u));
+        float4 paintTranslate = STORAGE_BUFFER_LOAD4(@paintAuxBuffer, paintID * 4u + 1u);
         float2 paintCoord = MUL(paintMatrix, fragCoord) + paintTranslate.xy;
         if (paintType == LINEAR_GRADIENT_PAINT_TYPE || paintType == RADIAL_GRADIENT_PAINT_TYPE)
         {
@@ -187,11 +234,13 @@ VERTEX_MAIN(@drawVertexMain, Attrs, attrs, _vertexID, _instanceID)
         }
         else // IMAGE_PAINT_TYPE
         {
-            // v_paint.a <= -1. signals that the paint is an image.
+            // v_paint.a <= -1. signals that the paint is an image. It is -3 instead of -2 if the
+            // image's texels have premultiplied alpha.
             // v_paint.b is the image opacity.
             // v_paint.rg is the normalized image texture coordinate (built into the paintMatrix).
             float opacity = uintBitsToFloat(paintData.y);
-            v_paint = float4(paintCoord.x, paintCoord.y, opacity, -2.);
+            float imageType = (paintData.x & PAINT_FLAG_PREMULTIPLIED_IMAGE) != 0u ? -3. : -2.;
+            v_paint = float4(paintCoord.x, paintCoord.y, opacity, imageType);
         }
     }
 
@@ -214,7 +263,13 @@ VERTEX_MAIN(@drawVertexMain, Attrs, attrs, _vertexID, _instanceID)
     VARYING_PACK(v_paint);
 #ifndef @USING_DEPTH_STENCIL
 #ifdef @DRAW_INTERIOR_TRIANGLES
+#ifdef @DRAW_ANALYTIC_SHAPES
+    VARYING_PACK(v_shapeCoord);
+    VARYING_PACK(v_shapeRadii);
+    VARYING_PACK(v_shapeInnerHalfSize);
+#else
     VARYING_PACK(v_windingWeight);
+#endif
 #else
     VARYING_PACK(v_edgeDistance);
 #endif
@@ -289,7 +344,8 @@ INLINE half4 find_paint_color(float4 paint
 #else
         color = TEXTURE_SAMPLE(@imageTexture, imageSampler, paint.rg);
 #endif
-        color.a *= paint.b; // paint.b holds the opacity of the image.
+        // paint.b holds the opacity of the image.
+        color = apply_image_opacity(color, paint.b, /*isPremultiplied =*/paint.a < -2.5);
         return color;
     }
 }
@@ -307,7 +363,13 @@ PLS_MAIN(@drawFragmentMain)
 {
     VARYING_UNPACK(v_paint, float4);
 #ifdef @DRAW_INTERIOR_TRIANGLES
+#ifdef @DRAW_ANALYTIC_SHAPES
+    VARYING_UNPACK(v_shapeCoord, float2);
+    VARYING_UNPACK(v_shapeRadii, float4);
+    VARYING_UNPACK(v_shapeInnerHalfSize, float2);
+#else
     VARYING_UNPACK(v_windingWeight, half);
+#endif
 #else
     VARYING_UNPACK(v_edgeDistance, half2);
 #endif
@@ -333,9 +395,21 @@ PLS_MAIN(@drawFragmentMain)
     float2 imagePaintDDY = dFdy(v_paint.rg);
 #endif
 
+#ifdef @DRAW_ANALYTIC_SHAPES
+    // Find the shape coordinate derivatives in uniform control flow.
+    float2 shapeCoordDDX = dFdx(v_shapeCoord);
+    float2 shapeCoordDDY = dFdy(v_shapeCoord);
+#endif
+
 #ifndef @DRAW_INTERIOR_TRIANGLES
     // Interior triangles don't overlap, so don't need raster ordering.
     PLS_INTERLOCK_BEGIN;
+#else
+#ifdef @DRAW_ANALYTIC_SHAPES
+    // Each analytic shape only touches a pixel once, but different shapes in the same batch may
+    // still overlap.
+    PLS_INTERLOCK_BEGIN;
+#endif
 #endif
 
     half2 coverageData = unpackHalf2x16(PLS_LOADUI(coverageCountBuffer));
@@ -343,7 +417,15 @@ PLS_MAIN(@drawFragmentMain)
     half coverageCount = coverageBufferID == v_pathID ? coverageData.r : make_half(0);
 
 #ifdef @DRAW_INTERIOR_TRIANGLES
+#ifdef @DRAW_ANALYTIC_SHAPES
+    coverageCount += analytic_shape_coverage(v_shapeCoord,
+                                             v_shapeRadii,
+                                             v_shapeInnerHalfSize,
+                                             shapeCoordDDX,
+                                             shapeCoordDDY);
+#else
     coverageCount += v_windingWeight;
+#endif
 #else
     if (v_edgeDistance.y >= .0) // Stroke.
         coverageCount = max(min(v_edgeDistance.x, v_edgeDistance.y), coverageCount);
@@ -366,6 +448,14 @@ PLS_MAIN(@drawFragmentMain)
     if (v_clipID < .0) // Update the clip buffer.
     {
         half clipID = -v_clipID;
+        if (v_paint.a != .0)
+        {
+            // Copy coverage from a retained clip mask. The mask maps 1:1 onto pixels and only has
+            // one mip level, so sample it without derivatives.
+            half4 clipMask =
+                make_half4(TEXTURE_SAMPLE_LOD(@imageTexture, imageSampler, v_paint.gb, .0));
+            coverage *= clipMask.a;
+        }
 #ifdef @ENABLE_NESTED_CLIPPING
         half outerClipID = v_paint.r;
         if (outerClipID != .0)
@@ -479,6 +569,10 @@ PLS_MAIN(@drawFragmentMain)
 #ifndef @DRAW_INTERIOR_TRIANGLES
     // Interior triangles don't overlap, so don't need raster ordering.
     PLS_INTERLOCK_END;
+#else
+#ifdef @DRAW_ANALYTIC_SHAPES
+    PLS_INTERLOCK_END;
+#endif
 #endif
 
     EMIT_PLS;
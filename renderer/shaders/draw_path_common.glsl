@@ -71,7 +71,7 @@ INLINE bool unpack_tessellated_path_vertex(float4 patchVertexData,
 
     float strokeRadius = uintBitsToFloat(pathData.z);
 #ifdef @USING_DEPTH_STENCIL
-    o_pathZIndex = make_ushort(pathData.w);
+    o_pathZIndex = make_ushort(pathData.w & 0xffffu);
 #endif
 
     // Fix the tessellation vertex if we fetched the wrong one in order to guarantee we got the
@@ -96,7 +96,7 @@ INLINE bool unpack_tessellated_path_vertex(float4 patchVertexData,
             // We crossed over into a new contour. Either wrap to the first vertex in the contour or
             // leave it clamped at the final vertex of the contour.
             bool isClosed = strokeRadius == .0 || // filled
-                            midpoint.x != .0;     // explicity closed stroke
+                            (contourData.z & CLOSED_STROKE_CONTOUR_DATA_FLAG) != 0u;
             if (isClosed)
             {
                 tessVertexData =
@@ -284,16 +284,94 @@ INLINE bool unpack_tessellated_path_vertex(float4 patchVertexData,
 
 #ifdef @DRAW_INTERIOR_TRIANGLES
 INLINE float2 unpack_interior_triangle_vertex(float3 triangleVertex,
-                                              OUT(ushort) o_pathID,
-                                              OUT(half) o_windingWeight VERTEX_CONTEXT_DECL)
+                                              OUT(ushort) o_pathID
+#ifndef @USING_DEPTH_STENCIL
+                                              ,
+                                              OUT(half) o_windingWeight
+#else
+                                              ,
+                                              OUT(ushort) o_pathZIndex
+#endif
+                                                  VERTEX_CONTEXT_DECL)
 {
     o_pathID = make_ushort(floatBitsToUint(triangleVertex.z) & 0xffffu);
     float2x2 M = make_float2x2(uintBitsToFloat(STORAGE_BUFFER_LOAD4(@pathBuffer, o_pathID * 2u)));
     uint4 pathData = STORAGE_BUFFER_LOAD4(@pathBuffer, o_pathID * 2u + 1u);
     float2 translate = uintBitsToFloat(pathData.xy);
+#ifndef @USING_DEPTH_STENCIL
     o_windingWeight = float(floatBitsToInt(triangleVertex.z) >> 16) * sign(determinant(M));
+#else
+    // depthStencil mode winds the triangles instead of weighting them.
+    o_pathZIndex = make_ushort(pathData.w & 0xffffu);
+#endif
     return MUL(M, triangleVertex.xy) + translate;
 }
 #endif // @DRAW_INTERIOR_TRIANGLES
 
+#ifdef @DRAW_ANALYTIC_SHAPES
+// Analytic shape vertices are in a normalized "shape space" where the outer shape spans [-1, +1].
+// The path matrix maps shape space to pixels.
+INLINE float2 unpack_analytic_shape_vertex(float3 triangleVertex,
+                                           OUT(ushort) o_pathID,
+                                           OUT(float2) o_shapeCoord VERTEX_CONTEXT_DECL)
+{
+    o_pathID = make_ushort(floatBitsToUint(triangleVertex.z) & 0xffffu);
+    float2x2 M = make_float2x2(uintBitsToFloat(STORAGE_BUFFER_LOAD4(@pathBuffer, o_pathID * 2u)));
+    uint4 pathData = STORAGE_BUFFER_LOAD4(@pathBuffer, o_pathID * 2u + 1u);
+    float2 translate = uintBitsToFloat(pathData.xy);
+    o_shapeCoord = triangleVertex.xy;
+    return MUL(M, triangleVertex.xy) + translate;
+}
+#endif // @DRAW_ANALYTIC_SHAPES
+
 #endif // @VERTEX
+
+#ifdef @FRAGMENT
+#ifdef @DRAW_ANALYTIC_SHAPES
+// Returns the coverage of a rounded rectangle centered on the origin. The screen-space derivatives
+// of shapeCoord convert shape-space distances to pixels.
+INLINE half rrect_coverage(float2 shapeCoord,
+                           float2 halfSize,
+                           float2 radii,
+                           float2 shapeCoordDDX,
+                           float2 shapeCoordDDY)
+{
+    float2 p = abs(shapeCoord);
+    float2 q = p - (halfSize - radii);
+    if (q.x > .0 && q.y > .0 && min(radii.x, radii.y) > .0)
+    {
+        // We're in a corner. Divide the ellipse's implicit function by the length of its gradient
+        // in pixels.
+        float2 invRadii2 = 1. / (radii * radii);
+        float f = dot(q * q, invRadii2) - 1.;
+        float2 grad = sign(shapeCoord) * q * invRadii2 * 2.;
+        float2 pixelGrad = float2(dot(grad, shapeCoordDDX), dot(grad, shapeCoordDDY));
+        float distance = f * inversesqrt(dot(pixelGrad, pixelGrad));
+        return make_half(clamp(.5 - distance, .0, 1.));
+    }
+    // We're next to the straight edges. Convert the distance to each edge to pixels.
+    float2 unitsPerPixel = sqrt(shapeCoordDDX * shapeCoordDDX + shapeCoordDDY * shapeCoordDDY);
+    float2 distance = (p - halfSize) / unitsPerPixel;
+    float2 edgeCoverage = clamp(.5 - distance, float2(0, 0), float2(1, 1));
+    return make_half(edgeCoverage.x * edgeCoverage.y);
+}
+
+// Returns the coverage of an analytic rect, rounded rect, or ellipse (outer shape), minus an
+// optional inner rounded rect for strokes. The outer shape always spans [-1, +1] in shape space.
+INLINE half analytic_shape_coverage(float2 shapeCoord,
+                                    float4 radii, // [outerRadii, innerRadii]
+                                    float2 innerHalfSize,
+                                    float2 shapeCoordDDX,
+                                    float2 shapeCoordDDY)
+{
+    half coverage =
+        rrect_coverage(shapeCoord, float2(1, 1), radii.xy, shapeCoordDDX, shapeCoordDDY);
+    if (innerHalfSize.x > .0 && innerHalfSize.y > .0) // Stroke?
+    {
+        coverage -=
+            rrect_coverage(shapeCoord, innerHalfSize, radii.zw, shapeCoordDDX, shapeCoordDDY);
+    }
+    return max(coverage, make_half(0));
+}
+#endif // @DRAW_ANALYTIC_SHAPES
+#endif // @FRAGMENT
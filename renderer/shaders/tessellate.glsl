@@ -13,10 +13,16 @@
 
 #ifdef @VERTEX
 ATTR_BLOCK_BEGIN(Attrs)
+#ifdef @COMPACT_TESS_VERTEX_SPANS
+// See pls::TessVertexSpanCompact.
+ATTR(0, uint4, @a_pts);         // fp16x2 offsets from the contour midpoint: [p0, p1, p2, p3]
+ATTR(1, uint4, @a_compactArgs); // [joinTangent, location, segmentCounts, contourIDWithFlags]
+#else
 ATTR(0, float4, @a_p0p1_); // End in '_' because D3D interprets the '1' as a semantic index.
 ATTR(1, float4, @a_p2p3_);
 ATTR(2, float4, @a_joinTan_and_ys); // [joinTangent, y, reflectionY]
 ATTR(3, uint4, @a_args);            // [x0x1, reflectionX0X1, segmentCounts, contourIDWithFlags]
+#endif
 ATTR_BLOCK_END
 #endif
 
@@ -57,11 +63,16 @@ float cosine_between_vectors(float2 a, float2 b)
 
 VERTEX_MAIN(@tessellateVertexMain, Attrs, attrs, _vertexID, _instanceID)
 {
+#ifdef @COMPACT_TESS_VERTEX_SPANS
+    ATTR_UNPACK(_instanceID, attrs, @a_pts, uint4);
+    ATTR_UNPACK(_instanceID, attrs, @a_compactArgs, uint4);
+#else
     // Each instance repeats twice. Once for normal patch(es) and once for reflection(s).
     ATTR_UNPACK(_instanceID, attrs, @a_p0p1_, float4);
     ATTR_UNPACK(_instanceID, attrs, @a_p2p3_, float4);
     ATTR_UNPACK(_instanceID, attrs, @a_joinTan_and_ys, float4);
     ATTR_UNPACK(_instanceID, attrs, @a_args, uint4);
+#endif
 
     VARYING_INIT(v_p0p1, float4);
     VARYING_INIT(v_p2p3, float4);
@@ -69,10 +80,52 @@ VERTEX_MAIN(@tessellateVertexMain, Attrs, attrs, _vertexID, _instanceID)
     VARYING_INIT(v_joinArgs, float3);
     VARYING_INIT(v_contourIDWithFlags, uint);
 
+#ifdef @COMPACT_TESS_VERTEX_SPANS
+    uint contourIDWithFlags = @a_compactArgs.w;
+    float2 origin = float2(.0, .0);
+    if ((contourIDWithFlags & CONTOUR_ID_MASK) != 0u) // Padding spans have no contour.
+    {
+        origin = uintBitsToFloat(
+            STORAGE_BUFFER_LOAD4(@contourBuffer, contour_data_idx(contourIDWithFlags)).xy);
+    }
+    float2 p0 = origin + float2(unpackHalf2x16(@a_pts.x));
+    float2 p1 = origin + float2(unpackHalf2x16(@a_pts.y));
+    float2 p2 = origin + float2(unpackHalf2x16(@a_pts.z));
+    float2 p3 = origin + float2(unpackHalf2x16(@a_pts.w));
+    float2 joinTangent = float2(unpackHalf2x16(@a_compactArgs.x));
+    uint segmentCounts = @a_compactArgs.z;
+    uint parametricSegmentCount = segmentCounts & 0x3ffu;
+    uint polarSegmentCount = (segmentCounts >> 10) & 0x3ffu;
+    uint joinSegmentCount = segmentCounts >> 20;
+
+    // Reconstruct the span's coordinates in the tessellation texture from its location.
+    uint location = @a_compactArgs.y;
+    uint tessLocation = location & 0x3fffffu;
+    float wrapIdx = float((location >> 22) & 3u);
+    float spanLength = float(((location >> 24) & 0x1fu) + parametricSegmentCount +
+                             polarSegmentCount + joinSegmentCount - 1u);
+    float y = float(tessLocation >> TESS_TEXTURE_WIDTH_LOG2);
+    float x0 = float(tessLocation & ((1u << TESS_TEXTURE_WIDTH_LOG2) - 1u));
+    float x1;
+    if ((location & (1u << 31)) == 0u)
+    {
+        y += wrapIdx;
+        x0 -= wrapIdx * TESS_TEXTURE_WIDTH;
+        x1 = x0 + spanLength;
+    }
+    else
+    {
+        // Mirrored spans are located by their rightmost vertex, and drawn right to left.
+        y -= wrapIdx;
+        x0 += wrapIdx * TESS_TEXTURE_WIDTH + 1.;
+        x1 = x0 - spanLength;
+    }
+#else
     float2 p0 = @a_p0p1_.xy;
     float2 p1 = @a_p0p1_.zw;
     float2 p2 = @a_p2p3_.xy;
     float2 p3 = @a_p2p3_.zw;
+    float2 joinTangent = @a_joinTan_and_ys.xy;
     // Each instance has two spans, potentially for both a forward copy and and reflection.
     // (If the second span isn't needed, the client will have placed it offscreen.)
     bool isFirstSpan = _vertexID < 4;
@@ -80,12 +133,14 @@ VERTEX_MAIN(@tessellateVertexMain, Attrs, attrs, _vertexID, _instanceID)
     int x0x1 = int(isFirstSpan ? @a_args.x : @a_args.y);
     float x0 = float(x0x1 << 16 >> 16);
     float x1 = float(x0x1 >> 16);
-    float2 coord = float2((_vertexID & 1) == 0 ? x0 : x1, (_vertexID & 2) == 0 ? y + 1. : y);
 
     uint parametricSegmentCount = @a_args.z & 0x3ffu;
     uint polarSegmentCount = (@a_args.z >> 10) & 0x3ffu;
     uint joinSegmentCount = @a_args.z >> 20;
     uint contourIDWithFlags = @a_args.w;
+#endif
+    float2 coord = float2((_vertexID & 1) == 0 ? x0 : x1, (_vertexID & 2) == 0 ? y + 1. : y);
+
     if (x1 < x0) // Reflections are drawn right to left.
     {
         contourIDWithFlags |= MIRRORED_CONTOUR_CONTOUR_FLAG;
@@ -103,13 +158,16 @@ VERTEX_MAIN(@tessellateVertexMain, Attrs, attrs, _vertexID, _instanceID)
         // and make any excess segments degenerate by co-locating their vertices at T=0.
         uint pathIDBits =
             STORAGE_BUFFER_LOAD4(@contourBuffer, contour_data_idx(contourIDWithFlags)).z;
-        float2x2 mat =
-            make_float2x2(uintBitsToFloat(STORAGE_BUFFER_LOAD4(@pathBuffer, pathIDBits * 2u)));
+        float parametricPrecision = float((pathIDBits >> PARAMETRIC_PRECISION_CONTOUR_DATA_SHIFT) &
+                                          PARAMETRIC_PRECISION_CONTOUR_DATA_MASK) *
+                                    (1. / PARAMETRIC_PRECISION_FIXED_POINT_FACTOR);
+        float2x2 mat = make_float2x2(
+            uintBitsToFloat(STORAGE_BUFFER_LOAD4(@pathBuffer, (pathIDBits & 0xffffu) * 2u)));
         float2 d0 = MUL(mat, -2. * p1 + p2 + p0);
 
         float2 d1 = MUL(mat, -2. * p2 + p3 + p1);
         float m = max(dot(d0, d0), dot(d1, d1));
-        float n = max(ceil(sqrt(.75 * 4. * sqrt(m))), 1.);
+        float n = max(ceil(sqrt(.75 * parametricPrecision * sqrt(m))), 1.);
         parametricSegmentCount = min(uint(n), parametricSegmentCount);
     }
     // Polar and parametric segments share the same beginning and ending vertices, so the merged
@@ -136,7 +194,7 @@ VERTEX_MAIN(@tessellateVertexMain, Attrs, attrs, _vertexID, _instanceID)
                     radsPerPolarSegment);
     if (joinSegmentCount > 1u)
     {
-        float2x2 joinTangents = float2x2(tangents[1], @a_joinTan_and_ys.xy);
+        float2x2 joinTangents = float2x2(tangents[1], joinTangent);
         float joinTheta = acos(cosine_between_vectors(joinTangents[0], joinTangents[1]));
         float joinSpan = float(joinSegmentCount);
         if ((contourIDWithFlags & (JOIN_TYPE_MASK | EMULATED_STROKE_CAP_CONTOUR_FLAG)) ==
@@ -151,7 +209,7 @@ VERTEX_MAIN(@tessellateVertexMain, Attrs, attrs, _vertexID, _instanceID)
         float radsPerJoinSegment = joinTheta / joinSpan;
         if (determinant(joinTangents) < .0)
             radsPerJoinSegment = -radsPerJoinSegment;
-        v_joinArgs.xy = @a_joinTan_and_ys.xy;
+        v_joinArgs.xy = joinTangent;
         v_joinArgs.z = radsPerJoinSegment;
     }
     v_contourIDWithFlags = contourIDWithFlags;
@@ -0,0 +1,108 @@
+/*
+ * Copyright 2024 Rive
+ */
+
+#include "rive/pls/webgpu/dawn_pipeline_cache.hpp"
+
+#ifdef RIVE_DAWN
+
+#include "rive/pls/pls.hpp"
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+namespace rive::pls
+{
+constexpr static uint32_t kBlobFileMagic = 0x44504c53; // 'DPLS'
+
+// Precedes the key and then the value in each blob file.
+struct BlobFileHeader
+{
+    uint32_t magic;
+    uint32_t keySize;
+    uint64_t valueSize;
+};
+
+std::string DawnPipelineCache::FileCachingInterface::blobPath(const void* key,
+                                                              size_t keySize) const
+{
+    char filename[40];
+    snprintf(filename,
+             sizeof(filename),
+             "/rive_dawn_%016llx.bin",
+             static_cast<unsigned long long>(pls::HashBytes(pls::kFNVOffsetBasis, key, keySize)));
+    return m_directory + filename;
+}
+
+size_t DawnPipelineCache::FileCachingInterface::LoadData(const void* key,
+                                                         size_t keySize,
+                                                         void* value,
+                                                         size_t valueSize)
+{
+    FILE* file = fopen(blobPath(key, keySize).c_str(), "rb");
+    if (file == nullptr)
+    {
+        return 0;
+    }
+    BlobFileHeader header;
+    std::vector<uint8_t> storedKey;
+    bool valid = fread(&header, sizeof(header), 1, file) == 1 && header.magic == kBlobFileMagic &&
+                 header.keySize == keySize;
+    if (valid)
+    {
+        storedKey.resize(keySize);
+        valid = fread(storedKey.data(), 1, keySize, file) == keySize &&
+                memcmp(storedKey.data(), key, keySize) == 0;
+    }
+    size_t loadedSize = 0;
+    if (valid)
+    {
+        // Dawn first queries the size with a null 'value', then loads into a buffer of that size.
+        if (value == nullptr)
+        {
+            loadedSize = header.valueSize;
+        }
+        else if (valueSize >= header.valueSize)
+        {
+            size_t blobSize = header.valueSize;
+            if (fread(value, 1, blobSize, file) == blobSize)
+            {
+                loadedSize = blobSize;
+            }
+        }
+    }
+    fclose(file);
+    return loadedSize;
+}
+
+void DawnPipelineCache::FileCachingInterface::StoreData(const void* key,
+                                                        size_t keySize,
+                                                        const void* value,
+                                                        size_t valueSize)
+{
+    std::string path = blobPath(key, keySize);
+    std::string tempPath = path + ".tmp";
+    FILE* file = fopen(tempPath.c_str(), "wb");
+    if (file == nullptr)
+    {
+        return;
+    }
+    BlobFileHeader header = {
+        .magic = kBlobFileMagic,
+        .keySize = static_cast<uint32_t>(keySize),
+        .valueSize = valueSize,
+    };
+    bool success = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                   fwrite(key, 1, keySize, file) == keySize &&
+                   fwrite(value, 1, valueSize, file) == valueSize;
+    success = fclose(file) == 0 && success;
+    remove(path.c_str()); // rename() doesn't overwrite on Windows.
+    if (!success || rename(tempPath.c_str(), path.c_str()) != 0)
+    {
+        remove(tempPath.c_str());
+    }
+}
+} // namespace rive::pls
+
+#endif
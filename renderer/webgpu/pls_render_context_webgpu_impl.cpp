@@ -45,11 +45,12 @@ static void write_texture(wgpu::Queue queue,
                           uint32_t width,
                           uint32_t height,
                           const void* data,
-                          size_t dataSize)
+                          size_t dataSize,
+                          uint32_t mipLevel = 0)
 {
     wgpu::ImageCopyTexture dest = {
         .texture = texture,
-        .mipLevel = 0,
+        .mipLevel = mipLevel,
     };
     wgpu::TextureDataLayout layout = {
         .bytesPerRow = bytesPerRow,
@@ -92,14 +93,15 @@ EM_JS(void,
        uint32_t width,
        uint32_t height,
        uintptr_t indexU8,
-       size_t dataSize),
+       size_t dataSize,
+       uint32_t mipLevel),
       {
           queue = JsValStore.get(queue);
           texture = JsValStore.get(texture);
           // Copy data off the WASM heap before sending it to WebGPU bindings.
           const data = new Uint8Array(dataSize);
           data.set(Module.HEAPU8.subarray(indexU8, indexU8 + dataSize));
-          queue.writeTexture({texture},
+          queue.writeTexture({texture, mipLevel},
                              data,
                              {bytesPerRow : bytesPerRow},
                              {width : width, height : height});
@@ -111,7 +113,8 @@ static void write_texture(wgpu::Queue queue,
                           uint32_t width,
                           uint32_t height,
                           const void* data,
-                          size_t dataSize)
+                          size_t dataSize,
+                          uint32_t mipLevel = 0)
 {
     write_texture_js(emscripten_webgpu_export_queue(queue.Get()),
                      emscripten_webgpu_export_texture(texture.Get()),
@@ -119,7 +122,8 @@ static void write_texture(wgpu::Queue queue,
                      width,
                      height,
                      reinterpret_cast<uintptr_t>(data),
-                     dataSize);
+                     dataSize,
+                     mipLevel);
 }
 
 EM_JS(void, write_buffer_js, (int queue, int buffer, uintptr_t indexU8, size_t dataSize), {
@@ -519,6 +523,40 @@ private:
     wgpu::RenderPipeline m_renderPipeline;
 };
 
+// Holds the result of CreateRenderPipelineAsync(). Reference counted so the creation callback stays
+// valid if the DrawPipeline that requested it gets destroyed first.
+class PLSRenderContextWebGPUImpl::AsyncRenderPipeline : public RefCnt<AsyncRenderPipeline>
+{
+public:
+    // Null until the pipeline has finished creating.
+    const wgpu::RenderPipeline& pipeline() const { return m_pipeline; }
+    void setPipeline(wgpu::RenderPipeline pipeline) { m_pipeline = std::move(pipeline); }
+
+    // Begins creating a pipeline in the background, to be delivered to this object.
+    void createAsync(wgpu::Device device, const wgpu::RenderPipelineDescriptor& desc)
+    {
+        // The callback adopts this ref.
+        device.CreateRenderPipelineAsync(&desc, OnPipelineCreated, safe_ref(this));
+    }
+
+private:
+    static void OnPipelineCreated(WGPUCreatePipelineAsyncStatus status,
+                                  WGPURenderPipeline pipeline,
+                                  const char* message,
+                                  void* userdata)
+    {
+        rcp<AsyncRenderPipeline> asyncResult(static_cast<AsyncRenderPipeline*>(userdata));
+        if (status == WGPUCreatePipelineAsyncStatus_Success)
+        {
+            asyncResult->m_pipeline = wgpu::RenderPipeline::Acquire(pipeline);
+        }
+        // Otherwise the pipeline stays null and we keep drawing with its fallback. Validation
+        // errors have already been reported to the device's error callback.
+    }
+
+    wgpu::RenderPipeline m_pipeline;
+};
+
 // Draw paths and image meshes using the gradient and tessellation textures.
 class PLSRenderContextWebGPUImpl::DrawPipeline
 {
@@ -526,7 +564,8 @@ public:
     DrawPipeline(PLSRenderContextWebGPUImpl* context,
                  DrawType drawType,
                  pls::ShaderFeatures shaderFeatures,
-                 const ContextOptions& contextOptions)
+                 const ContextOptions& contextOptions,
+                 bool synchronous)
     {
         PixelLocalStorageType plsType = context->m_contextOptions.plsType;
         wgpu::ShaderModule vertexShader, fragmentShader;
@@ -594,6 +633,7 @@ public:
                 case DrawType::plsAtomicInitialize:
                 case DrawType::plsAtomicResolve:
                 case DrawType::stencilClipReset:
+                case DrawType::analyticShapes:
                     RIVE_UNREACHABLE();
             }
             for (size_t i = 0; i < pls::kShaderFeatureCount; ++i)
@@ -650,6 +690,7 @@ public:
                     addDefine(GLSL_RESOLVE_PLS);
                     RIVE_UNREACHABLE();
                 case DrawType::stencilClipReset:
+                case DrawType::analyticShapes:
                     RIVE_UNREACHABLE();
             }
 
@@ -711,6 +752,7 @@ public:
                 case DrawType::plsAtomicInitialize:
                 case DrawType::plsAtomicResolve:
                 case DrawType::stencilClipReset:
+                case DrawType::analyticShapes:
                     RIVE_UNREACHABLE();
             }
         }
@@ -719,18 +761,26 @@ public:
              {wgpu::TextureFormat::BGRA8Unorm, wgpu::TextureFormat::RGBA8Unorm})
         {
             int pipelineIdx = RenderPipelineIdx(framebufferFormat);
-            m_renderPipelines[pipelineIdx] =
+            m_renderPipelines[pipelineIdx] = make_rcp<AsyncRenderPipeline>();
+            wgpu::RenderPipeline pipeline =
                 context->makePLSDrawPipeline(drawType,
                                              framebufferFormat,
                                              vertexShader,
                                              fragmentShader,
-                                             &m_renderPipelineHandles[pipelineIdx]);
+                                             &m_renderPipelineHandles[pipelineIdx],
+                                             synchronous ? nullptr
+                                                         : m_renderPipelines[pipelineIdx].get());
+            if (pipeline)
+            {
+                m_renderPipelines[pipelineIdx]->setPipeline(std::move(pipeline));
+            }
         }
     }
 
-    const wgpu::RenderPipeline renderPipeline(wgpu::TextureFormat framebufferFormat) const
+    // Null if the pipeline is still being created asynchronously.
+    const wgpu::RenderPipeline& renderPipeline(wgpu::TextureFormat framebufferFormat) const
     {
-        return m_renderPipelines[RenderPipelineIdx(framebufferFormat)];
+        return m_renderPipelines[RenderPipelineIdx(framebufferFormat)]->pipeline();
     }
 
 private:
@@ -743,7 +793,7 @@ private:
 
     EmJsHandle m_vertexShaderHandle;
     EmJsHandle m_fragmentShaderHandle;
-    wgpu::RenderPipeline m_renderPipelines[2];
+    rcp<AsyncRenderPipeline> m_renderPipelines[2];
     EmJsHandle m_renderPipelineHandles[2];
 };
 
@@ -1209,6 +1259,40 @@ public:
                       height * width * 4);
     }
 
+    // Creates a texture in 'format' from a block-compressed image and its own mip chain.
+    PLSTextureWebGPUImpl(wgpu::Device device,
+                         wgpu::Queue queue,
+                         const CompressedImage& image,
+                         wgpu::TextureFormat format) :
+        PLSTexture(image.width, image.height)
+    {
+        wgpu::TextureDescriptor desc = {
+            .usage = wgpu::TextureUsage::TextureBinding | wgpu::TextureUsage::CopyDst,
+            .dimension = wgpu::TextureDimension::e2D,
+            .size = {image.width, image.height},
+            .format = format,
+            .mipLevelCount = image.mipLevelCount,
+        };
+
+        m_texture = device.CreateTexture(&desc);
+        m_textureView = m_texture.CreateView();
+
+        for (uint32_t level = 0; level < image.mipLevelCount; ++level)
+        {
+            // Copies of compressed formats are measured in whole blocks.
+            uint32_t levelWidth = std::max(image.width >> level, 1u);
+            uint32_t levelHeight = std::max(image.height >> level, 1u);
+            write_texture(queue,
+                          m_texture,
+                          (levelWidth + 3) / 4 * CompressedTextureBlockSizeInBytes(image.format),
+                          math::round_up_to_multiple_of<4>(levelWidth),
+                          math::round_up_to_multiple_of<4>(levelHeight),
+                          image.mipLevelData[level],
+                          CompressedTextureSizeInBytes(image.format, levelWidth, levelHeight),
+                          level);
+        }
+    }
+
     wgpu::TextureView textureView() const { return m_textureView; }
 
 private:
@@ -1229,6 +1313,50 @@ rcp<PLSTexture> PLSRenderContextWebGPUImpl::makeImageTexture(uint32_t width,
                                           imageDataRGBA);
 }
 
+rcp<PLSTexture> PLSRenderContextWebGPUImpl::makeCompressedImageTexture(
+    const CompressedImage& image)
+{
+    // WebGPU requires the base level of a compressed texture to be a whole number of blocks.
+    if ((image.width | image.height) & 3)
+    {
+        return nullptr;
+    }
+    wgpu::TextureFormat format = wgpu::TextureFormat::Undefined;
+    wgpu::FeatureName feature = wgpu::FeatureName::Undefined;
+    switch (image.format)
+    {
+        case CompressedTextureFormat::etc2RGB8:
+            format = wgpu::TextureFormat::ETC2RGB8Unorm;
+            feature = wgpu::FeatureName::TextureCompressionETC2;
+            break;
+        case CompressedTextureFormat::etc2RGBA8:
+            format = wgpu::TextureFormat::ETC2RGBA8Unorm;
+            feature = wgpu::FeatureName::TextureCompressionETC2;
+            break;
+        case CompressedTextureFormat::astc4x4RGBA:
+            format = wgpu::TextureFormat::ASTC4x4Unorm;
+            feature = wgpu::FeatureName::TextureCompressionASTC;
+            break;
+        case CompressedTextureFormat::bc1RGBA:
+            format = wgpu::TextureFormat::BC1RGBAUnorm;
+            feature = wgpu::FeatureName::TextureCompressionBC;
+            break;
+        case CompressedTextureFormat::bc3RGBA:
+            format = wgpu::TextureFormat::BC3RGBAUnorm;
+            feature = wgpu::FeatureName::TextureCompressionBC;
+            break;
+        case CompressedTextureFormat::bc7RGBA:
+            format = wgpu::TextureFormat::BC7RGBAUnorm;
+            feature = wgpu::FeatureName::TextureCompressionBC;
+            break;
+    }
+    if (!m_device.HasFeature(feature))
+    {
+        return nullptr;
+    }
+    return make_rcp<PLSTextureWebGPUImpl>(m_device, m_queue, image, format);
+}
+
 class BufferWebGPU : public BufferRing
 {
 public:
@@ -1261,9 +1389,9 @@ public:
 protected:
     void* onMapBuffer(int bufferIdx, size_t mapSizeInBytes) override { return shadowBuffer(); }
 
-    void onUnmapAndSubmitBuffer(int bufferIdx, size_t mapSizeInBytes) override
+    void onUnmapAndSubmitBuffer(int bufferIdx, size_t updateSizeInBytes) override
     {
-        write_buffer(m_queue, m_buffers[bufferIdx], shadowBuffer(), mapSizeInBytes);
+        write_buffer(m_queue, m_buffers[bufferIdx], shadowBuffer(), updateSizeInBytes);
     }
 
     const wgpu::Queue m_queue;
@@ -1432,7 +1560,8 @@ wgpu::RenderPipeline PLSRenderContextWebGPUImpl::makePLSDrawPipeline(
     wgpu::TextureFormat framebufferFormat,
     wgpu::ShaderModule vertexShader,
     wgpu::ShaderModule fragmentShader,
-    EmJsHandle* pipelineJSHandleIfNeeded)
+    EmJsHandle* pipelineJSHandleIfNeeded,
+    AsyncRenderPipeline* asyncResult)
 {
     std::vector<wgpu::VertexAttribute> attrs;
     std::vector<wgpu::VertexBufferLayout> vertexBufferLayouts;
@@ -1518,6 +1647,7 @@ wgpu::RenderPipeline PLSRenderContextWebGPUImpl::makePLSDrawPipeline(
         case DrawType::plsAtomicInitialize:
         case DrawType::plsAtomicResolve:
         case DrawType::stencilClipReset:
+        case DrawType::analyticShapes:
             RIVE_UNREACHABLE();
     }
 
@@ -1560,6 +1690,11 @@ wgpu::RenderPipeline PLSRenderContextWebGPUImpl::makePLSDrawPipeline(
         .fragment = &fragmentState,
     };
 
+    if (asyncResult != nullptr)
+    {
+        asyncResult->createAsync(m_device, desc);
+        return nullptr;
+    }
     return m_device.CreateRenderPipeline(&desc);
 }
 
@@ -1640,6 +1775,73 @@ wgpu::TextureView webgpu_storage_texture_view(const BufferRing* bufferRing)
     return static_cast<const StorageTextureBufferWebGPU*>(bufferRing)->textureView();
 }
 
+void PLSRenderContextWebGPUImpl::precompileShaders(const std::vector<pls::ShaderVariant>& variants)
+{
+    for (const pls::ShaderVariant& variant : variants)
+    {
+        // The WebGPU backend only renders in rasterOrdering mode.
+        if (variant.interlockMode != pls::InterlockMode::rasterOrdering ||
+            variant.drawType == DrawType::imageRect)
+        {
+            continue;
+        }
+        // Fully-featured pipelines are what specialized pipelines fall back on while they
+        // compile, so they are always created synchronously. (See findCompatibleDrawPipeline().)
+        ShaderFeatures fullyFeaturedPipelineFeatures =
+            pls::ShaderFeaturesMaskFor(variant.drawType, pls::InterlockMode::rasterOrdering) |
+            variant.shaderFeatures;
+        m_drawPipelines.try_emplace(pls::ShaderUniqueKey(variant.drawType,
+                                                         variant.shaderFeatures,
+                                                         pls::InterlockMode::rasterOrdering,
+                                                         pls::ShaderMiscFlags::none),
+                                    this,
+                                    variant.drawType,
+                                    variant.shaderFeatures,
+                                    m_contextOptions,
+                                    variant.shaderFeatures == fullyFeaturedPipelineFeatures ||
+                                        m_contextOptions.synchronousPipelineCreation);
+    }
+}
+
+wgpu::RenderPipeline PLSRenderContextWebGPUImpl::findCompatibleDrawPipeline(
+    DrawType drawType,
+    pls::ShaderFeatures shaderFeatures,
+    wgpu::TextureFormat framebufferFormat)
+{
+    // Only create fully-featured pipelines synchronously. Everything else can fall back on the
+    // fully-featured pipeline while CreateRenderPipelineAsync() finishes.
+    ShaderFeatures fullyFeaturedPipelineFeatures =
+        pls::ShaderFeaturesMaskFor(drawType, pls::InterlockMode::rasterOrdering) | shaderFeatures;
+    bool synchronous = shaderFeatures == fullyFeaturedPipelineFeatures ||
+                       m_contextOptions.synchronousPipelineCreation;
+    const DrawPipeline& drawPipeline =
+        m_drawPipelines
+            .try_emplace(pls::ShaderUniqueKey(drawType,
+                                              shaderFeatures,
+                                              pls::InterlockMode::rasterOrdering,
+                                              pls::ShaderMiscFlags::none),
+                         this,
+                         drawType,
+                         shaderFeatures,
+                         m_contextOptions,
+                         synchronous)
+            .first->second;
+    if (const wgpu::RenderPipeline& pipeline = drawPipeline.renderPipeline(framebufferFormat))
+    {
+        return pipeline;
+    }
+    if (shaderFeatures == fullyFeaturedPipelineFeatures)
+    {
+        // Fully-featured pipelines are always created synchronously, so this only happens if the
+        // creation failed (and the error has already been reported to the device). There is
+        // nothing left to fall back on.
+        return nullptr;
+    }
+    // Draw with the fully-featured pipeline while the specialized one is still being created
+    // asynchronously, or if its creation failed.
+    return findCompatibleDrawPipeline(drawType, fullyFeaturedPipelineFeatures, framebufferFormat);
+}
+
 void PLSRenderContextWebGPUImpl::flush(const FlushDescriptor& desc)
 {
     auto* renderTarget = static_cast<const PLSRenderTargetWebGPU*>(desc.renderTarget);
@@ -1655,11 +1857,11 @@ void PLSRenderContextWebGPUImpl::flush(const FlushDescriptor& desc)
                                                          desc.firstPath,
                                                          encoder);
             update_webgpu_storage_texture<pls::PaintData>(paintBufferRing(),
-                                                          desc.pathCount,
+                                                          desc.paintCount,
                                                           desc.firstPaint,
                                                           encoder);
             update_webgpu_storage_texture<pls::PaintAuxData>(paintAuxBufferRing(),
-                                                             desc.pathCount,
+                                                             desc.paintCount,
                                                              desc.firstPaintAux,
                                                              encoder);
         }
@@ -2006,18 +2208,13 @@ void PLSRenderContextWebGPUImpl::flush(const FlushDescriptor& desc)
         }
 
         // Setup the pipeline for this specific drawType and shaderFeatures.
-        const DrawPipeline& drawPipeline =
-            m_drawPipelines
-                .try_emplace(pls::ShaderUniqueKey(drawType,
-                                                  batch.shaderFeatures,
-                                                  pls::InterlockMode::rasterOrdering,
-                                                  pls::ShaderMiscFlags::none),
-                             this,
-                             drawType,
-                             batch.shaderFeatures,
-                             m_contextOptions)
-                .first->second;
-        drawPass.SetPipeline(drawPipeline.renderPipeline(renderTarget->framebufferFormat()));
+        wgpu::RenderPipeline drawPipeline =
+            findCompatibleDrawPipeline(drawType,
+                                       batch.shaderFeatures,
+                                       renderTarget->framebufferFormat());
+        // The fully-featured fallback is created synchronously, so every batch has a pipeline.
+        assert(drawPipeline);
+        drawPass.SetPipeline(drawPipeline);
 
         switch (drawType)
         {
@@ -2056,6 +2253,7 @@ void PLSRenderContextWebGPUImpl::flush(const FlushDescriptor& desc)
             case DrawType::plsAtomicInitialize:
             case DrawType::plsAtomicResolve:
             case DrawType::stencilClipReset:
+            case DrawType::analyticShapes:
                 RIVE_UNREACHABLE();
         }
     }
@@ -215,8 +215,10 @@ wgpu::RenderPipeline PLSRenderContextWebGPUVulkan::makePLSDrawPipeline(
     wgpu::TextureFormat framebufferFormat,
     wgpu::ShaderModule vertexShader,
     wgpu::ShaderModule fragmentShader,
-    EmJsHandle* pipelineJSHandleIfNeeded)
+    EmJsHandle* pipelineJSHandleIfNeeded,
+    AsyncRenderPipeline*)
 {
+    // The nonstandard "inputAttachments" pipeline has to be created synchronously from JS.
     *pipelineJSHandleIfNeeded = EmJsHandle(
         make_pls_draw_pipeline(emscripten_webgpu_export_device(device().Get()),
                                drawType,
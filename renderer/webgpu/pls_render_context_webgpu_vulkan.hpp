@@ -27,7 +27,8 @@ protected:
                                              wgpu::TextureFormat framebufferFormat,
                                              wgpu::ShaderModule vertexShader,
                                              wgpu::ShaderModule fragmentShader,
-                                             EmJsHandle* pipelineJSHandleIfNeeded) override;
+                                             EmJsHandle* pipelineJSHandleIfNeeded,
+                                             AsyncRenderPipeline*) override;
 
     wgpu::RenderPassEncoder makePLSRenderPass(wgpu::CommandEncoder,
                                               const PLSRenderTargetWebGPU*,
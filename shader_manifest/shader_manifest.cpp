@@ -0,0 +1,292 @@
+/*
+ * Copyright 2024 Rive
+ */
+
+// Generates a shader manifest for a set of .riv files.
+//
+// Every animation and state machine in each file is rendered through a recording
+// PLSRenderContextImpl, once for each interlock mode, and the unique draw shader variants they
+// require are written out in the format understood by pls::ParseShaderManifest(). Apps can ship the
+// manifest and pass its contents to PLSRenderContext::precompileShaders() during startup.
+
+#include "rive/artboard.hpp"
+#include "rive/file.hpp"
+#include "rive/layout.hpp"
+#include "rive/animation/state_machine_instance.hpp"
+#include "rive/static_scene.hpp"
+#include "rive/pls/pls_image.hpp"
+#include "rive/pls/pls_render_context_helper_impl.hpp"
+#include "rive/pls/pls_renderer.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <stdlib.h>
+#include <string.h>
+#include <unordered_set>
+#include <vector>
+
+using namespace rive;
+using namespace rive::pls;
+
+constexpr static uint32_t kRenderTargetWidth = 1024;
+constexpr static uint32_t kRenderTargetHeight = 1024;
+
+class NullTexture : public PLSTexture
+{
+public:
+    NullTexture(uint32_t width, uint32_t height) : PLSTexture(width, height) {}
+};
+
+class NullRenderTarget : public PLSRenderTarget
+{
+public:
+    NullRenderTarget(uint32_t width, uint32_t height) : PLSRenderTarget(width, height) {}
+};
+
+// RenderBuffer whose contents only live in CPU memory, since nothing ever draws from it.
+class HeapRenderBuffer : public RenderBuffer
+{
+public:
+    HeapRenderBuffer(RenderBufferType renderBufferType,
+                     RenderBufferFlags renderBufferFlags,
+                     size_t sizeInBytes) :
+        RenderBuffer(renderBufferType, renderBufferFlags, sizeInBytes),
+        m_data(new uint8_t[sizeInBytes])
+    {}
+
+protected:
+    void* onMap() override { return m_data.get(); }
+    void onUnmap() override {}
+
+private:
+    std::unique_ptr<uint8_t[]> m_data;
+};
+
+// PLSRenderContextImpl that doesn't render anything, but records the shader variant each DrawBatch
+// would use on a GPU backend.
+class PLSRenderContextRecordingImpl : public PLSRenderContextHelperImpl
+{
+public:
+    PLSRenderContextRecordingImpl()
+    {
+        // Claim support for everything, so we can render in every interlock mode.
+        m_platformFeatures.supportsPixelLocalStorage = true;
+        m_platformFeatures.supportsRasterOrdering = true;
+        m_platformFeatures.supportsClipPlanes = true;
+    }
+
+    const std::vector<ShaderVariant>& variants() const { return m_variants; }
+
+private:
+    rcp<RenderBuffer> makeRenderBuffer(RenderBufferType type,
+                                       RenderBufferFlags flags,
+                                       size_t sizeInBytes) override
+    {
+        return make_rcp<HeapRenderBuffer>(type, flags, sizeInBytes);
+    }
+
+    rcp<PLSTexture> makeImageTexture(uint32_t width,
+                                     uint32_t height,
+                                     uint32_t mipLevelCount,
+                                     const uint8_t imageDataRGBA[]) override
+    {
+        return make_rcp<NullTexture>(width, height);
+    }
+
+    std::unique_ptr<BufferRing> makeUniformBufferRing(size_t capacityInBytes) override
+    {
+        return std::make_unique<HeapBufferRing>(capacityInBytes);
+    }
+
+    std::unique_ptr<BufferRing> makeStorageBufferRing(size_t capacityInBytes,
+                                                      StorageBufferStructure) override
+    {
+        return std::make_unique<HeapBufferRing>(capacityInBytes);
+    }
+
+    std::unique_ptr<BufferRing> makeVertexBufferRing(size_t capacityInBytes) override
+    {
+        return std::make_unique<HeapBufferRing>(capacityInBytes);
+    }
+
+    std::unique_ptr<BufferRing> makeTextureTransferBufferRing(size_t capacityInBytes) override
+    {
+        return std::make_unique<HeapBufferRing>(capacityInBytes);
+    }
+
+    void resizeGradientTexture(uint32_t width, uint32_t height) override {}
+    void resizeTessellationTexture(uint32_t width, uint32_t height) override {}
+
+    void flush(const FlushDescriptor& desc) override
+    {
+        for (const DrawBatch& batch : *desc.drawList)
+        {
+            // Atomic mode uses the same feature set for every draw in the flush. (This matches the
+            // GPU backends.)
+            ShaderFeatures shaderFeatures = desc.interlockMode == InterlockMode::atomics
+                                                ? desc.combinedShaderFeatures
+                                                : batch.shaderFeatures;
+            record({batch.drawType, shaderFeatures, desc.interlockMode, ShaderMiscFlags::none});
+            if (batch.drawType == DrawType::plsAtomicResolve &&
+                (shaderFeatures & ShaderFeatures::ENABLE_ADVANCED_BLEND))
+            {
+                // Whether the resolve gets coalesced depends on the backend's render target, so
+                // include both versions.
+                record({batch.drawType,
+                        shaderFeatures,
+                        desc.interlockMode,
+                        ShaderMiscFlags::coalescedResolveAndTransfer});
+            }
+        }
+    }
+
+    void record(const ShaderVariant& variant)
+    {
+        if (m_uniqueKeys.insert(variant.uniqueKey()).second)
+        {
+            m_variants.push_back(variant);
+        }
+    }
+
+    std::unordered_set<uint32_t> m_uniqueKeys;
+    std::vector<ShaderVariant> m_variants;
+};
+
+static void render_scene_in_all_modes(PLSRenderContext* plsContext,
+                                      PLSRenderTarget* renderTarget,
+                                      Scene* scene,
+                                      const AABB& artboardBounds)
+{
+    struct
+    {
+        int msaaSampleCount;
+        bool disableRasterOrdering;
+    } modes[] = {
+        {0, false}, // rasterOrdering
+        {0, true},  // atomics
+        {4, false}, // depthStencil
+    };
+    for (auto mode : modes)
+    {
+        plsContext->beginFrame({
+            .renderTargetWidth = renderTarget->width(),
+            .renderTargetHeight = renderTarget->height(),
+            .msaaSampleCount = mode.msaaSampleCount,
+            .disableRasterOrdering = mode.disableRasterOrdering,
+        });
+        PLSRenderer renderer(plsContext);
+        renderer.save();
+        AABB viewport(0, 0, renderTarget->width(), renderTarget->height());
+        renderer.transform(
+            computeAlignment(Fit::contain, Alignment::center, viewport, artboardBounds));
+        scene->draw(&renderer);
+        renderer.restore();
+        plsContext->flush({.renderTarget = renderTarget});
+    }
+}
+
+static size_t scene_count(const ArtboardInstance* artboard)
+{
+    return std::max<size_t>(artboard->stateMachineCount() + artboard->animationCount(), 1);
+}
+
+static std::unique_ptr<Scene> make_scene(ArtboardInstance* artboard, size_t sceneIdx)
+{
+    if (sceneIdx < artboard->stateMachineCount())
+    {
+        return artboard->stateMachineAt(sceneIdx);
+    }
+    sceneIdx -= artboard->stateMachineCount();
+    if (sceneIdx < artboard->animationCount())
+    {
+        return artboard->animationAt(sceneIdx);
+    }
+    // This is a riv without any animations or state machines. Just draw the artboard.
+    return std::make_unique<StaticScene>(artboard);
+}
+
+int main(int argc, const char** argv)
+{
+    const char* outputPath = nullptr;
+    int framesPerScene = 30;
+    std::vector<const char*> rivPaths;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!strcmp(argv[i], "-o") && i + 1 < argc)
+        {
+            outputPath = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--frames") && i + 1 < argc)
+        {
+            framesPerScene = std::max(atoi(argv[++i]), 1);
+        }
+        else
+        {
+            rivPaths.push_back(argv[i]);
+        }
+    }
+    if (rivPaths.empty())
+    {
+        fprintf(stderr,
+                "usage: shader_manifest [-o manifest.txt] [--frames N] file.riv [file.riv ...]\n");
+        return -1;
+    }
+
+    auto plsContext =
+        std::make_unique<PLSRenderContext>(std::make_unique<PLSRenderContextRecordingImpl>());
+    auto renderTarget = make_rcp<NullRenderTarget>(kRenderTargetWidth, kRenderTargetHeight);
+
+    for (const char* rivPath : rivPaths)
+    {
+        std::ifstream rivStream(rivPath, std::ios::binary);
+        std::vector<uint8_t> rivBytes(std::istreambuf_iterator<char>(rivStream), {});
+        std::unique_ptr<File> rivFile = File::import(rivBytes, plsContext.get());
+        if (rivFile == nullptr)
+        {
+            fprintf(stderr, "Failed to import %s\n", rivPath);
+            return -1;
+        }
+        for (size_t i = 0; i < rivFile->artboardCount(); ++i)
+        {
+            size_t sceneCount = scene_count(rivFile->artboardAt(i).get());
+            for (size_t j = 0; j < sceneCount; ++j)
+            {
+                // Each scene gets its own artboard instance, since scenes mutate it.
+                std::unique_ptr<ArtboardInstance> artboard = rivFile->artboardAt(i);
+                std::unique_ptr<Scene> scene = make_scene(artboard.get(), j);
+                float frameDuration =
+                    std::max(scene->durationSeconds(), 1.f) / static_cast<float>(framesPerScene);
+                for (int frame = 0; frame < framesPerScene; ++frame)
+                {
+                    scene->advanceAndApply(frame == 0 ? 0 : frameDuration);
+                    render_scene_in_all_modes(plsContext.get(),
+                                              renderTarget.get(),
+                                              scene.get(),
+                                              artboard->bounds());
+                }
+            }
+        }
+    }
+
+    const std::vector<ShaderVariant>& variants =
+        plsContext->static_impl_cast<PLSRenderContextRecordingImpl>()->variants();
+    std::string manifest = WriteShaderManifest(variants);
+    if (outputPath != nullptr)
+    {
+        std::ofstream outputStream(outputPath, std::ios::binary);
+        outputStream << manifest;
+        if (!outputStream)
+        {
+            fprintf(stderr, "Failed to write %s\n", outputPath);
+            return -1;
+        }
+    }
+    else
+    {
+        fputs(manifest.c_str(), stdout);
+    }
+    fprintf(stderr, "Recorded %zu shader variants.\n", variants.size());
+    return 0;
+}